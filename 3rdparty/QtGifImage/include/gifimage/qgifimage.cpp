@@ -287,7 +287,7 @@ bool QGifImagePrivate::save(QIODevice *device) const {
 	auto data = (GifByteType *)malloc(image.width() * image.height() *
 		sizeof(GifByteType));
 	for (int row = 0; row < image.height(); ++row) {
-	  memcpy(data + row * image.width(), image.scanLine(row), image.width());
+	  memcpy(data + row * image.width(), image.constScanLine(row), image.width());
 	}
 	gifImage->RasterBits = data;
 
@@ -24,6 +24,8 @@
 #include <QList>
 #include <QMultiMap>
 
+#include <algorithm>
+
 #include "drcspage.h"
 #include "levelonepage.h"
 #include "pagebase.h"
@@ -166,7 +168,7 @@ void TeletextPageDecode::Invocation::buildMap(int level)
 }
 
 
-int TeletextPageDecode::s_instances = 0;
+std::atomic<int> TeletextPageDecode::s_instances = 0;
 
 TeletextPageDecode::textPainter TeletextPageDecode::s_blankPainter;
 
@@ -196,9 +198,10 @@ TeletextPageDecode::TeletextPageDecode()
 				m_cellLevel1MosaicChar[r][c] = false;
 				m_cellLevel1CharSet[r][c] = 0;
 			}
-			m_refresh[r][c] = true;
+			m_cellCLUTs[r][c] = 0;
 		}
 	}
+	m_refresh.set();
 
 	m_finalFullScreenColour = 0;
 	m_finalFullScreenQColor.setRgb(0, 0, 0);
@@ -219,7 +222,12 @@ TeletextPageDecode::~TeletextPageDecode()
 
 void TeletextPageDecode::setRefresh(int r, int c, bool refresh)
 {
-	m_refresh[r][c] = refresh;
+	m_refresh.set(r*72+c, refresh);
+}
+
+void TeletextPageDecode::setCLUTRefresh(int index)
+{
+	m_refresh |= m_clutCells[index];
 }
 
 void TeletextPageDecode::setTeletextPage(LevelOnePage *newCurrentPage)
@@ -229,21 +237,32 @@ void TeletextPageDecode::setTeletextPage(LevelOnePage *newCurrentPage)
 	updateSidePanels();
 }
 
-void TeletextPageDecode::setDRCSPage(DRCSPageType pageType, QList<DRCSPage> *pages)
+void TeletextPageDecode::setDRCSPage(DRCSPageType pageType, const DRCSPageSet *pages)
 {
+	if (pages == m_drcsPage[pageType])
+		return;
+
+	// Only the cells showing characters that now look different need rendering again
+	const QList<quint64> changedCharacters = DRCSPageSet::changedCharacters(m_drcsPage[pageType], pages);
+	const DRCSSource drcsSource = pageType == NormalDRCSPage ? NormalDRCS : GlobalDRCS;
+
 	m_drcsPage[pageType] = pages;
 
-	bool refreshRequired = false;
+	if (std::all_of(changedCharacters.cbegin(), changedCharacters.cend(), [](quint64 changed) { return changed == 0; }))
+		return;
 
 	for (int r=0; r<25; r++)
 		for (int c=0; c<72; c++)
-			if (m_cell[r][c].character.drcsSource != NoDRCS) {
-				m_refresh[r][c] = true;
-				refreshRequired = true;
+			if (m_cell[r][c].character.drcsSource == drcsSource) {
+				const int subTable = m_cell[r][c].character.drcsSubTable;
+
+				if (subTable < changedCharacters.size() && (changedCharacters.at(subTable) >> m_cell[r][c].character.drcsChar & 1))
+					m_refresh.set(r*72+c);
 			}
 
-	if (refreshRequired)
-		decodePage();
+	// Characters that have been downloaded or taken away show or disappear when decoding,
+	// which also marks those cells for rendering
+	decodePage();
 }
 
 void TeletextPageDecode::clearDRCSPage(DRCSPageType pageType)
@@ -258,9 +277,7 @@ void TeletextPageDecode::setLevel(int level)
 
 	m_level = level;
 
-	for (int r=0; r<25; r++)
-		for (int c=0; c<72; c++)
-			m_refresh[r][c] = true;
+	m_refresh.set();
 
 	updateSidePanels();
 	decodePage();
@@ -272,96 +289,23 @@ QImage TeletextPageDecode::drcsImage(DRCSSource pageType, int subTable, int chr,
 		return QImage();
 
 	// Check if page is loaded and if the subpage exists
-	const QList<DRCSPage>* drcsPage = m_drcsPage[pageType-1];
+	const DRCSPageSet *drcsPage = m_drcsPage[pageType-1];
 	if (drcsPage == nullptr || subTable >= drcsPage->size())
 		return QImage();
 
 	// Level 2.5: only and always mode 0 (12x10x1) and doesn't use X/28/3
 	// Level 3.5: if X/28/3 is absent, drcsMode below returns mode 0
-	if (m_level == 2 || drcsPage->at(subTable).drcsMode(chr) == 0) {
-		uchar rawData[20];
-
-		if (!drcsPage->at(subTable).ptu(chr, rawData))
-			return QImage();
-
-		QImage result = QImage(rawData, 12, 10, 2, QImage::Format_Mono);
-		return result.copy();
-	}
-
-	// Level 3.5: obey X/28/3 "subsequent PTU" and "no data" values, ignore reserved values
-	const int drcsMode = drcsPage->at(subTable).drcsMode(chr);
-	if (drcsMode > 3)
-		return QImage();
-
-	uchar rawData[120];
-
-	if (drcsMode != 3) {
-		// mode 1 (12x10x2) or mode 2 (12x10x4)
-		// Each complete bitplane stored sequentially across multiple PTUs
-
-		uchar bitplaneArr[4][20] = { };
-
-		// Get the PTUs for each bitplane
-		drcsPage->at(subTable).ptu(chr, bitplaneArr[0]);
-		if (chr < 47)
-			drcsPage->at(subTable).ptu(chr+1, bitplaneArr[1]);
-		if (drcsMode == 2) {
-			if (chr < 46)
-				drcsPage->at(subTable).ptu(chr+2, bitplaneArr[2]);
-			if (chr < 45)
-				drcsPage->at(subTable).ptu(chr+3, bitplaneArr[3]);
-		}
-
-		// Now assemble the bitplanes into byte-per-pixel data
-		for (int x=0; x<12; x++)
-			for (int y=0; y<10; y++) {
-				const int scanByte = y*2 + (x > 7);
-				const int scanBit = 7 - x%8;
-
-				rawData[x + y*12] = bitplaneArr[0][scanByte] >> scanBit & 1;
-				rawData[x + y*12] |= (bitplaneArr[1][scanByte] >> scanBit & 1) << 1;
-				if (drcsMode == 2) {
-					rawData[x + y*12] |= (bitplaneArr[2][scanByte] >> scanBit & 1) << 2;
-					rawData[x + y*12] |= (bitplaneArr[3][scanByte] >> scanBit & 1) << 3;
-				}
-			}
-	} else {
-		// mode 3 (6x5x4)
-		// Interleaved: First row of six pixels is stored four times sequentially, one for
-		// each bitplane, then second row of pixels four times, and so on
-		const int pktNo = (chr+2)/2;
+	const int drcsMode = drcsPage->drcsMode(subTable, chr);
 
-		if (!drcsPage->at(subTable).packetExists(pktNo))
-			return QImage();
+	if (m_level == 2 || drcsMode == 0)
+		return drcsPage->monoGlyph(subTable, chr);
 
-		QByteArray pkt;
+	// The pixels are decoded once by the page set, only the colours come from this page
+	QImage result = drcsPage->modeGlyph(subTable, chr);
+	if (result.isNull())
+		return result;
 
-		if (chr % 2 == 0)
-			pkt = drcsPage->at(subTable).packet(pktNo).first(20);
-		else
-			pkt = drcsPage->at(subTable).packet(pktNo).last(20);
-
-		for (int x=0; x<6; x++)
-			for (int y=0; y<5; y++) {
-				const int scanByte = y * 4;
-				const int scanBit = 5 - x;
-				uchar pixel;
-
-				pixel = pkt.at(scanByte) >> scanBit & 1;
-				pixel |= (pkt.at(scanByte+1) >> scanBit & 1) << 1;
-				pixel |= (pkt.at(scanByte+2) >> scanBit & 1) << 2;
-				pixel |= (pkt.at(scanByte+3) >> scanBit & 1) << 3;
-
-				rawData[x*2   + y*24   ] = pixel;
-				rawData[x*2+1 + y*24   ] = pixel;
-				rawData[x*2   + y*24+12] = pixel;
-				rawData[x*2+1 + y*24+12] = pixel;
-			}
-	}
-
-	QImage result = QImage(rawData, 12, 10, 12, QImage::Format_Indexed8);
-
-	// Now put in the colours
+	// Now put in the colours, which detaches the result from the shared glyph
 	for (int i=0; i<16; i++) {
 		const int clr = m_levelOnePage->dCLUT(pageType-1, drcsMode, i);
 
@@ -374,7 +318,7 @@ QImage TeletextPageDecode::drcsImage(DRCSSource pageType, int subTable, int chr,
 			break;
 	}
 
-	return result.copy();
+	return result;
 }
 
 void TeletextPageDecode::updateSidePanels()
@@ -972,8 +916,8 @@ void TeletextPageDecode::decodeRow(int r)
 					// appear when the DRCS characters are not (yet) downloaded are too complex to
 					// figure out with this too complex decoder.
 					if (result.drcsSource) {
-						const QList<DRCSPage>* drcsPage = m_drcsPage[result.drcsSource-1];
-						if (drcsPage == nullptr || result.drcsSubTable >= drcsPage->size() || !drcsPage->at(result.drcsSubTable).ptu(result.drcsChar, nullptr)) {
+						const DRCSPageSet *drcsPage = m_drcsPage[result.drcsSource-1];
+						if (drcsPage == nullptr || result.drcsSubTable >= drcsPage->size() || drcsPage->monoGlyph(result.drcsSubTable, result.drcsChar).isNull()) {
 							result.drcsSource = NoDRCS;
 							result.code = 0x00;
 						}
@@ -1238,9 +1182,57 @@ void TeletextPageDecode::decodeRow(int r)
 
 		if (m_cell[r][c] != previousCellContents)
 			setRefresh(r, c, true);
+
+		// Keep the CLUT to cell reverse index in step, only touching entries that changed
+		if (const quint32 cellCLUTs = cellCLUTMask(r, c); cellCLUTs != m_cellCLUTs[r][c]) {
+			const quint32 changedCLUTs = cellCLUTs ^ m_cellCLUTs[r][c];
+
+			for (int i=0; i<32; i++)
+				if (changedCLUTs & (1u << i))
+					m_clutCells[i].flip(r*72+c);
+
+			m_cellCLUTs[r][c] = cellCLUTs;
+		}
 	}
 }
 
+quint32 TeletextPageDecode::cellCLUTMask(int r, int c) const
+{
+	const textAttributes &attribute = m_cell[r][c].attribute;
+	quint32 result = (1u << attribute.foregroundCLUT) | (1u << attribute.backgroundCLUT);
+
+	if (attribute.flash.mode == 3)
+		result |= (1u << (attribute.foregroundCLUT ^ 8)) | (1u << (attribute.backgroundCLUT ^ 8));
+
+	// Transparent CLUT may show the Full Row Colour instead
+	if (result & (1u << 8)) {
+		const bool bottomHalf = r > 0 && (m_cell[r][c].fragment == DoubleHeightBottomHalf || m_cell[r][c].fragment == DoubleSizeBottomLeftQuarter || m_cell[r][c].fragment == DoubleSizeBottomRightQuarter);
+
+		result |= 1u << m_fullRowColour[bottomHalf ? r-1 : r];
+	}
+
+	// Level 3.5 DRCS in modes 1 to 3 take their colours from the DCLUT
+	const DRCSSource drcsSource = m_cell[r][c].character.drcsSource;
+
+	if (m_level == 3 && drcsSource != NoDRCS) {
+		const DRCSPageSet *drcsPage = m_drcsPage[drcsSource-1];
+		const int subTable = m_cell[r][c].character.drcsSubTable;
+
+		if (drcsPage != nullptr && subTable < drcsPage->size()) {
+			const int drcsMode = drcsPage->drcsMode(subTable, m_cell[r][c].character.drcsChar);
+
+			if (drcsMode >= 1 && drcsMode <= 3)
+				for (int i=0; i<(drcsMode == 1 ? 4 : 16); i++) {
+					const int clr = m_levelOnePage->dCLUT(drcsSource-1, drcsMode, i);
+
+					result |= (1u << clr) | (1u << (clr ^ 8));
+				}
+		}
+	}
+
+	return result;
+}
+
 inline void TeletextPageDecode::rotateFlashMovement(flashFunctions &flash)
 {
 	if (flash.ratePhase == 4) {
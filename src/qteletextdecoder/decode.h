@@ -25,6 +25,9 @@
 #include <QMap>
 #include <QMultiMap>
 
+#include <atomic>
+#include <bitset>
+
 #include "drcspage.h"
 #include "levelonepage.h"
 #include "pagebase.h"
@@ -42,14 +45,15 @@ public:
 
 	TeletextPageDecode();
 	~TeletextPageDecode();
-	bool refresh(int r, int c) const { return m_refresh[r][c]; }
+	bool refresh(int r, int c) const { return m_refresh.test(r*72+c); }
 	void setRefresh(int r, int c, bool refresh);
+	void setCLUTRefresh(int index);
 	int level() const { return m_level; }
 	void decodePage();
 	LevelOnePage *teletextPage() const { return m_levelOnePage; };
 	void setTeletextPage(LevelOnePage *newCurrentPage);
-	QList<DRCSPage> *drcsPage(DRCSPageType pageType) const { return m_drcsPage[pageType]; };
-	void setDRCSPage(DRCSPageType pageType, QList<DRCSPage> *pages);
+	const DRCSPageSet *drcsPage(DRCSPageType pageType) const { return m_drcsPage[pageType]; };
+	void setDRCSPage(DRCSPageType pageType, const DRCSPageSet *pages);
 	void clearDRCSPage(DRCSPageType pageType);
 	void updateSidePanels();
 
@@ -282,23 +286,27 @@ private:
 		QMultiMap<int, X26Triplet> m_fullRowCLUTMap;
 	};
 
-	static int s_instances;
+	static std::atomic<int> s_instances;
 	static textPainter s_blankPainter;
 
 	void decodeRow(int r);
+	quint32 cellCLUTMask(int r, int c) const;
 	QColor cellQColor(int r, int c, ColourPart colourPart);
 	textCell& cellAtCharacterOrigin(int r, int c);
 	void buildInvocationList(Invocation &invocation, int objectType);
 	textCharacter characterFromTriplets(const QList<X26Triplet> triplets);
 	inline void rotateFlashMovement(flashFunctions &flash);
 
-	bool m_refresh[25][72];
+	std::bitset<25*72> m_refresh;
 	textCell m_cell[25][72];
+	// Reverse index of which cells use each CLUT entry, kept up to date as rows are decoded
+	quint32 m_cellCLUTs[25][72];
+	std::bitset<25*72> m_clutCells[32];
 	bool m_cellLevel1MosaicAttr[25][40];
 	bool m_cellLevel1MosaicChar[25][40];
 	int m_cellLevel1CharSet[25][40];
 	LevelOnePage* m_levelOnePage;
-	QList<DRCSPage>* m_drcsPage[2];
+	const DRCSPageSet *m_drcsPage[2];
 	int m_fullRowColour[25];
 	QColor m_fullRowQColor[25];
 	QList<Invocation> m_invocations[3];
@@ -18,6 +18,8 @@
  */
 
 #include <QByteArray>
+#include <QImage>
+#include <QList>
 
 #include "drcspage.h"
 
@@ -85,3 +87,116 @@ bool DRCSPage::ptu(int c, uchar *data) const
 
 	return true;
 }
+
+DRCSPageSet::DRCSPageSet(const QList<PageBase> &pages)
+{
+	m_pages.reserve(pages.size());
+	for (int i=0; i<pages.size(); i++)
+		m_pages.append(pages.at(i));
+
+	m_glyphs.resize(m_pages.size() * 48);
+	for (int s=0; s<m_pages.size(); s++)
+		for (int c=0; c<48; c++)
+			decodeGlyph(s, c);
+}
+
+QList<quint64> DRCSPageSet::changedCharacters(const DRCSPageSet *before, const DRCSPageSet *after)
+{
+	const int beforeSize = before == nullptr ? 0 : before->size();
+	const int afterSize = after == nullptr ? 0 : after->size();
+	QList<quint64> result(qMax(beforeSize, afterSize), 0);
+
+	for (int s=0; s<result.size(); s++)
+		if (s >= beforeSize || s >= afterSize)
+			result[s] = (Q_UINT64_C(1) << 48) - 1;
+		else
+			for (int c=0; c<48; c++)
+				if (!(before->m_glyphs.at(s*48 + c) == after->m_glyphs.at(s*48 + c)))
+					result[s] |= Q_UINT64_C(1) << c;
+
+	return result;
+}
+
+void DRCSPageSet::decodeGlyph(int subTable, int c)
+{
+	const DRCSPage &drcsPage = m_pages.at(subTable);
+	drcsGlyph &glyph = m_glyphs[subTable*48 + c];
+
+	uchar monoData[20];
+
+	if (drcsPage.ptu(c, monoData))
+		glyph.mono = QImage(monoData, 12, 10, 2, QImage::Format_Mono).copy();
+
+	// Level 3.5: obey X/28/3 "subsequent PTU" and "no data" values, ignore reserved values
+	glyph.mode = drcsPage.drcsMode(c);
+	if (glyph.mode == 0 || glyph.mode > 3)
+		return;
+
+	uchar rawData[120];
+
+	if (glyph.mode != 3) {
+		// mode 1 (12x10x2) or mode 2 (12x10x4)
+		// Each complete bitplane stored sequentially across multiple PTUs
+
+		uchar bitplaneArr[4][20] = { };
+
+		// Get the PTUs for each bitplane
+		drcsPage.ptu(c, bitplaneArr[0]);
+		if (c < 47)
+			drcsPage.ptu(c+1, bitplaneArr[1]);
+		if (glyph.mode == 2) {
+			if (c < 46)
+				drcsPage.ptu(c+2, bitplaneArr[2]);
+			if (c < 45)
+				drcsPage.ptu(c+3, bitplaneArr[3]);
+		}
+
+		// Now assemble the bitplanes into byte-per-pixel data
+		for (int x=0; x<12; x++)
+			for (int y=0; y<10; y++) {
+				const int scanByte = y*2 + (x > 7);
+				const int scanBit = 7 - x%8;
+
+				rawData[x + y*12] = bitplaneArr[0][scanByte] >> scanBit & 1;
+				rawData[x + y*12] |= (bitplaneArr[1][scanByte] >> scanBit & 1) << 1;
+				if (glyph.mode == 2) {
+					rawData[x + y*12] |= (bitplaneArr[2][scanByte] >> scanBit & 1) << 2;
+					rawData[x + y*12] |= (bitplaneArr[3][scanByte] >> scanBit & 1) << 3;
+				}
+			}
+	} else {
+		// mode 3 (6x5x4)
+		// Interleaved: First row of six pixels is stored four times sequentially, one for
+		// each bitplane, then second row of pixels four times, and so on
+		const int pktNo = (c+2)/2;
+
+		if (!drcsPage.packetExists(pktNo))
+			return;
+
+		QByteArray pkt;
+
+		if (c % 2 == 0)
+			pkt = drcsPage.packet(pktNo).first(20);
+		else
+			pkt = drcsPage.packet(pktNo).last(20);
+
+		for (int x=0; x<6; x++)
+			for (int y=0; y<5; y++) {
+				const int scanByte = y * 4;
+				const int scanBit = 5 - x;
+				uchar pixel;
+
+				pixel = pkt.at(scanByte) >> scanBit & 1;
+				pixel |= (pkt.at(scanByte+1) >> scanBit & 1) << 1;
+				pixel |= (pkt.at(scanByte+2) >> scanBit & 1) << 2;
+				pixel |= (pkt.at(scanByte+3) >> scanBit & 1) << 3;
+
+				rawData[x*2   + y*24   ] = pixel;
+				rawData[x*2+1 + y*24   ] = pixel;
+				rawData[x*2   + y*24+12] = pixel;
+				rawData[x*2+1 + y*24+12] = pixel;
+			}
+	}
+
+	glyph.indexed = QImage(rawData, 12, 10, 12, QImage::Format_Indexed8).copy();
+}
@@ -21,6 +21,8 @@
 #define DRCSPAGE_H
 
 #include <QByteArray>
+#include <QImage>
+#include <QList>
 
 #include "pagebase.h"
 
@@ -36,4 +38,43 @@ public:
 	bool ptu(int c, uchar *data) const;
 };
 
+// The DRCS pages loaded from one file, with the pixels of every character decoded once when made.
+// Nothing changes after that, so one set can be shared by many decoders and read by render threads.
+class DRCSPageSet
+{
+public:
+	explicit DRCSPageSet(const QList<PageBase> &pages);
+
+	int size() const { return m_pages.size(); }
+	bool isEmpty() const { return m_pages.isEmpty(); }
+	const DRCSPage &at(int subTable) const { return m_pages.at(subTable); }
+
+	// Mode of the character given by X/28/3, 0 if X/28/3 is absent
+	int drcsMode(int subTable, int c) const { return m_glyphs.at(subTable*48 + c).mode; }
+	// The character in mode 0 as Level 2.5 always shows it, null if its PTU isn't downloaded
+	QImage monoGlyph(int subTable, int c) const { return m_glyphs.at(subTable*48 + c).mono; }
+	// The character in its own mode 1 to 3 as colour indices without a colour table,
+	// null for mode 0, reserved modes and "no data"
+	QImage modeGlyph(int subTable, int c) const { return m_glyphs.at(subTable*48 + c).indexed; }
+
+	// For each subtable, a mask of the characters that look different or aren't there in one of the sets.
+	// Either set can be null for no pages.
+	static QList<quint64> changedCharacters(const DRCSPageSet *before, const DRCSPageSet *after);
+
+private:
+	struct drcsGlyph {
+		int mode=0;
+		QImage mono;
+		QImage indexed;
+
+		bool operator==(const drcsGlyph &other) const { return mode == other.mode && mono == other.mono && indexed == other.indexed; }
+	};
+
+	void decodeGlyph(int subTable, int c);
+
+	QList<DRCSPage> m_pages;
+	// 48 characters for each page
+	QList<drcsGlyph> m_glyphs;
+};
+
 #endif
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Build step that turns teletextfont.png into the initialiser of a table of glyph rows,
+// so the decoder doesn't need to decode the image or carry it as a resource.
+// Usage: fontatlasgen teletextfont.png teletextfontatlas.inc
+
+#include <QFile>
+#include <QImage>
+#include <QTextStream>
+
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+	if (argc != 3) {
+		std::cerr << "Usage: fontatlasgen <font image> <output file>" << std::endl;
+		return 1;
+	}
+
+	const QImage fontImage(QString::fromLocal8Bit(argv[1]));
+
+	// 27 sets of 96 characters, each character 12x10 pixels
+	if (fontImage.width() != 96*12 || fontImage.height() != 27*10) {
+		std::cerr << argv[1] << ": not a 1152x270 font image" << std::endl;
+		return 1;
+	}
+
+	QFile outputFile(QString::fromLocal8Bit(argv[2]));
+
+	if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		std::cerr << argv[2] << ": " << qPrintable(outputFile.errorString()) << std::endl;
+		return 1;
+	}
+
+	QTextStream output(&outputFile);
+
+	output << "// Generated by fontatlasgen from teletextfont.png, do not edit\n";
+	output << "// Each glyph row is a 12 bit mask, bit 0 being the leftmost pixel\n";
+
+	for (int s=0; s<27; s++) {
+		output << "{ // Set " << s << "\n";
+		for (int c=0; c<96; c++) {
+			output << "\t{";
+			for (int y=0; y<10; y++) {
+				unsigned int glyphRow = 0;
+
+				// Glyph pixels are opaque white, everything else is transparent
+				for (int x=0; x<12; x++) {
+					const QRgb pixel = fontImage.pixel(c*12+x, s*10+y);
+
+					if (qAlpha(pixel) > 127 && qGray(pixel) > 127)
+						glyphRow |= 1 << x;
+				}
+
+				output << " 0x" << QString::number(glyphRow, 16).rightJustified(3, '0') << (y < 9 ? "," : "");
+			}
+			output << " }" << (c < 95 ? "," : "") << "\n";
+		}
+		output << "}" << (s < 26 ? "," : "") << "\n";
+	}
+
+	output.flush();
+	if (output.status() != QTextStream::Ok || !outputFile.flush()) {
+		std::cerr << argv[2] << ": could not be written" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
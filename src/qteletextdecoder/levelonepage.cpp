@@ -22,6 +22,7 @@
 #include <QList>
 #include <QString>
 #include <algorithm>
+#include <cstring>
 
 #include "levelonepage.h"
 
@@ -390,6 +391,46 @@ void LevelOnePage::setCharacter(int r, int c, unsigned char newCharacter)
 	}
 }
 
+QByteArray LevelOnePage::row(int r) const
+{
+	return PageX26Base::packetExists(r) ? PageX26Base::packet(r) : QByteArray(40, 0x20);
+}
+
+void LevelOnePage::setRow(int r, const QByteArray &newRow)
+{
+	// A row of all spaces is the same as no row at all
+	for (int c=0; c<40; c++)
+		if (newRow.at(c) != 0x20) {
+			setPacket(r, newRow);
+			return;
+		}
+
+	clearPacket(r);
+}
+
+void LevelOnePage::setBlock(int r, int c, const QByteArrayList &block, bool skipFF)
+{
+	if (c >= 40)
+		return;
+
+	for (int i=0; i<block.size() && r+i < 25; i++) {
+		const QByteArray &blockRow = block.at(i);
+		const int width = qMin(static_cast<int>(blockRow.size()), 40 - c);
+		QByteArray newRow = row(r+i);
+		// Detaches the row once, rather than once for every character written
+		char *rowData = newRow.data();
+
+		if (skipFF) {
+			for (int j=0; j<width; j++)
+				if (blockRow.at(j) != -1)
+					rowData[c+j] = blockRow.at(j);
+		} else
+			std::memcpy(rowData + c, blockRow.constData(), width);
+
+		setRow(r+i, newRow);
+	}
+}
+
 int LevelOnePage::defaultScreenColour() const
 {
 	return m_defaultScreenColour;
@@ -21,6 +21,7 @@
 #define LEVELONEPAGE_H
 
 #include <QByteArray>
+#include <QByteArrayList>
 #include <QColor>
 #include <QObject>
 #include <QString>
@@ -69,6 +70,13 @@ public:
 	void setSecondNOS(int newSecondNOS);
 	unsigned char character(int r, int c) const;
 	void setCharacter(int r, int c, unsigned char newChar);
+	// Whole row of 40 characters, all spaces if the row doesn't exist
+	QByteArray row(int r) const;
+	// Replaces a whole row of 40 characters at once, sharing the data rather than copying it
+	void setRow(int r, const QByteArray &newRow);
+	// Writes a rectangle of characters with its top left corner at r, c, clipped to the page.
+	// Each row is written with one copy; with skipFF set, 0xff bytes leave the existing character.
+	void setBlock(int r, int c, const QByteArrayList &block, bool skipFF=false);
 	int defaultScreenColour() const;
 	void setDefaultScreenColour(int newDefaultScreenColour);
 	int defaultRowColour() const;
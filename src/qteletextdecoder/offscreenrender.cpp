@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QImage>
+#include <QList>
+#include <QSize>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "offscreenrender.h"
+
+#include "decode.h"
+#include "render.h"
+
+TeletextOffscreenRender::TeletextOffscreenRender()
+{
+	m_levelOnePage = nullptr;
+	m_renderAll = true;
+	m_pageRender.setDecoder(&m_pageDecode);
+}
+
+void TeletextOffscreenRender::setTeletextPage(LevelOnePage *page)
+{
+	m_levelOnePage = page;
+	m_pageDecode.setTeletextPage(page);
+	m_renderAll = true;
+}
+
+void TeletextOffscreenRender::setDRCSPage(TeletextPageDecode::DRCSPageType pageType, const DRCSPageSet *pages)
+{
+	m_pageDecode.setDRCSPage(pageType, pages);
+}
+
+bool TeletextOffscreenRender::prepare(const Options &options)
+{
+	if (m_levelOnePage == nullptr)
+		return false;
+
+	// These only cause a re-decode or re-render of the affected cells if the option actually changed
+	m_pageDecode.setLevel(options.level);
+	m_pageRender.setRenderMode(options.renderMode);
+	m_pageRender.setReveal(options.reveal);
+
+	m_pageDecode.decodePage();
+	m_pageRender.renderPage(m_renderAll);
+	m_renderAll = false;
+
+	return true;
+}
+
+// Same geometry as MainWindow::setSceneDimensions and LevelOneScene::setBorderDimensions
+QSize TeletextOffscreenRender::sceneSize(const Options &options) const
+{
+	const int topBottomBorders[3] = { 0, 10, 19 };
+	const int pillarBoxSizes[3] = { 672, 720, 854 };
+	const int leftRightBorders[3] = { 0, 24, 77 };
+	const int border = qBound(0, options.border, 2);
+	const int widgetWidth = 480 + (m_pageDecode.leftSidePanelColumns() + m_pageDecode.rightSidePanelColumns()) * 12;
+	int sceneWidth;
+
+	if (options.aspectRatio == 1)
+		sceneWidth = qMax(pillarBoxSizes[border], widgetWidth);
+	else if (border == 2)
+		sceneWidth = qMax(640, widgetWidth);
+	else
+		sceneWidth = widgetWidth + leftRightBorders[border]*2;
+
+	return QSize(sceneWidth, 250 + topBottomBorders[border]*2);
+}
+
+QSize TeletextOffscreenRender::outputSize(const Options &options, const QSize &scene) const
+{
+	if (options.scale <= 0)
+		return scene;
+
+	// Horizontal scaling of each aspect ratio with page pixel rows doubled, as a fraction
+	const int aspectNumerator[4] = { 6, 6, 8, 1 };
+	const int aspectDenominator[4] = { 5, 5, 5, 1 };
+	const int aspectRatio = qBound(0, options.aspectRatio, 3);
+	const int scale = qMin(options.scale, 8);
+
+	return QSize(scene.width() * aspectNumerator[aspectRatio] * scale / aspectDenominator[aspectRatio], scene.height() * 2 * scale);
+}
+
+QSize TeletextOffscreenRender::size(const Options &options)
+{
+	if (!prepare(options))
+		return QSize();
+
+	return outputSize(options, sceneSize(options));
+}
+
+int TeletextOffscreenRender::flashHz(const Options &options)
+{
+	if (!prepare(options))
+		return 0;
+
+	return m_pageRender.flashHz();
+}
+
+QList<QRgb> TeletextOffscreenRender::colourTable(const Options &options)
+{
+	if (options.renderMode >= TeletextPageRender::RenderWhiteOnBlack)
+		return QList<QRgb>{ qRgb(0, 0, 0), qRgb(255, 255, 255) };
+
+	QList<QRgb> result(TransparentIndex + 1);
+
+	for (int i=0; i<32; i++) {
+		const int colour12Bit = (m_levelOnePage != nullptr) ? m_levelOnePage->CLUT(i, options.level) : 0;
+
+		result[i] = qRgb(((colour12Bit & 0xf00) >> 8) * 17, ((colour12Bit & 0x0f0) >> 4) * 17, (colour12Bit & 0x00f) * 17);
+	}
+	result[TransparentIndex] = qRgba(0, 0, 0, 0);
+
+	return result;
+}
+
+void TeletextOffscreenRender::buildColourLookup(const Options &options)
+{
+	m_colourTable = colourTable(options);
+
+	std::memset(m_colourLookup, 0, sizeof(m_colourLookup));
+
+	// Go backwards so that the lowest CLUT index wins if several entries share a colour
+	// CLUT 8 is always rendered as transparent so never maps back to itself
+	for (int i=m_colourTable.size()-1; i>=0; i--)
+		if (i != 8 && i != TransparentIndex)
+			m_colourLookup[(qRed(m_colourTable.at(i)) / 17) << 8 | (qGreen(m_colourTable.at(i)) / 17) << 4 | qBlue(m_colourTable.at(i)) / 17] = i;
+}
+
+inline uchar TeletextOffscreenRender::colourIndex(QRgb colour) const
+{
+	if (qAlpha(colour) < 128)
+		return TransparentIndex;
+
+	colour = qUnpremultiply(colour);
+
+	return m_colourLookup[((qRed(colour)+8) / 17) << 8 | ((qGreen(colour)+8) / 17) << 4 | (qBlue(colour)+8) / 17];
+}
+
+void TeletextOffscreenRender::buildColumnMap(int sceneWidth, int outputWidth, bool smooth)
+{
+	// Integer scales are plain pixel replication so smoothing would only blur them
+	m_smoothColumns = smooth && outputWidth % sceneWidth != 0;
+
+	m_sourceColumn.resize(outputWidth);
+	m_sourceWeight.resize(outputWidth);
+
+	for (int x=0; x<outputWidth; x++)
+		if (m_smoothColumns) {
+			// Position of the centre of this output pixel in source pixels, in 1/256ths
+			const int position = qMax(0, int((2*x+1) * qint64(sceneWidth) * 128 / outputWidth) - 128);
+
+			m_sourceColumn[x] = qMin(position >> 8, sceneWidth-2);
+			m_sourceWeight[x] = (position >> 8 < sceneWidth-1) ? position & 0xff : 0xff;
+		} else {
+			m_sourceColumn[x] = (2*x+1) * qint64(sceneWidth) / (2*outputWidth);
+			m_sourceWeight[x] = 0;
+		}
+}
+
+// Blend two premultiplied pixels, weight is out of 256 towards the second pixel
+static inline QRgb interpolatePixel(QRgb first, QRgb second, uint weight)
+{
+	const uint inverseWeight = 256 - weight;
+	const uint redBlue = (((first & 0x00ff00ff) * inverseWeight + (second & 0x00ff00ff) * weight) >> 8) & 0x00ff00ff;
+	const uint alphaGreen = (((first >> 8) & 0x00ff00ff) * inverseWeight + ((second >> 8) & 0x00ff00ff) * weight) & 0xff00ff00;
+
+	return alphaGreen | redBlue;
+}
+
+void TeletextOffscreenRender::resampleLine(const QRgb *sceneLine, QRgb *outputLine, int outputWidth) const
+{
+	const int *sourceColumn = m_sourceColumn.data();
+	const uchar *sourceWeight = m_sourceWeight.data();
+
+	if (m_smoothColumns)
+		for (int x=0; x<outputWidth; x++)
+			outputLine[x] = interpolatePixel(sceneLine[sourceColumn[x]], sceneLine[sourceColumn[x]+1], sourceWeight[x]);
+	else
+		for (int x=0; x<outputWidth; x++)
+			outputLine[x] = sceneLine[sourceColumn[x]];
+}
+
+void TeletextOffscreenRender::resampleLine(const uchar *sceneLine, uchar *outputLine, int outputWidth) const
+{
+	const int *sourceColumn = m_sourceColumn.data();
+
+	for (int x=0; x<outputWidth; x++)
+		outputLine[x] = sceneLine[sourceColumn[x]];
+}
+
+bool TeletextOffscreenRender::render(const Options &options, QImage::Format format, uchar *buffer, qsizetype bytesPerLine)
+{
+	if (format != QImage::Format_ARGB32 && format != QImage::Format_ARGB32_Premultiplied && format != QImage::Format_Indexed8)
+		return false;
+	if (!prepare(options))
+		return false;
+
+	const QSize scene = sceneSize(options);
+	const int sceneWidth = scene.width();
+	const int topBottomBorders = (scene.height() - 250) / 2;
+	const int leftColumns = m_pageDecode.leftSidePanelColumns();
+	const int rightColumns = m_pageDecode.rightSidePanelColumns();
+	const int widgetWidth = 480 + (leftColumns + rightColumns) * 12;
+	const int leftRightBorders = (sceneWidth - widgetWidth) / 2;
+
+	if (format == QImage::Format_Indexed8)
+		buildColourLookup(options);
+
+	// Pick the flash buffer holding this phase, phases share a buffer if the page flashes slower
+	int ph = qBound(0, options.flashPhase, 5);
+
+	if (m_pageRender.flashHz() == 0)
+		ph = 0;
+	else if (m_pageRender.flashHz() == 1)
+		ph = (ph < 3) ? 0 : 3;
+
+	const QImage *pageImage = m_pageRender.image(ph);
+
+	QRgb fullScreenColour;
+	QRgb fullRowColour[25];
+
+	switch (options.renderMode) {
+		case TeletextPageRender::RenderNormal:
+			fullScreenColour = qPremultiply(m_pageDecode.fullScreenQColor().rgba());
+			for (int r=0; r<25; r++)
+				fullRowColour[r] = qPremultiply(m_pageDecode.fullRowQColor(r).rgba());
+			break;
+		case TeletextPageRender::RenderMix:
+			fullScreenColour = 0x00000000;
+			break;
+		case TeletextPageRender::RenderWhiteOnBlack:
+			fullScreenColour = 0xff000000;
+			break;
+		case TeletextPageRender::RenderBlackOnWhite:
+			fullScreenColour = 0xffffffff;
+			break;
+	}
+	if (options.renderMode != TeletextPageRender::RenderNormal)
+		std::fill_n(fullRowColour, 25, fullScreenColour);
+
+	const QSize output = outputSize(options, scene);
+	const int outputWidth = output.width();
+	// Each page pixel row is repeated this many times in the output
+	const int rowRepeat = output.height() / scene.height();
+	const bool resample = outputWidth != sceneWidth;
+	const size_t outputLineBytes = outputWidth * ((format == QImage::Format_Indexed8) ? 1 : sizeof(QRgb));
+
+	if (resample)
+		buildColumnMap(sceneWidth, outputWidth, options.smooth && format != QImage::Format_Indexed8);
+
+	std::vector<QRgb> sceneLine(sceneWidth);
+	std::vector<uchar> sceneIndexLine(resample ? sceneWidth : 0);
+
+	for (int y=0; y<scene.height(); y++) {
+		uchar *outputLine = buffer + y*rowRepeat*bytesPerLine;
+		QRgb *line = (format == QImage::Format_Indexed8 || resample) ? sceneLine.data() : reinterpret_cast<QRgb *>(outputLine);
+
+		if (y < topBottomBorders || y >= topBottomBorders+250)
+			std::fill_n(line, sceneWidth, fullScreenColour);
+		else {
+			const int py = y - topBottomBorders;
+			const QRgb *pageLine = reinterpret_cast<const QRgb *>(pageImage->constScanLine(py));
+			QRgb *widgetLine = line + leftRightBorders;
+
+			std::fill_n(line, leftRightBorders, fullRowColour[py / 10]);
+			// Left side panel is at the far right of the page image, main 40 columns then right side panel follow on from the start
+			std::copy_n(pageLine + 864 - leftColumns*12, leftColumns*12, widgetLine);
+			std::copy_n(pageLine, 480 + rightColumns*12, widgetLine + leftColumns*12);
+			std::fill(widgetLine + widgetWidth, line + sceneWidth, fullRowColour[py / 10]);
+		}
+
+		if (format == QImage::Format_Indexed8) {
+			// Map to colour indexes before resampling, so each page pixel is only looked up once
+			uchar *indexLine = resample ? sceneIndexLine.data() : outputLine;
+
+			for (int x=0; x<sceneWidth; x++)
+				indexLine[x] = colourIndex(line[x]);
+
+			if (resample)
+				resampleLine(indexLine, outputLine, outputWidth);
+		} else {
+			QRgb *argbLine = reinterpret_cast<QRgb *>(outputLine);
+
+			if (resample)
+				resampleLine(line, argbLine, outputWidth);
+
+			if (format == QImage::Format_ARGB32)
+				for (int x=0; x<outputWidth; x++)
+					argbLine[x] = qUnpremultiply(argbLine[x]);
+		}
+
+		// Vertical scaling is plain repetition of the finished output line
+		for (int i=1; i<rowRepeat; i++)
+			std::memcpy(outputLine + i*bytesPerLine, outputLine, outputLineBytes);
+	}
+
+	return true;
+}
+
+QImage TeletextOffscreenRender::image(const Options &options, QImage::Format format)
+{
+	const QSize imageSize = size(options);
+
+	if (!imageSize.isValid())
+		return QImage();
+
+	QImage result(imageSize, format);
+
+	if (format == QImage::Format_Indexed8)
+		result.setColorTable(colourTable(options));
+
+	if (!render(options, format, result.bits(), result.bytesPerLine()))
+		return QImage();
+
+	return result;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef OFFSCREENRENDER_H
+#define OFFSCREENRENDER_H
+
+#include <QImage>
+#include <QList>
+#include <QSize>
+
+#include <vector>
+
+#include "decode.h"
+#include "drcspage.h"
+#include "levelonepage.h"
+#include "render.h"
+
+// Renders a page into a plain pixel buffer, complete with border, full screen and full row
+// colours and side panels, without needing any widgets or a QGraphicsScene
+class TeletextOffscreenRender
+{
+public:
+	struct Options {
+		TeletextPageRender::RenderMode renderMode = TeletextPageRender::RenderNormal;
+		bool reveal = false;
+		int level = 3;
+		// 0 to 5, same numbering as the flash buffers of TeletextPageRender
+		int flashPhase = 0;
+		// 0 = none, 1 = minimal, 2 = full TV
+		int border = 0;
+		// 0 = 4:3, 1 = 16:9 pillar box, 2 = 16:9 stretch, 3 = pixel 1:2
+		int aspectRatio = 0;
+		// 0 = raw page pixels with no aspect ratio correction
+		// 1 to 8 = aspect ratio corrected, each page pixel row repeated twice this number
+		int scale = 0;
+		// Interpolate the fractional horizontal aspect ratio correction instead of picking nearest pixels
+		// Ignored for Indexed8 output
+		bool smooth = false;
+	};
+
+	// Index of the transparent colour in the Indexed8 colour table
+	static constexpr int TransparentIndex = 32;
+
+	TeletextOffscreenRender();
+
+	LevelOnePage *teletextPage() const { return m_levelOnePage; };
+	void setTeletextPage(LevelOnePage *page);
+	void setDRCSPage(TeletextPageDecode::DRCSPageType pageType, const DRCSPageSet *pages);
+
+	QSize size(const Options &options);
+	int flashHz(const Options &options);
+	QList<QRgb> colourTable(const Options &options);
+
+	bool render(const Options &options, QImage::Format format, uchar *buffer, qsizetype bytesPerLine);
+	QImage image(const Options &options, QImage::Format format = QImage::Format_ARGB32);
+
+private:
+	bool prepare(const Options &options);
+	QSize sceneSize(const Options &options) const;
+	QSize outputSize(const Options &options, const QSize &scene) const;
+	void buildColumnMap(int sceneWidth, int outputWidth, bool smooth);
+	void resampleLine(const QRgb *sceneLine, QRgb *outputLine, int outputWidth) const;
+	void resampleLine(const uchar *sceneLine, uchar *outputLine, int outputWidth) const;
+	void buildColourLookup(const Options &options);
+	inline uchar colourIndex(QRgb colour) const;
+
+	LevelOnePage *m_levelOnePage;
+	TeletextPageDecode m_pageDecode;
+	TeletextPageRender m_pageRender;
+	// Maps 12 bit RGB back to the lowest CLUT index having that colour
+	uchar m_colourLookup[4096];
+	QList<QRgb> m_colourTable;
+	// Source column and 8 bit weight of the next column along for each output column
+	std::vector<int> m_sourceColumn;
+	std::vector<uchar> m_sourceWeight;
+	bool m_smoothColumns;
+	bool m_renderAll;
+};
+
+#endif
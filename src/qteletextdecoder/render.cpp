@@ -21,38 +21,72 @@
 #include <QColor>
 #include <QDir>
 #include <QImage>
-#include <QPainter>
 #include <QPixmap>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cstring>
 
 #include "render.h"
 
 #include "decode.h"
 
-int TeletextFontBitmap::s_instances = 0;
+std::atomic<int> TeletextFontBitmap::s_instances = 0;
 
 QBitmap *TeletextFontBitmap::s_fontBitmap = nullptr;
 QImage *TeletextFontBitmap::s_fontImage = nullptr;
+const quint16 TeletextFontBitmap::s_glyphRows[27][96][10] = {
+#include "teletextfontatlas.inc"
+};
 
 TeletextFontBitmap::TeletextFontBitmap()
 {
-	Q_INIT_RESOURCE(teletextfonts);
-
-	if (s_instances == 0) {
-		s_fontBitmap = new QBitmap(":/fontimages/teletextfont.png");
-		s_fontImage = new QImage(s_fontBitmap->toImage());
-	}
 	s_instances++;
 }
 
 TeletextFontBitmap::~TeletextFontBitmap()
 {
-	s_instances--;
-	if (s_instances == 0) {
+	if (--s_instances == 0) {
 		delete s_fontImage;
+		s_fontImage = nullptr;
 		delete s_fontBitmap;
+		s_fontBitmap = nullptr;
+	}
+}
+
+QImage *TeletextFontBitmap::fontImage()
+{
+	if (s_fontImage == nullptr) {
+		// Same layout and colours as teletextfont.png: glyph pixels opaque white, everything else transparent
+		s_fontImage = new QImage(96*12, 27*10, QImage::Format_MonoLSB);
+		s_fontImage->setColorTable({ qRgba(0, 0, 0, 0), qRgba(255, 255, 255, 255) });
+		s_fontImage->fill(0);
+
+		for (int s=0; s<27; s++)
+			for (int y=0; y<10; y++) {
+				uchar *scanLine = s_fontImage->scanLine(s*10+y);
+
+				for (int c=0; c<96; c++) {
+					const quint16 glyphRow = s_glyphRows[s][c][y];
+
+					for (int x=0; x<12; x++)
+						if (glyphRow & (1 << x))
+							scanLine[(c*12+x) >> 3] |= 1 << ((c*12+x) & 7);
+				}
+			}
 	}
+
+	return s_fontImage;
 }
 
+QBitmap *TeletextFontBitmap::fontBitmap()
+{
+	if (s_fontBitmap == nullptr)
+		s_fontBitmap = new QBitmap(QBitmap::fromImage(*fontImage()));
+
+	return s_fontBitmap;
+}
 
 TeletextPageRender::TeletextPageRender()
 {
@@ -82,73 +116,115 @@ void TeletextPageRender::setDecoder(TeletextPageDecode *decoder)
 	m_decoder = decoder;
 }
 
-inline void TeletextPageRender::drawFromBitmap(QPainter &painter, int r, int c, const QImage image, TeletextPageDecode::CharacterFragment characterFragment)
+// Source origin and stretch of each character fragment within a 12x10 glyph
+// Indexed by TeletextPageDecode::CharacterFragment
+static constexpr struct {
+	int x, y, xShift, yShift;
+} s_fragmentSource[9] = {
+	{ 0, 0, 0, 0 }, // NormalSize
+	{ 0, 0, 0, 1 }, // DoubleHeightTopHalf
+	{ 0, 5, 0, 1 }, // DoubleHeightBottomHalf
+	{ 0, 0, 1, 0 }, // DoubleWidthLeftHalf
+	{ 6, 0, 1, 0 }, // DoubleWidthRightHalf
+	{ 0, 0, 1, 1 }, // DoubleSizeTopLeftQuarter
+	{ 6, 0, 1, 1 }, // DoubleSizeTopRightQuarter
+	{ 0, 5, 1, 1 }, // DoubleSizeBottomLeftQuarter
+	{ 6, 5, 1, 1 }  // DoubleSizeBottomRightQuarter
+};
+
+// Composite premultiplied source pixel over destination pixel
+static inline QRgb blendSourceOver(QRgb source, QRgb destination)
+{
+	const int inverseAlpha = 255 - qAlpha(source);
+
+	return source + qRgba(qRed(destination)*inverseAlpha/255, qGreen(destination)*inverseAlpha/255, qBlue(destination)*inverseAlpha/255, qAlpha(destination)*inverseAlpha/255);
+}
+
+void TeletextPageRender::lockPageImages()
 {
-	switch (characterFragment) {
-		case TeletextPageDecode::NormalSize:
-			painter.drawImage(c*12, r*10, image);
-			break;
-		case TeletextPageDecode::DoubleHeightTopHalf:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), image, QRect(0, 0, 12, 5));
-			break;
-		case TeletextPageDecode::DoubleHeightBottomHalf:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), image, QRect(0, 5, 12, 5));
-			break;
-		case TeletextPageDecode::DoubleWidthLeftHalf:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), image, QRect(0, 0, 6, 10));
-			break;
-		case TeletextPageDecode::DoubleWidthRightHalf:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), image, QRect(6, 0, 6, 10));
-			break;
-		case TeletextPageDecode::DoubleSizeTopLeftQuarter:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), image, QRect(0, 0, 6, 5));
-			break;
-		case TeletextPageDecode::DoubleSizeTopRightQuarter:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), image, QRect(6, 0, 6, 5));
-			break;
-		case TeletextPageDecode::DoubleSizeBottomLeftQuarter:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), image, QRect(0, 5, 6, 5));
-			break;
-		case TeletextPageDecode::DoubleSizeBottomRightQuarter:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), image, QRect(6, 5, 6, 5));
-			break;
+	// Grab the pixel pointers here on the calling thread, as bits() may detach the image
+	for (int i=0; i<6; i++)
+		m_pagePixels[i] = reinterpret_cast<QRgb *>(m_pageImage[i]->bits());
+
+	m_pageStride = m_pageImage[0]->bytesPerLine() / sizeof(QRgb);
+}
+
+void TeletextPageRender::forEachRow(bool parallel, const std::function<void(int)> &rowFunction)
+{
+	QThreadPool *threadPool = QThreadPool::globalInstance();
+	const int bands = parallel ? qBound(1, threadPool->maxThreadCount(), 25) : 1;
+	QSemaphore bandsDone;
+
+	// Rows are interleaved across the bands so that busy areas of the page get shared out
+	for (int b=1; b<bands; b++) {
+		auto band = [&rowFunction, &bandsDone, b, bands]() {
+			for (int r=b; r<25; r+=bands)
+				rowFunction(r);
+			bandsDone.release();
+		};
+
+		// If no thread is free, e.g. we are already running inside the pool, do the band ourselves
+		if (!threadPool->tryStart(band))
+			band();
+	}
+
+	for (int r=0; r<25; r+=bands)
+		rowFunction(r);
+
+	bandsDone.acquire(bands-1);
+}
+
+inline void TeletextPageRender::fillCell(int ph, int r, int c, QRgb colour)
+{
+	for (int y=0; y<10; y++)
+		std::fill_n(pixelRow(ph, r*10+y) + c*12, 12, colour);
+}
+
+inline void TeletextPageRender::drawFromMask(int ph, int r, int c, const quint16 mask[10], QRgb foreground, QRgb background, TeletextPageDecode::CharacterFragment characterFragment)
+{
+	const auto &source = s_fragmentSource[characterFragment];
+
+	for (int y=0; y<10; y++) {
+		QRgb *scanLine = pixelRow(ph, r*10+y) + c*12;
+		const quint16 rowMask = mask[source.y + (y >> source.yShift)] >> source.x;
+
+		for (int x=0; x<12; x++)
+			scanLine[x] = (rowMask >> (x >> source.xShift) & 1) ? foreground : background;
+	}
+}
+
+inline void TeletextPageRender::overlayFromMask(int ph, int r, int c, const quint16 mask[10], QRgb foreground, TeletextPageDecode::CharacterFragment characterFragment)
+{
+	const auto &source = s_fragmentSource[characterFragment];
+
+	for (int y=0; y<10; y++) {
+		QRgb *scanLine = pixelRow(ph, r*10+y) + c*12;
+		const quint16 rowMask = mask[source.y + (y >> source.yShift)] >> source.x;
+
+		for (int x=0; x<12; x++)
+			if (rowMask >> (x >> source.xShift) & 1)
+				scanLine[x] = foreground;
 	}
 }
 
-inline void TeletextPageRender::drawFromFontBitmap(QPainter &painter, int r, int c, unsigned char characterCode, int characterSet, TeletextPageDecode::CharacterFragment characterFragment)
+inline void TeletextPageRender::drawFromBitmap(int ph, int r, int c, const QImage &image, TeletextPageDecode::CharacterFragment characterFragment)
 {
-	switch (characterFragment) {
-		case TeletextPageDecode::NormalSize:
-			painter.drawImage(c*12, r*10, *m_fontBitmap.image(), (characterCode-32)*12, characterSet*10, 12, 10);
-			break;
-		case TeletextPageDecode::DoubleHeightTopHalf:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), *m_fontBitmap.image(), QRect((characterCode-32)*12, characterSet*10, 12, 5));
-			break;
-		case TeletextPageDecode::DoubleHeightBottomHalf:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), *m_fontBitmap.image(), QRect((characterCode-32)*12, characterSet*10+5, 12, 5));
-			break;
-		case TeletextPageDecode::DoubleWidthLeftHalf:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), *m_fontBitmap.image(), QRect((characterCode-32)*12, characterSet*10, 6, 10));
-			break;
-		case TeletextPageDecode::DoubleWidthRightHalf:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), *m_fontBitmap.image(), QRect((characterCode-32)*12+6, characterSet*10, 6, 10));
-			break;
-		case TeletextPageDecode::DoubleSizeTopLeftQuarter:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), *m_fontBitmap.image(), QRect((characterCode-32)*12, characterSet*10, 6, 5));
-			break;
-		case TeletextPageDecode::DoubleSizeTopRightQuarter:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), *m_fontBitmap.image(), QRect((characterCode-32)*12+6, characterSet*10, 6, 5));
-			break;
-		case TeletextPageDecode::DoubleSizeBottomLeftQuarter:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), *m_fontBitmap.image(), QRect((characterCode-32)*12, characterSet*10+5, 6, 5));
-			break;
-		case TeletextPageDecode::DoubleSizeBottomRightQuarter:
-			painter.drawImage(QRect(c*12, r*10, 12, 10), *m_fontBitmap.image(), QRect((characterCode-32)*12+6, characterSet*10+5, 6, 5));
-			break;
+	const auto &source = s_fragmentSource[characterFragment];
+	QList<QRgb> colourTable = image.colorTable();
+
+	for (QRgb &colour : colourTable)
+		colour = qPremultiply(colour);
+
+	for (int y=0; y<10; y++) {
+		QRgb *scanLine = pixelRow(ph, r*10+y) + c*12;
+		const uchar *sourceLine = image.constScanLine(source.y + (y >> source.yShift)) + source.x;
+
+		for (int x=0; x<12; x++)
+			scanLine[x] = colourTable.value(sourceLine[x >> source.xShift]);
 	}
 }
 
-inline void TeletextPageRender::drawCharacter(QPainter &painter, int r, int c, unsigned char characterCode, int characterSet, int characterDiacritical, TeletextPageDecode::CharacterFragment characterFragment)
+inline void TeletextPageRender::drawCharacter(int ph, int r, int c, unsigned char characterCode, int characterSet, int characterDiacritical, TeletextPageDecode::CharacterFragment characterFragment, QRgb foreground, QRgb background)
 {
 	const bool dontUnderline = characterCode == 0x00;
 	if (dontUnderline)
@@ -165,121 +241,160 @@ inline void TeletextPageRender::drawCharacter(QPainter &painter, int r, int c, u
 		characterSet = 24;
 
 	if (characterCode == 0x20 && characterSet < 25 && characterDiacritical == 0)
-		painter.fillRect(c*12, r*10, 12, 10, m_backgroundQColor);
+		fillCell(ph, r, c, background);
 	else if (characterCode == 0x7f && characterSet == 24)
-		painter.fillRect(c*12, r*10, 12, 10, m_foregroundQColor);
-	else if ((m_decoder->cellBold(r, c) || m_decoder->cellItalic(r, c)))
-		drawBoldOrItalicCharacter(painter, r, c, characterCode, characterSet, characterFragment);
+		fillCell(ph, r, c, foreground);
 	else {
-		m_fontBitmap.image()->setColorTable(QList<QRgb>{m_backgroundQColor.rgba(), m_foregroundQColor.rgba()});
-		drawFromFontBitmap(painter, r, c, characterCode, characterSet, characterFragment);
+		quint16 mask[10];
+
+		for (int y=0; y<10; y++)
+			mask[y] = m_fontBitmap.glyphRow(characterCode, characterSet, y);
+
+		// Don't apply style to mosaics
+		const bool mosaic = characterSet > 24 || (characterSet == 24 && (characterCode < 0x41 || characterCode > 0x5a));
+
+		if (!mosaic && m_decoder->cellItalic(r, c)) {
+			// Top three pixel rows lean one pixel right, bottom four lean one pixel left
+			for (int y=0; y<3; y++)
+				mask[y] = (mask[y] << 1) & 0xfff;
+			for (int y=6; y<10; y++)
+				mask[y] >>= 1;
+		}
+		// We have either an unstyled or italic character. Now bolden if needed.
+		if (!mosaic && m_decoder->cellBold(r, c))
+			for (int y=0; y<10; y++)
+				mask[y] |= (mask[y] << 1) & 0xfff;
+
+		drawFromMask(ph, r, c, mask, foreground, background, characterFragment);
 	}
 
-	if (m_decoder->cellUnderlined(r, c) && !dontUnderline) {
-		painter.setPen(m_foregroundQColor);
+	if (m_decoder->cellUnderlined(r, c) && !dontUnderline)
 		switch (characterFragment) {
 			case TeletextPageDecode::NormalSize:
 			case TeletextPageDecode::DoubleWidthLeftHalf:
 			case TeletextPageDecode::DoubleWidthRightHalf:
-				painter.drawLine(c*12, r*10+9, c*12+11, r*10+9);
+				std::fill_n(pixelRow(ph, r*10+9) + c*12, 12, foreground);
 				break;
 			case TeletextPageDecode::DoubleHeightBottomHalf:
 			case TeletextPageDecode::DoubleSizeBottomLeftQuarter:
 			case TeletextPageDecode::DoubleSizeBottomRightQuarter:
-				painter.drawRect(c*12, r*10+8, 11, 1);
+				std::fill_n(pixelRow(ph, r*10+8) + c*12, 12, foreground);
+				std::fill_n(pixelRow(ph, r*10+9) + c*12, 12, foreground);
 				break;
 			default:
 				break;
 		}
-	}
 
 	if (characterDiacritical != 0) {
-		painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-		m_fontBitmap.image()->setColorTable(QList<QRgb>{0x00000000, m_foregroundQColor.rgba()});
-		drawFromFontBitmap(painter, r, c, characterDiacritical+64, 7, characterFragment);
-		painter.setCompositionMode(QPainter::CompositionMode_Source);
+		quint16 mask[10];
+
+		for (int y=0; y<10; y++)
+			mask[y] = m_fontBitmap.glyphRow(characterDiacritical+64, 7, y);
+
+		overlayFromMask(ph, r, c, mask, foreground, characterFragment);
 	}
 }
 
-inline bool TeletextPageRender::drawDRCSCharacter(QPainter &painter, int r, int c, TeletextPageDecode::DRCSSource drcsSource, int drcsSubTable, int drcsChar, TeletextPageDecode::CharacterFragment characterFragment, bool flashPhOn)
+inline bool TeletextPageRender::drawDRCSCharacter(int ph, int r, int c, TeletextPageDecode::DRCSSource drcsSource, int drcsSubTable, int drcsChar, TeletextPageDecode::CharacterFragment characterFragment, QRgb foreground, QRgb background, bool flashPhOn)
 {
 	QImage drcsImage = m_decoder->drcsImage(drcsSource, drcsSubTable, drcsChar, flashPhOn);
 
 	if (drcsImage.isNull())
 		return false;
 
-	if (drcsImage.format() == QImage::Format_Mono)
+	if (drcsImage.format() == QImage::Format_Mono) {
 		// mode 0 (12x10x1) returned here has no colours of its own
 		// so apply the foreground and background colours of the cell it appears in
-		drcsImage.setColorTable(QVector<QRgb>{m_backgroundQColor.rgba(), m_foregroundQColor.rgba()});
-	else if (m_renderMode >= RenderWhiteOnBlack)
+		quint16 mask[10];
+
+		for (int y=0; y<10; y++) {
+			const uchar *scanLine = drcsImage.constScanLine(y);
+
+			mask[y] = 0;
+			for (int x=0; x<12; x++)
+				if (scanLine[x >> 3] >> (7 - (x & 7)) & 1)
+					mask[y] |= 1 << x;
+		}
+
+		drawFromMask(ph, r, c, mask, foreground, background, characterFragment);
+		return true;
+	}
+
+	if (m_renderMode >= RenderWhiteOnBlack)
 		// modes 1-3: crudely convert colours to monochrome
-		for (int i=0; i<16; i++)
+		for (int i=0; i<drcsImage.colorCount(); i++)
 			drcsImage.setColor(i, qGray(drcsImage.color(i)) > 127 ? 0xffffffff : 0xff000000);
 
-	drawFromBitmap(painter, r, c, drcsImage, characterFragment);
+	drawFromBitmap(ph, r, c, drcsImage, characterFragment);
 
 	return true;
 }
 
-inline void TeletextPageRender::drawBoldOrItalicCharacter(QPainter &painter, int r, int c, unsigned char characterCode, int characterSet, TeletextPageDecode::CharacterFragment characterFragment)
+inline void TeletextPageRender::drawControlCode(int ph, int r, int c, unsigned char controlCode)
 {
-	QImage styledImage = QImage(12, 10, QImage::Format_Mono);
-	QPainter styledPainter;
-
-	// Don't apply style to mosaics
-	const bool mosaic = characterSet > 24 || (characterSet == 24 && (characterCode < 0x41 || characterCode > 0x5a));
-
-	m_fontBitmap.image()->setColorTable(QList<QRgb>{m_backgroundQColor.rgba(), m_foregroundQColor.rgba()});
-	styledImage.setColorTable(QList<QRgb>{m_backgroundQColor.rgba(), m_foregroundQColor.rgba()});
-
-	if (!mosaic && m_decoder->cellItalic(r, c)) {
-		styledImage.fill(0);
-
-		styledPainter.begin(&styledImage);
-		styledPainter.setCompositionMode(QPainter::CompositionMode_Source);
-		styledPainter.drawImage(1, 0, *m_fontBitmap.image(), (characterCode-32)*12, characterSet*10, 11, 3);
-		styledPainter.drawImage(0, 3, *m_fontBitmap.image(), (characterCode-32)*12, characterSet*10+3, 12, 3);
-		styledPainter.drawImage(0, 6, *m_fontBitmap.image(), (characterCode-32)*12+1, characterSet*10+6, 11, 4);
-		styledPainter.end();
-	} else
-		styledImage = m_fontBitmap.image()->copy((characterCode-32)*12, characterSet*10, 12, 10);
-
-	// We have either an unstyled or italic character. Now bolden if needed.
-	if (!mosaic && m_decoder->cellBold(r, c)) {
-		QImage boldeningImage;
-
-		boldeningImage = styledImage.copy();
-		styledPainter.begin(&styledImage);
-		styledPainter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-		boldeningImage.setColorTable(QList<QRgb>{0x00000000, m_foregroundQColor.rgba()});
-		styledPainter.drawImage(1, 0, boldeningImage);
-		styledPainter.end();
+	// Control code glyphs are on the row below the last character set in the font bitmap
+	static const QRgb controlCodeForeground = qPremultiply(0xe0ffffff);
+	static const QRgb controlCodeBackground = qPremultiply(0x7f000000);
+
+	for (int y=0; y<10; y++) {
+		QRgb *scanLine = pixelRow(ph, r*10+y) + c*12;
+		const quint16 rowMask = m_fontBitmap.glyphRow(controlCode+64, 25, y);
+
+		for (int x=0; x<12; x++)
+			scanLine[x] = blendSourceOver((rowMask >> x & 1) ? controlCodeForeground : controlCodeBackground, scanLine[x]);
 	}
-	drawFromBitmap(painter, r, c, styledImage, characterFragment);
 }
 
 void TeletextPageRender::renderPage(bool force)
 {
-	if (m_renderMode == RenderWhiteOnBlack) {
-		m_foregroundQColor = Qt::white;
-		m_backgroundQColor = Qt::black;
-	} else if (m_renderMode == RenderBlackOnWhite) {
-		m_foregroundQColor = Qt::black;
-		m_backgroundQColor = Qt::white;
-	}
+	// Below this many changed rows it's not worth waking up other threads
+	const int parallelRowThreshold = 8;
+	int rowsToRender = 0;
+
 	for (int r=0; r<25; r++)
-		renderRow(r, 0, force);
+		for (int c=0; c<72; c++)
+			if (m_decoder->refresh(r, c)) {
+				rowsToRender++;
+				break;
+			}
+
+	const bool parallel = force || rowsToRender >= parallelRowThreshold;
+	int flashingRow[25];
+	bool rowRefreshed[25];
+
+	lockPageImages();
+	forEachRow(parallel, [&](int r) { rowRefreshed[r] = renderRow(r, 0, force, &flashingRow[r]); });
+
+	// Refresh flags are packed into shared words and flash status spans the whole page,
+	// so deal with both here once every row has been drawn
+	for (int r=0; r<25; r++) {
+		for (int c=0; c<72; c++)
+			m_decoder->setRefresh(r, c, false);
+
+		if (flashingRow[r] != m_flashingRow[r])
+			setRowFlashStatus(r, flashingRow[r]);
+	}
+
+	if (m_flashBuffersHz == 0)
+		return;
+
+	// setRowFlashStatus may have replaced the flash buffer images
+	lockPageImages();
+	forEachRow(parallel, [&](int r) {
+		if (rowRefreshed[r])
+			renderFlashRow(r);
+	});
 }
 
-void TeletextPageRender::renderRow(int r, int ph, bool force)
+bool TeletextPageRender::renderRow(int r, int ph, bool force, int *flashingRow)
 {
-	QPainter painter;
-	int flashingRow = 0;
+	QRgb foregroundColour = 0xffffffff;
+	QRgb backgroundColour = 0xff000000;
+	int rowFlashHz = 0;
 	bool rowRefreshed = false;
 
-	painter.begin(m_pageImage[ph]);
-	painter.setCompositionMode(QPainter::CompositionMode_Source);
+	if (m_renderMode == RenderBlackOnWhite)
+		std::swap(foregroundColour, backgroundColour);
 
 	for (int c=0; c<72; c++) {
 		bool controlCodeChanged = false;
@@ -298,7 +413,7 @@ void TeletextPageRender::renderRow(int r, int ph, bool force)
 		// Second part of "if" suppresses all flashing on monochrome render modes
 		if (ph == 0 && m_renderMode < RenderWhiteOnBlack) {
 			if (m_decoder->cellFlashMode(r, c) != 0)
-				flashingRow = qMax(flashingRow, (m_decoder->cellFlashRatePhase(r, c) == 0) ? 1 : 2);
+				rowFlashHz = qMax(rowFlashHz, (m_decoder->cellFlashRatePhase(r, c) == 0) ? 1 : 2);
 //		} else if (!force)
 		} else
 			force = m_decoder->cellFlashMode(r, c) != 0;
@@ -314,7 +429,7 @@ void TeletextPageRender::renderRow(int r, int ph, bool force)
 
 			if (m_renderMode < RenderWhiteOnBlack) {
 				if (m_decoder->cellFlashMode(r, c) == 0)
-					m_foregroundQColor = m_decoder->cellForegroundQColor(r, c);
+					foregroundColour = qPremultiply(m_decoder->cellForegroundQColor(r, c).rgba());
 				else {
 					// Flashing cell, decide if phase in this cycle is on or off
 					if (m_decoder->cellFlashRatePhase(r, c) == 0)
@@ -324,82 +439,62 @@ void TeletextPageRender::renderRow(int r, int ph, bool force)
 
 					// If flashing to adjacent CLUT select the appropriate foreground colour
 					if (m_decoder->cellFlashMode(r, c) == 3 && !flashPhOn)
-						m_foregroundQColor = m_decoder->cellFlashForegroundQColor(r, c);
+						foregroundColour = qPremultiply(m_decoder->cellFlashForegroundQColor(r, c).rgba());
 					else
-						m_foregroundQColor = m_decoder->cellForegroundQColor(r, c);
+						foregroundColour = qPremultiply(m_decoder->cellForegroundQColor(r, c).rgba());
 				}
 
 				if (m_renderMode != RenderMix || m_decoder->cellBoxed(r, c))
-					m_backgroundQColor = m_decoder->cellBackgroundQColor(r, c);
+					backgroundColour = qPremultiply(m_decoder->cellBackgroundQColor(r, c).rgba());
 				else
-					m_backgroundQColor = Qt::transparent;
+					backgroundColour = 0x00000000;
 			}
 
 			if (((m_decoder->cellFlashMode(r, c) == 1 || m_decoder->cellFlashMode(r, c) == 2) && !flashPhOn))
 				// If flashing mode is Normal or Invert, draw a space instead of a character on phase
 				// Character 0x00 draws space without underline
-				drawCharacter(painter, r, c, 0x00, 0, 0, m_decoder->cellCharacterFragment(r, c));
+				drawCharacter(ph, r, c, 0x00, 0, 0, m_decoder->cellCharacterFragment(r, c), foregroundColour, backgroundColour);
 			else if (concealed)
-				drawCharacter(painter, r, c, 0x20, 0, 0, m_decoder->cellCharacterFragment(r, c));
-			else if (m_decoder->cellDrcsSource(r, c) == TeletextPageDecode::NoDRCS || !drawDRCSCharacter(painter, r, c, m_decoder->cellDrcsSource(r, c), m_decoder->cellDrcsSubTable(r, c), m_decoder->cellDrcsCharacter(r, c), m_decoder->cellCharacterFragment(r, c), flashPhOn))
-				drawCharacter(painter, r, c, m_decoder->cellCharacterCode(r, c), m_decoder->cellCharacterSet(r, c), m_decoder->cellCharacterDiacritical(r, c), m_decoder->cellCharacterFragment(r, c));
-
-			if (m_showControlCodes && c < 40 && m_decoder->teletextPage()->character(r, c) < 0x20) {
-				painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
-				m_fontBitmap.image()->setColorTable(QList<QRgb>{0x7f000000, 0xe0ffffff});
-				painter.drawImage(c*12, r*10, *m_fontBitmap.image(), (m_decoder->teletextPage()->character(r, c)+32)*12, 250, 12, 10);
-				painter.setCompositionMode(QPainter::CompositionMode_Source);
-			}
+				drawCharacter(ph, r, c, 0x20, 0, 0, m_decoder->cellCharacterFragment(r, c), foregroundColour, backgroundColour);
+			else if (m_decoder->cellDrcsSource(r, c) == TeletextPageDecode::NoDRCS || !drawDRCSCharacter(ph, r, c, m_decoder->cellDrcsSource(r, c), m_decoder->cellDrcsSubTable(r, c), m_decoder->cellDrcsCharacter(r, c), m_decoder->cellCharacterFragment(r, c), foregroundColour, backgroundColour, flashPhOn))
+				drawCharacter(ph, r, c, m_decoder->cellCharacterCode(r, c), m_decoder->cellCharacterSet(r, c), m_decoder->cellCharacterDiacritical(r, c), m_decoder->cellCharacterFragment(r, c), foregroundColour, backgroundColour);
+
+			if (m_showControlCodes && c < 40 && m_decoder->teletextPage()->character(r, c) < 0x20)
+				drawControlCode(ph, r, c, m_decoder->teletextPage()->character(r, c));
 		}
 	}
 
-	painter.end();
-
 	if (ph != 0)
-		return;
+		return rowRefreshed;
+
+	if (rowFlashHz == 3)
+		rowFlashHz = 2;
+	if (flashingRow != nullptr)
+		*flashingRow = rowFlashHz;
 
-	if (flashingRow == 3)
-		flashingRow = 2;
-	if (flashingRow != m_flashingRow[r])
-		setRowFlashStatus(r, flashingRow);
+	return rowRefreshed;
+}
 
-	for (int c=0; c<72; c++)
-		m_decoder->setRefresh(r, c, false);
+void TeletextPageRender::renderFlashRow(int r)
+{
+	const size_t rowBytes = m_pageStride * 10 * sizeof(QRgb);
 
-	// If row had changes rendered and flashing is present anywhere on the screen,
-	// copy this rendered line into the other flash pixmap buffers and then re-render
+	// Copy this rendered row into the other flash pixmap buffers and then re-render
 	// the flashing cells in those buffers
-	if (rowRefreshed && m_flashBuffersHz > 0) {
-		painter.begin(m_pageImage[3]);
-		painter.setCompositionMode(QPainter::CompositionMode_Source);
-		painter.drawImage(0, r*10, *m_pageImage[0], 0, r*10, 864, 10);
-		painter.end();
-
-		renderRow(r, 3);
-
-		if (m_flashBuffersHz == 2) {
-			painter.begin(m_pageImage[1]);
-			painter.setCompositionMode(QPainter::CompositionMode_Source);
-			painter.drawImage(0, r*10, *m_pageImage[0], 0, r*10, 864, 10);
-			painter.end();
-			painter.begin(m_pageImage[2]);
-			painter.setCompositionMode(QPainter::CompositionMode_Source);
-			painter.drawImage(0, r*10, *m_pageImage[0], 0, r*10, 864, 10);
-			painter.end();
-			painter.begin(m_pageImage[4]);
-			painter.setCompositionMode(QPainter::CompositionMode_Source);
-			painter.drawImage(0, r*10, *m_pageImage[3], 0, r*10, 864, 10);
-			painter.end();
-			painter.begin(m_pageImage[5]);
-			painter.setCompositionMode(QPainter::CompositionMode_Source);
-			painter.drawImage(0, r*10, *m_pageImage[3], 0, r*10, 864, 10);
-			painter.end();
-
-			renderRow(r, 1);
-			renderRow(r, 2);
-			renderRow(r, 4);
-			renderRow(r, 5);
-		}
+	std::memcpy(pixelRow(3, r*10), pixelRow(0, r*10), rowBytes);
+
+	renderRow(r, 3);
+
+	if (m_flashBuffersHz == 2) {
+		std::memcpy(pixelRow(1, r*10), pixelRow(0, r*10), rowBytes);
+		std::memcpy(pixelRow(2, r*10), pixelRow(0, r*10), rowBytes);
+		std::memcpy(pixelRow(4, r*10), pixelRow(3, r*10), rowBytes);
+		std::memcpy(pixelRow(5, r*10), pixelRow(3, r*10), rowBytes);
+
+		renderRow(r, 1);
+		renderRow(r, 2);
+		renderRow(r, 4);
+		renderRow(r, 5);
 	}
 }
 
@@ -450,20 +545,7 @@ void TeletextPageRender::setRowFlashStatus(int r, int rowFlashHz)
 
 void TeletextPageRender::colourChanged(int index)
 {
-	for (int r=0; r<25; r++)
-		for (int c=0; c<72; c++) {
-			if (m_decoder->cellForegroundCLUT(r, c) == index || m_decoder->cellBackgroundCLUT(r, c) == index || m_decoder->cellForegroundCLUT(r, c) == 8 || m_decoder->cellBackgroundCLUT(r, c) == 8)
-				m_decoder->setRefresh(r, c, true);
-			if (m_decoder->cellFlashMode(r, c) == 3 && ((m_decoder->cellForegroundCLUT(r, c) ^ 8) == index || (m_decoder->cellForegroundCLUT(r, c) ^ 8) == 8))
-				m_decoder->setRefresh(r, c, true);
-		}
-
-	if (m_decoder->level() == 3)
-		// TODO don't refresh mode 0 DRCS
-		for (int r=0; r<25; r++)
-			for (int c=0; c<72; c++)
-				if (m_decoder->cellDrcsSource(r, c) != TeletextPageDecode::NoDRCS)
-					m_decoder->setRefresh(r, c, true);
+	m_decoder->setCLUTRefresh(index);
 }
 
 void TeletextPageRender::setReveal(bool reveal)
@@ -26,6 +26,9 @@
 #include <QImage>
 #include <QPixmap>
 
+#include <atomic>
+#include <functional>
+
 #include "decode.h"
 
 class TeletextFontBitmap
@@ -34,14 +37,23 @@ public:
 	TeletextFontBitmap();
 	~TeletextFontBitmap();
 
-	QImage *image() const { return s_fontImage; }
-	QPixmap charBitmap(int c, int s) const { return s_fontBitmap->copy((c-32)*12, s*10, 12, 10); }
+	QImage *image() const { return fontImage(); }
+	QPixmap charBitmap(int c, int s) const { return fontBitmap()->copy((c-32)*12, s*10, 12, 10); }
 	QIcon charIcon(int c, int s) const { return QIcon(charBitmap(c, s)); }
+	// One row of a glyph as a 12 bit mask, bit 0 being the leftmost pixel
+	quint16 glyphRow(int c, int s, int y) const { return s_glyphRows[s][c-32][y]; }
 
 private:
-	static int s_instances;
+	// Only created when glyphs are wanted as images or pixmaps, pages are rendered from the glyph rows
+	static QImage *fontImage();
+	// Only created when glyphs are wanted as pixmaps, so that pages can be rendered without a GUI
+	static QBitmap *fontBitmap();
+
+	static std::atomic<int> s_instances;
 	static QBitmap* s_fontBitmap;
 	static QImage* s_fontImage;
+	// Generated at build time from fontimages/teletextfont.png
+	static const quint16 s_glyphRows[27][96][10];
 };
 
 class TeletextPageRender : public QObject
@@ -56,6 +68,8 @@ public:
 
 	QImage* image(int i) const { return m_pageImage[i]; };
 	RenderMode renderMode() const { return m_renderMode; };
+	int flashHz() const { return m_flashBuffersHz; };
+	bool reveal() const { return m_reveal; };
 	void setDecoder(TeletextPageDecode *decoder);
 	void renderPage(bool force=false);
 	bool showControlCodes() const { return m_showControlCodes; };
@@ -79,15 +93,25 @@ protected:
 	int m_flashingRow[25];
 
 private:
-	inline void drawFromBitmap(QPainter &painter, int r, int c, const QImage image, TeletextPageDecode::CharacterFragment characterFragment);
-	inline void drawFromFontBitmap(QPainter &painter, int r, int c, unsigned char characterCode, int characterSet, TeletextPageDecode::CharacterFragment characterFragment);
-	inline void drawCharacter(QPainter &painter, int r, int c, unsigned char characterCode, int characterSet, int characterDiacritical, TeletextPageDecode::CharacterFragment characterFragment);
-	inline bool drawDRCSCharacter(QPainter &painter, int r, int c, TeletextPageDecode::DRCSSource drcsSource, int drcsSubTable, int drcsChar, TeletextPageDecode::CharacterFragment characterFragment, bool flashPhOn = true);
-	inline void drawBoldOrItalicCharacter(QPainter &painter, int r, int c, unsigned char characterCode, int characterSet, TeletextPageDecode::CharacterFragment characterFragment);
-	void renderRow(int r, int ph, bool force=false);
+	// Rows are drawn straight into the scanlines of the page images without QPainter
+	// so that they can be drawn on several threads at once
+	QRgb *pixelRow(int ph, int y) const { return m_pagePixels[ph] + y*m_pageStride; }
+	void lockPageImages();
+	void forEachRow(bool parallel, const std::function<void(int)> &rowFunction);
+
+	inline void fillCell(int ph, int r, int c, QRgb colour);
+	inline void drawFromMask(int ph, int r, int c, const quint16 mask[10], QRgb foreground, QRgb background, TeletextPageDecode::CharacterFragment characterFragment);
+	inline void overlayFromMask(int ph, int r, int c, const quint16 mask[10], QRgb foreground, TeletextPageDecode::CharacterFragment characterFragment);
+	inline void drawFromBitmap(int ph, int r, int c, const QImage &image, TeletextPageDecode::CharacterFragment characterFragment);
+	inline void drawCharacter(int ph, int r, int c, unsigned char characterCode, int characterSet, int characterDiacritical, TeletextPageDecode::CharacterFragment characterFragment, QRgb foreground, QRgb background);
+	inline bool drawDRCSCharacter(int ph, int r, int c, TeletextPageDecode::DRCSSource drcsSource, int drcsSubTable, int drcsChar, TeletextPageDecode::CharacterFragment characterFragment, QRgb foreground, QRgb background, bool flashPhOn = true);
+	inline void drawControlCode(int ph, int r, int c, unsigned char controlCode);
+	bool renderRow(int r, int ph, bool force=false, int *flashingRow=nullptr);
+	void renderFlashRow(int r);
 	void setRowFlashStatus(int r, int rowFlashHz);
 
-	QColor m_foregroundQColor, m_backgroundQColor;
+	QRgb *m_pagePixels[6];
+	int m_pageStride;
 	TeletextPageDecode *m_decoder;
 };
 
@@ -17,8 +17,12 @@
  * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <QAtomicInteger>
+
 #include "x26triplets.h"
 
+QAtomicInteger<quint64> X26TripletList::s_lastGeneration = 0;
+
 X26Triplet::X26Triplet(int address, int mode, int data)
 {
 	m_address = address;
@@ -368,12 +372,14 @@ void X26TripletList::append(const X26Triplet &value)
 {
 	m_list.append(value);
 	updateInternalData();
+	newGeneration();
 }
 
 void X26TripletList::insert(int i, const X26Triplet &value)
 {
 	m_list.insert(i, value);
 	updateInternalData();
+	newGeneration();
 }
 
 void X26TripletList::removeAt(int i)
@@ -381,17 +387,26 @@ void X26TripletList::removeAt(int i)
 	m_list.removeAt(i);
 	if (m_list.size() != 0 && i < m_list.size())
 		updateInternalData();
+	newGeneration();
 }
 
 void X26TripletList::replace(int i, const X26Triplet &value)
 {
 	m_list.replace(i, value);
 	updateInternalData();
+	newGeneration();
 }
 
 void X26TripletList::removeLast()
 {
 	m_list.removeLast();
+	newGeneration();
+}
+
+void X26TripletList::newGeneration()
+{
+	// Shared by all lists so a list overwritten by another never ends up on the same generation
+	m_generation = s_lastGeneration.fetchAndAddRelaxed(1) + 1;
 }
 
 const X26Triplet &X26TripletList::at(int i) const
@@ -20,6 +20,7 @@
 #ifndef X26TRIPLETS_H
 #define X26TRIPLETS_H
 
+#include <QAtomicInteger>
 #include <QList>
 
 class X26Triplet
@@ -100,12 +101,18 @@ public:
 	int size() const;
 
 	const QList<int> &objects(int t) const;
+	// Changes whenever the list is changed, and is never the same for two different lists
+	// unless one is a copy of the other, so views can tell when their cached data is stale
+	quint64 generation() const { return m_generation; }
 
 private:
 	void updateInternalData();
+	void newGeneration();
 
 	QList<X26Triplet> m_list;
 	QList<int> m_objects[3];
+	quint64 m_generation = 0;
+	static QAtomicInteger<quint64> s_lastGeneration;
 
 	class ActivePosition
 	{
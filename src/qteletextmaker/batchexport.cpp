@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVariant>
+
+#include <iostream>
+#include <memory>
+
+#include "batchexport.h"
+
+#include "document.h"
+#include "gifwriter.h"
+#include "loadformats.h"
+#include "offscreenrender.h"
+#include "saveformats.h"
+
+BatchExport::BatchExport(const QString &outputDirectory, const QString &format)
+{
+	m_outputDirectory.setPath(outputDirectory);
+	m_format = format.toLower();
+	m_renderOptions.scale = 1;
+	m_carousel = false;
+	m_cycleTime = TeletextDocument::DefaultCycleTime;
+	m_threadCount = 0;
+}
+
+int BatchExport::run(const QStringList &inputs)
+{
+	m_error.clear();
+
+	if (m_format != "png" && m_format != "gif" && m_saveFormats.findExportFormat(m_format) == nullptr) {
+		m_error = QString("Cannot export to format %1").arg(m_format);
+		return ExitUsageError;
+	}
+
+	if (!m_outputDirectory.mkpath(".")) {
+		m_error = QString("Cannot create output directory %1").arg(QDir::toNativeSeparators(m_outputDirectory.path()));
+		return ExitUsageError;
+	}
+
+	const QStringList files = expandInputs(inputs);
+
+	if (files.isEmpty()) {
+		m_error = QString("No input files");
+		return ExitUsageError;
+	}
+
+	// Each file is exported on its own thread with its own document, formats and renderer
+	// Any thread left over is used by the renderer to draw rows in parallel
+	// Keep a renderer alive here so the shared font and decoder tables are set up once
+	// before the threads start, rather than by whichever thread gets there first
+	const TeletextOffscreenRender sharedTablesHolder;
+	QThreadPool *threadPool = QThreadPool::globalInstance();
+	QList<exportResult> results(files.size());
+
+	if (m_threadCount > 0)
+		threadPool->setMaxThreadCount(m_threadCount);
+
+	for (int i=0; i<files.size(); i++)
+		threadPool->start([this, &files, &results, i]() { results[i] = exportFile(files.at(i)); });
+
+	threadPool->waitForDone();
+
+	int failures = 0;
+
+	for (int i=0; i<files.size(); i++)
+		if (!results.at(i).error.isEmpty()) {
+			std::cerr << qPrintable(QDir::toNativeSeparators(files.at(i))) << ": " << qPrintable(results.at(i).error) << std::endl;
+			failures++;
+		} else
+			for (const QString &outputFile : results.at(i).outputFiles)
+				std::cout << qPrintable(QDir::toNativeSeparators(files.at(i))) << " -> " << qPrintable(QDir::toNativeSeparators(outputFile)) << std::endl;
+
+	if (failures != 0) {
+		std::cerr << failures << " of " << files.size() << " files could not be exported" << std::endl;
+		return ExitFileErrors;
+	}
+
+	return ExitSuccess;
+}
+
+// Directories are expanded to every loadable file within them, and wildcards are expanded
+// here too for shells that don't do it themselves
+QStringList BatchExport::expandInputs(const QStringList &inputs) const
+{
+	QStringList result;
+
+	for (const QString &input : inputs) {
+		const QFileInfo inputInfo(input);
+
+		if (inputInfo.isDir()) {
+			const QFileInfoList entries = QDir(input).entryInfoList(QDir::Files, QDir::Name);
+
+			for (const QFileInfo &entry : entries)
+				if (m_loadFormats.findFormat(entry.suffix()) != nullptr)
+					result.append(entry.filePath());
+		} else if (!inputInfo.exists() && input.contains(QRegularExpression("[*?[]"))) {
+			const QFileInfoList entries = QDir(inputInfo.path()).entryInfoList(QStringList { inputInfo.fileName() }, QDir::Files, QDir::Name);
+
+			for (const QFileInfo &entry : entries)
+				result.append(entry.filePath());
+		} else
+			result.append(input);
+	}
+
+	return result;
+}
+
+BatchExport::exportResult BatchExport::exportFile(const QString &fileName) const
+{
+	exportResult result;
+	TeletextDocument document;
+
+	if (!loadDocument(fileName, document, result.error))
+		return result;
+
+	if (m_format == "png" || m_format == "gif")
+		exportImages(fileName, document, result);
+	else
+		exportPackets(fileName, document, result);
+
+	return result;
+}
+
+bool BatchExport::loadDocument(const QString &fileName, TeletextDocument &document, QString &error) const
+{
+	// The formats held by LoadFormats are shared, so this thread needs one of its own
+	std::unique_ptr<LoadFormat> loadingFormat(m_loadFormats.createFormat(QFileInfo(fileName).suffix()));
+
+	if (loadingFormat == nullptr) {
+		error = QString("Unknown file format or extension");
+		return false;
+	}
+
+	QFile file(fileName);
+
+	if (!file.open(QFile::ReadOnly)) {
+		error = file.errorString();
+		return false;
+	}
+
+	QList<PageBase> subPages;
+	QVariantHash metadata;
+
+	if (!loadingFormat->load(&file, subPages, &metadata)) {
+		error = loadingFormat->errorString();
+		return false;
+	}
+
+	document.loadFromList(subPages);
+	document.loadMetaData(metadata);
+
+	return true;
+}
+
+// Subpages go in separate files numbered from 1, unless there is only one
+QString BatchExport::outputFileName(const QString &fileName, const TeletextDocument &document, int subPageIndex) const
+{
+	QString baseName = QFileInfo(fileName).completeBaseName();
+
+	if (subPageIndex >= 0 && document.numberOfSubPages() > 1)
+		baseName.append(QString("-%1").arg(subPageIndex+1, 2, 10, QChar('0')));
+
+	return m_outputDirectory.filePath(baseName + '.' + m_format);
+}
+
+bool BatchExport::exportImages(const QString &fileName, TeletextDocument &document, exportResult &result) const
+{
+	TeletextOffscreenRender offscreenRender;
+	TeletextOffscreenRender::Options options = m_renderOptions;
+
+	options.level = document.levelRequired();
+
+	// The whole carousel goes into one animation, streamed out a subpage at a time
+	if (m_format == "gif" && m_carousel) {
+		const QString outputFile = outputFileName(fileName, document, -1);
+
+		offscreenRender.setTeletextPage(document.subPage(0));
+
+		DeltaGifWriter gif(offscreenRender, options);
+
+		if (gif.open(outputFile)) {
+			gif.addCarouselFrames(offscreenRender, options, document, m_cycleTime);
+			if (gif.close()) {
+				result.outputFiles.append(outputFile);
+				return true;
+			}
+		}
+
+		result.error = QString("Cannot write image %1: %2").arg(QDir::toNativeSeparators(outputFile), gif.errorString());
+		return false;
+	}
+
+	for (int p=0; p<document.numberOfSubPages(); p++) {
+		const QString outputFile = outputFileName(fileName, document, p);
+		bool saved;
+
+		offscreenRender.setTeletextPage(document.subPage(p));
+
+		if (m_format == "gif") {
+			DeltaGifWriter gif(offscreenRender, options);
+
+			saved = gif.open(outputFile);
+			if (saved) {
+				gif.addPageFrames(offscreenRender, options);
+				saved = gif.close();
+			}
+		} else
+			saved = offscreenRender.image(options).save(outputFile, "PNG");
+
+		if (!saved) {
+			result.error = QString("Cannot write image %1").arg(QDir::toNativeSeparators(outputFile));
+			return false;
+		}
+
+		result.outputFiles.append(outputFile);
+	}
+
+	return true;
+}
+
+bool BatchExport::exportPackets(const QString &fileName, TeletextDocument &document, exportResult &result) const
+{
+	std::unique_ptr<SaveFormat> exportFormat(m_saveFormats.createExportFormat(m_format));
+	// Native formats hold the whole document, export formats hold one subpage per file as in the GUI
+	const bool allSubPages = !m_saveFormats.isExportOnly(m_format);
+
+	for (int p=0; p<document.numberOfSubPages(); p++) {
+		const QString outputFile = outputFileName(fileName, document, allSubPages ? -1 : p);
+		QSaveFile file(outputFile);
+
+		if (!file.open(QFile::WriteOnly)) {
+			result.error = QString("Cannot open file %1 for writing: %2").arg(QDir::toNativeSeparators(outputFile), file.errorString());
+			return false;
+		}
+
+		if (allSubPages)
+			exportFormat->saveAllPages(file, document);
+		else {
+			document.selectSubPageIndex(p);
+			exportFormat->saveCurrentSubPage(file, document);
+		}
+
+		if (!exportFormat->errorString().isEmpty()) {
+			result.error = exportFormat->errorString();
+			return false;
+		}
+		if (!file.commit()) {
+			result.error = QString("Cannot write file %1: %2").arg(QDir::toNativeSeparators(outputFile), file.errorString());
+			return false;
+		}
+
+		result.outputFiles.append(outputFile);
+
+		if (allSubPages)
+			break;
+	}
+
+	return true;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BATCHEXPORT_H
+#define BATCHEXPORT_H
+
+#include <QDir>
+#include <QString>
+#include <QStringList>
+
+#include "document.h"
+#include "loadformats.h"
+#include "offscreenrender.h"
+#include "saveformats.h"
+
+// Converts files to images or other packet formats from the command line, without any GUI
+class BatchExport
+{
+public:
+	enum ExitCode { ExitSuccess, ExitFileErrors, ExitUsageError };
+
+	BatchExport(const QString &outputDirectory, const QString &format);
+
+	// Level is taken from each document
+	void setRenderOptions(const TeletextOffscreenRender::Options &options) { m_renderOptions = options; };
+	// GIF exports put all the subpages of a file into one animation
+	void setCarousel(bool carousel) { m_carousel = carousel; };
+	// Milliseconds for each cycle of subpages timed in cycles in a carousel
+	void setCycleTime(int cycleTime) { m_cycleTime = cycleTime; };
+	void setThreadCount(int threadCount) { m_threadCount = threadCount; };
+
+	int run(const QStringList &inputs);
+	QString errorString() const { return m_error; };
+
+private:
+	struct exportResult {
+		QStringList outputFiles;
+		QString error;
+	};
+
+	QStringList expandInputs(const QStringList &inputs) const;
+	exportResult exportFile(const QString &fileName) const;
+	bool loadDocument(const QString &fileName, TeletextDocument &document, QString &error) const;
+	QString outputFileName(const QString &fileName, const TeletextDocument &document, int subPageIndex) const;
+	bool exportImages(const QString &fileName, TeletextDocument &document, exportResult &result) const;
+	bool exportPackets(const QString &fileName, TeletextDocument &document, exportResult &result) const;
+
+	QDir m_outputDirectory;
+	QString m_format;
+	TeletextOffscreenRender::Options m_renderOptions;
+	bool m_carousel;
+	int m_cycleTime;
+	int m_threadCount;
+	QString m_error;
+
+	LoadFormats m_loadFormats;
+	SaveFormats m_saveFormats;
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "document.h"
 
 #include "levelonepage.h"
+#include "undohistory.h"
 
 ClutModel::ClutModel(QObject *parent): QAbstractListModel(parent)
 {
@@ -64,7 +65,7 @@ TeletextDocument::TeletextDocument()
 	m_description.clear();
 	m_subPages.append(new LevelOnePage);
 	m_currentSubPageIndex = 0;
-	m_undoStack = new QUndoStack(this);
+	m_undoStack = new UndoHistory(this);
 	m_cursorRow = 1;
 	m_cursorColumn = 0;
 	m_rowZeroAllowed = false;
@@ -104,6 +105,10 @@ void TeletextDocument::clear()
 	emit subPageSelected();
 	cancelSelection();
 	m_undoStack->clear();
+	// Nothing can undelete these any more
+	for (auto &recycleSubPage : m_recycleSubPages)
+		delete(recycleSubPage);
+	m_recycleSubPages.clear();
 
 	for (int i=m_subPages.size()-1; i>0; i--) {
 		delete(m_subPages[i]);
@@ -187,6 +192,12 @@ void TeletextDocument::unDeleteSubPageFromRecycle(int subPage)
 	m_recycleSubPages.removeLast();
 }
 
+void TeletextDocument::discardOldestRecycledSubPage()
+{
+	if (!m_recycleSubPages.isEmpty())
+		delete(m_recycleSubPages.takeFirst());
+}
+
 void TeletextDocument::loadFromList(QList<PageBase> const &subPageList)
 {
 	*m_subPages[0] = subPageList.at(0);
@@ -417,3 +428,14 @@ int TeletextDocument::levelRequired() const
 
 	return levelSeen;
 }
+
+int TeletextDocument::cycleDuration(int subPageIndex, int cycleTime) const
+{
+	const LevelOnePage *subPage = m_subPages.at(subPageIndex);
+	const int cycleValue = qMax(subPage->cycleValue(), 1);
+
+	if (subPage->cycleType() == LevelOnePage::CTseconds)
+		return cycleValue * 1000;
+
+	return cycleValue * qMax(cycleTime, 1);
+}
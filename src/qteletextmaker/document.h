@@ -23,10 +23,10 @@
 #include <QAbstractListModel>
 #include <QList>
 #include <QObject>
-#include <QUndoStack>
 #include <QVariant>
 
 #include "levelonepage.h"
+#include "undohistory.h"
 
 class ClutModel : public QAbstractListModel
 {
@@ -65,6 +65,8 @@ public:
 	void deleteSubPage(int subPageToDelete);
 	void deleteSubPageToRecycle(int subPageToRecycle);
 	void unDeleteSubPageFromRecycle(int subPage);
+	// Frees the subpage deleted longest ago, once it can no longer be undeleted
+	void discardOldestRecycledSubPage();
 	void loadFromList(QList<PageBase> const &subPageList);
 	void loadMetaData(QVariantHash const &metadata);
 	int pageNumber() const { return m_pageNumber; }
@@ -73,7 +75,7 @@ public:
 	QString description() const { return m_description; }
 	void setDescription(QString newDescription);
 	void setFastTextLinkPageNumberOnAllSubPages(int linkNumber, int pageNumber);
-	QUndoStack *undoStack() const { return m_undoStack; }
+	UndoHistory *undoStack() const { return m_undoStack; }
 	ClutModel *clutModel() const { return m_clutModel; }
 	int cursorRow() const { return m_cursorRow; }
 	int cursorColumn() const { return m_cursorColumn; }
@@ -97,6 +99,12 @@ public:
 	void setSelection(int topRow, int leftColumn, int bottomRow, int rightColumn);
 	void cancelSelection();
 	int levelRequired() const;
+	// Milliseconds each cycle of a page timed in cycles is counted as when the carousel is played.
+	// A cycle is one transmission of the whole magazine, so it depends on the rest of the service.
+	static constexpr int DefaultCycleTime = 1000;
+	// How long a subpage is shown for in milliseconds when the carousel is played.
+	// Pages timed in seconds are exact, pages timed in cycles take cycleTime for each one.
+	int cycleDuration(int subPageIndex, int cycleTime=DefaultCycleTime) const;
 
 signals:
 	void cursorMoved();
@@ -115,7 +123,7 @@ private:
 	int m_pageNumber, m_currentSubPageIndex;
 	QList<LevelOnePage *> m_subPages;
 	QList<LevelOnePage *> m_recycleSubPages;
-	QUndoStack *m_undoStack;
+	UndoHistory *m_undoStack;
 	int m_cursorRow, m_cursorColumn, m_selectionCornerRow, m_selectionCornerColumn;
 	bool m_rowZeroAllowed;
 	LevelOnePage *m_selectionSubPage;
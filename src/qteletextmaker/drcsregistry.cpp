@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+#include "drcsregistry.h"
+
+#include "drcspage.h"
+#include "loadformats.h"
+#include "pagebase.h"
+
+QSharedPointer<const DRCSPageSet> DRCSRegistry::load(QFile *file, LoadFormat *loadFormat)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+
+	hash.addData(loadFormat->description().toUtf8());
+	// If the file can't be read through, it's left to the format to load it and report why it can't
+	const bool hashed = hash.addData(file);
+	const QByteArray key = hashed ? hash.result() : QByteArray();
+
+	file->seek(0);
+	dropExpired();
+
+	QSharedPointer<const DRCSPageSet> pageSet = s_pageSets.value(key).toStrongRef();
+
+	if (pageSet)
+		return pageSet;
+
+	QList<PageBase> loadedPages;
+
+	if (!loadFormat->load(file, loadedPages, nullptr))
+		return QSharedPointer<const DRCSPageSet>();
+
+	pageSet = QSharedPointer<const DRCSPageSet>(new DRCSPageSet(loadedPages));
+	if (hashed)
+		s_pageSets.insert(key, pageSet);
+
+	return pageSet;
+}
+
+void DRCSRegistry::dropExpired()
+{
+	for (auto it = s_pageSets.begin(); it != s_pageSets.end(); )
+		if (it.value().isNull())
+			it = s_pageSets.erase(it);
+		else
+			++it;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DRCSREGISTRY_H
+#define DRCSREGISTRY_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+#include "drcspage.h"
+#include "loadformats.h"
+
+// DRCS page sets loaded from files, shared between all the windows that have the same content loaded.
+// Sets are keyed by a hash of the file contents and the format they were loaded with, so the same
+// file loaded into many windows is parsed and its glyphs decoded only once. A set is freed when the
+// last window using it lets go of it.
+class DRCSRegistry
+{
+public:
+	// Null if the file can't be read or loaded, the error being in loadFormat->errorString()
+	static QSharedPointer<const DRCSPageSet> load(QFile *file, LoadFormat *loadFormat);
+
+private:
+	static void dropExpired();
+
+	inline static QHash<QByteArray, QWeakPointer<const DRCSPageSet>> s_pageSets;
+};
+
+#endif
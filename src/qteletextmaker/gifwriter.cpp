@@ -0,0 +1,493 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QImage>
+#include <QList>
+#include <QPoint>
+#include <QRect>
+#include <QSaveFile>
+#include <QSize>
+#include <QString>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "gifwriter.h"
+
+#include "document.h"
+#include "offscreenrender.h"
+
+#include "giflib/gif_lib.h"
+
+static int writeToSaveFile(GifFileType *gifFile, const GifByteType *data, int length)
+{
+	return static_cast<int>(static_cast<QSaveFile *>(gifFile->UserData)->write(reinterpret_cast<const char *>(data), length));
+}
+
+DeltaGifWriter::DeltaGifWriter(const QList<QRgb> &colourTable, int transparentIndex)
+{
+	m_colourTable = colourTable;
+	m_transparentIndex = transparentIndex;
+	m_gifFile = nullptr;
+	m_headerWritten = false;
+	m_elapsed = 0;
+}
+
+DeltaGifWriter::DeltaGifWriter(TeletextOffscreenRender &offscreenRender, const TeletextOffscreenRender::Options &options)
+{
+	m_colourTable = offscreenRender.colourTable(options);
+
+	// A GIF has no alpha, instead one colour is picked to be transparent
+	// CLUT colours are always multiples of 17 so this can't clash with a real colour
+	// Monochrome renders have no transparent colour, but one is still needed to mask
+	// out the unchanged pixels of flash frames
+	if (m_colourTable.size() > TeletextOffscreenRender::TransparentIndex)
+		m_colourTable[TeletextOffscreenRender::TransparentIndex] = qRgb(1, 1, 1);
+	else
+		m_colourTable.append(qRgb(1, 1, 1));
+
+	m_transparentIndex = m_colourTable.indexOf(qRgb(1, 1, 1));
+	m_gifFile = nullptr;
+	m_headerWritten = false;
+	m_elapsed = 0;
+}
+
+DeltaGifWriter::~DeltaGifWriter()
+{
+	// Abandon a file that wasn't closed
+	if (m_gifFile != nullptr) {
+		EGifCloseFile(m_gifFile);
+		m_file.cancelWriting();
+	}
+}
+
+bool DeltaGifWriter::open(const QString &fileName)
+{
+	m_file.setFileName(fileName);
+
+	if (!m_file.open(QIODevice::WriteOnly)) {
+		m_error = m_file.errorString();
+		return false;
+	}
+
+	int error;
+
+	m_gifFile = EGifOpen(&m_file, writeToSaveFile, &error);
+	if (m_gifFile == nullptr) {
+		m_error = GifErrorString(error);
+		m_file.cancelWriting();
+		return false;
+	}
+
+	// Graphics control and looping extensions need GIF89a
+	EGifSetGifVersion(m_gifFile, true);
+
+	m_headerWritten = false;
+	m_elapsed = 0;
+	m_error.clear();
+	m_canvasSize = QSize();
+	m_first = QImage();
+	m_previous = QImage();
+	m_pending.image = QImage();
+
+	return true;
+}
+
+void DeltaGifWriter::setCanvasSize(const QSize &size)
+{
+	if (m_pending.image.isNull())
+		m_canvasSize = size;
+}
+
+// Subpages with different side panels render to different widths, but the delta of each frame
+// is taken against the one before so they all have to be the size of the logical screen
+QImage DeltaGifWriter::canvasFrame(const QImage &frame) const
+{
+	if (frame.size() == m_canvasSize)
+		return frame;
+
+	QImage result(m_canvasSize, QImage::Format_Indexed8);
+
+	result.setColorTable(frame.colorTable());
+	result.fill(m_transparentIndex >= 0 ? m_transparentIndex : 0);
+
+	const int left = (m_canvasSize.width() - frame.width()) / 2;
+	const int top = (m_canvasSize.height() - frame.height()) / 2;
+	const QRect copyRect = QRect(QPoint(left, top), frame.size()) & result.rect();
+
+	for (int y=copyRect.top(); y<=copyRect.bottom(); y++)
+		std::memcpy(result.scanLine(y) + copyRect.left(), frame.constScanLine(y - top) + copyRect.left() - left, copyRect.width());
+
+	return result;
+}
+
+// Subpages can redefine CLUTs 2 and 3, so a frame rendered from a later subpage
+// may not match the colour table the writer started with
+QList<QRgb> DeltaGifWriter::frameColourTable(const QImage &frame) const
+{
+	QList<QRgb> result = frame.colorTable();
+
+	if (result.isEmpty())
+		return m_colourTable;
+
+	if (m_transparentIndex >= 0) {
+		if (result.size() <= m_transparentIndex)
+			result.resize(m_transparentIndex + 1);
+		result[m_transparentIndex] = m_colourTable.at(m_transparentIndex);
+	}
+
+	return result;
+}
+
+void DeltaGifWriter::addFrame(const QImage &addedFrame, int delay)
+{
+	if (m_gifFile == nullptr)
+		return;
+
+	if (m_canvasSize.isEmpty())
+		m_canvasSize = addedFrame.size();
+
+	const QImage frame = canvasFrame(addedFrame);
+	const QList<QRgb> colourTable = frameColourTable(frame);
+
+	if (m_pending.image.isNull()) {
+		m_pending = { frame, colourTable, delay, frame.rect(), false, DISPOSE_DO_NOT };
+		m_first = frame;
+		return;
+	}
+
+	const bool sameColours = colourTable == m_pending.colourTable;
+	gifFrame next = { frame, colourTable, delay, frame.rect(), false, DISPOSE_DO_NOT };
+
+	if (sameColours) {
+		next.rect = changedRect(m_pending.image, frame);
+
+		// Merge a frame identical to the one before by showing the earlier one for longer
+		if (next.rect.isNull()) {
+			m_pending.delay += delay;
+			return;
+		}
+
+		next.masked = true;
+	}
+
+	// A transparent pixel in a GIF frame shows whatever the previous frame left there,
+	// so a pixel that becomes transparent can't be expressed by drawing over the previous frame.
+	// Instead the previous frame is drawn whole and cleared away afterwards, then this frame is drawn whole.
+	if (uncoversPixels(m_pending.image, frame)) {
+		m_pending.rect = m_pending.image.rect();
+		m_pending.masked = false;
+		m_pending.disposal = DISPOSE_BACKGROUND;
+		next.rect = frame.rect();
+		next.masked = false;
+	}
+
+	// Now there is a second frame the file can be marked as animated
+	if (!m_headerWritten && !writeHeader(true))
+		return;
+	if (!writeFrame(m_pending))
+		return;
+
+	m_previous = m_pending.image;
+	m_pending = next;
+}
+
+void DeltaGifWriter::addPageFrames(TeletextOffscreenRender &offscreenRender, TeletextOffscreenRender::Options options, int duration)
+{
+	const int flashHz = offscreenRender.flashHz(options);
+
+	if (flashHz == 0) {
+		options.flashPhase = 0;
+		addFrame(offscreenRender.image(options, QImage::Format_Indexed8), duration);
+		return;
+	}
+
+	// Render each flash phase once, then repeat them for as long as the page is shown
+	QList<QImage> phaseImages;
+
+	if (flashHz == 1) {
+		options.flashPhase = 0;
+		phaseImages.append(offscreenRender.image(options, QImage::Format_Indexed8));
+		options.flashPhase = 3;
+		phaseImages.append(offscreenRender.image(options, QImage::Format_Indexed8));
+	} else
+		for (int p=0; p<6; p++) {
+			options.flashPhase = p;
+			phaseImages.append(offscreenRender.image(options, QImage::Format_Indexed8));
+		}
+
+	int elapsed = 0;
+	int p = 0;
+
+	do {
+		int delay = (flashHz == 1) ? 500 : ((p % 3 == 0) ? 166 : 167);
+
+		// Cut the last phase short at the end of the page's time
+		if (duration > 0)
+			delay = std::min(delay, duration - elapsed);
+
+		addFrame(phaseImages.at(p), delay);
+		elapsed += delay;
+		p = (p + 1) % phaseImages.size();
+	} while (duration > 0 ? elapsed < duration : p != 0);
+}
+
+void DeltaGifWriter::addCarouselFrames(TeletextOffscreenRender &offscreenRender, const TeletextOffscreenRender::Options &options, const TeletextDocument &document, int cycleTime)
+{
+	// A single subpage isn't a carousel, so just cycle its flashing
+	if (document.numberOfSubPages() == 1) {
+		offscreenRender.setTeletextPage(document.subPage(0));
+		addPageFrames(offscreenRender, options);
+		return;
+	}
+
+	// The logical screen has to fit the widest subpage
+	QSize canvasSize;
+
+	for (int p=0; p<document.numberOfSubPages(); p++) {
+		offscreenRender.setTeletextPage(document.subPage(p));
+		canvasSize = canvasSize.expandedTo(offscreenRender.size(options));
+	}
+	setCanvasSize(canvasSize);
+
+	for (int p=0; p<document.numberOfSubPages(); p++) {
+		offscreenRender.setTeletextPage(document.subPage(p));
+		addPageFrames(offscreenRender, options, document.cycleDuration(p, cycleTime));
+	}
+}
+
+bool DeltaGifWriter::close()
+{
+	if (m_gifFile == nullptr)
+		return false;
+
+	if (m_pending.image.isNull()) {
+		m_error = QString("No frames to write");
+		EGifCloseFile(m_gifFile);
+		m_gifFile = nullptr;
+		m_file.cancelWriting();
+		return false;
+	}
+
+	if (!m_headerWritten) {
+		// A single frame is a still image
+		m_pending.delay = 0;
+		if (!writeHeader(false))
+			return false;
+	} else if (uncoversPixels(m_pending.image, m_first)) {
+		// The animation loops back to the first frame, which is drawn over the last one
+		m_pending.rect = m_pending.image.rect();
+		m_pending.masked = false;
+		m_pending.disposal = DISPOSE_BACKGROUND;
+	}
+
+	if (!writeFrame(m_pending))
+		return false;
+
+	if (EGifCloseFile(m_gifFile) == GIF_ERROR) {
+		m_gifFile = nullptr;
+		m_error = QString("Cannot write GIF file");
+		m_file.cancelWriting();
+		return false;
+	}
+
+	m_gifFile = nullptr;
+	m_first = QImage();
+	m_previous = QImage();
+	m_pending.image = QImage();
+
+	if (!m_file.commit()) {
+		m_error = m_file.errorString();
+		return false;
+	}
+
+	return true;
+}
+
+bool DeltaGifWriter::uncoversPixels(const QImage &previous, const QImage &current) const
+{
+	if (m_transparentIndex < 0)
+		return false;
+
+	for (int y=0; y<current.height(); y++) {
+		const uchar *previousLine = previous.constScanLine(y);
+		const uchar *currentLine = current.constScanLine(y);
+
+		for (int x=0; x<current.width(); x++)
+			if (currentLine[x] == m_transparentIndex && previousLine[x] != m_transparentIndex)
+				return true;
+	}
+
+	return false;
+}
+
+QRect DeltaGifWriter::changedRect(const QImage &previous, const QImage &current)
+{
+	int top = -1, bottom = -1, left = current.width(), right = -1;
+
+	for (int y=0; y<current.height(); y++) {
+		const uchar *previousLine = previous.constScanLine(y);
+		const uchar *currentLine = current.constScanLine(y);
+
+		if (std::memcmp(previousLine, currentLine, current.width()) == 0)
+			continue;
+
+		if (top == -1)
+			top = y;
+		bottom = y;
+
+		int x = 0;
+
+		while (x < left && previousLine[x] == currentLine[x])
+			x++;
+		left = x;
+
+		x = current.width() - 1;
+		while (x > right && previousLine[x] == currentLine[x])
+			x--;
+		right = x;
+	}
+
+	if (top == -1)
+		return QRect();
+
+	return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+ColorMapObject *DeltaGifWriter::colourMap(const QList<QRgb> &colourTable)
+{
+	// GIF colour maps must be a power of two in size, the unused entries are left black
+	int mapSize = 2;
+
+	while (mapSize < colourTable.size())
+		mapSize *= 2;
+
+	ColorMapObject *result = GifMakeMapObject(mapSize, nullptr);
+
+	if (result == nullptr)
+		return nullptr;
+
+	for (int i=0; i<colourTable.size(); i++) {
+		result->Colors[i].Red = qRed(colourTable.at(i));
+		result->Colors[i].Green = qGreen(colourTable.at(i));
+		result->Colors[i].Blue = qBlue(colourTable.at(i));
+	}
+
+	return result;
+}
+
+bool DeltaGifWriter::writeHeader(bool animated)
+{
+	ColorMapObject *globalColourMap = colourMap(m_colourTable);
+	bool written = globalColourMap != nullptr && EGifPutScreenDesc(m_gifFile, m_canvasSize.width(), m_canvasSize.height(), 8, 0, globalColourMap) != GIF_ERROR;
+
+	GifFreeMapObject(globalColourMap);
+
+	if (written && animated) {
+		// Loop forever
+		static const GifByteType loopCount[3] = { 1, 0, 0 };
+
+		written = EGifPutExtensionLeader(m_gifFile, APPLICATION_EXT_FUNC_CODE) != GIF_ERROR &&
+			EGifPutExtensionBlock(m_gifFile, 11, "NETSCAPE2.0") != GIF_ERROR &&
+			EGifPutExtensionBlock(m_gifFile, 3, loopCount) != GIF_ERROR &&
+			EGifPutExtensionTrailer(m_gifFile) != GIF_ERROR;
+	}
+
+	if (!written) {
+		writeFailed();
+		return false;
+	}
+
+	m_headerWritten = true;
+	return true;
+}
+
+bool DeltaGifWriter::writeFrame(const gifFrame &frame)
+{
+	// Delays are in hundredths of a second, so round the running total rather than
+	// each frame to keep flash and cycle timings from drifting
+	GraphicsControlBlock controlBlock;
+	GifByteType controlExtension[4];
+
+	controlBlock.DisposalMode = frame.disposal;
+	controlBlock.UserInputFlag = false;
+	controlBlock.DelayTime = (m_elapsed + frame.delay + 5) / 10 - (m_elapsed + 5) / 10;
+	controlBlock.TransparentColor = m_transparentIndex >= 0 ? m_transparentIndex : NO_TRANSPARENT_COLOR;
+	m_elapsed += frame.delay;
+
+	const size_t controlLength = EGifGCBToExtension(&controlBlock, controlExtension);
+
+	if (EGifPutExtension(m_gifFile, GRAPHICS_EXT_FUNC_CODE, static_cast<int>(controlLength), controlExtension) == GIF_ERROR) {
+		writeFailed();
+		return false;
+	}
+
+	ColorMapObject *localColourMap = nullptr;
+
+	if (frame.colourTable != m_colourTable)
+		localColourMap = colourMap(frame.colourTable);
+
+	const QRect &rect = frame.rect;
+	const bool described = EGifPutImageDesc(m_gifFile, rect.left(), rect.top(), rect.width(), rect.height(), false, localColourMap) != GIF_ERROR;
+
+	GifFreeMapObject(localColourMap);
+	// This version of giflib keeps its own copy of a local colour map without freeing it
+	if (m_gifFile->Image.ColorMap != nullptr) {
+		GifFreeMapObject(m_gifFile->Image.ColorMap);
+		m_gifFile->Image.ColorMap = nullptr;
+	}
+
+	if (!described) {
+		writeFailed();
+		return false;
+	}
+
+	// giflib masks the pixels of the line in place, so each line is copied out of the image first
+	std::vector<GifPixelType> line(rect.width());
+
+	for (int y=rect.top(); y<=rect.bottom(); y++) {
+		const uchar *currentLine = frame.image.constScanLine(y) + rect.left();
+
+		std::memcpy(line.data(), currentLine, rect.width());
+
+		if (frame.masked) {
+			const uchar *previousLine = m_previous.constScanLine(y) + rect.left();
+
+			for (int x=0; x<rect.width(); x++)
+				if (previousLine[x] == currentLine[x])
+					line[x] = m_transparentIndex;
+		}
+
+		if (EGifPutLine(m_gifFile, line.data(), rect.width()) == GIF_ERROR) {
+			writeFailed();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void DeltaGifWriter::writeFailed()
+{
+	m_error = GifErrorString(m_gifFile->Error);
+	EGifCloseFile(m_gifFile);
+	m_gifFile = nullptr;
+	m_file.cancelWriting();
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GIFWRITER_H
+#define GIFWRITER_H
+
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QSaveFile>
+#include <QSize>
+#include <QString>
+
+#include "document.h"
+#include "offscreenrender.h"
+
+struct ColorMapObject;
+struct GifFileType;
+
+// Streams Indexed8 frames to an animated GIF as they are added.
+// After the first frame only the rectangle that changed from the previous frame is stored,
+// with unchanged pixels inside it masked out by the transparent index so they compress well.
+// Only the frame waiting to be written and the one before it are held, so a long carousel
+// doesn't need the whole animation in memory.
+class DeltaGifWriter
+{
+public:
+	DeltaGifWriter(const QList<QRgb> &colourTable, int transparentIndex);
+	// Colour table taken from the page's CLUT, plus a transparent colour
+	DeltaGifWriter(TeletextOffscreenRender &offscreenRender, const TeletextOffscreenRender::Options &options);
+	~DeltaGifWriter();
+
+	bool open(const QString &fileName);
+	// Size of every frame in the file, set before the first frame is added.
+	// Frames of another size are centred on it, left transparent around them or clipped.
+	// If not set the size of the first frame is used.
+	void setCanvasSize(const QSize &size);
+	// Frames that carry their own colour table, such as subpages with a different CLUT, get a local colour map
+	void addFrame(const QImage &frame, int delay);
+	// Adds the flash phases of a page repeated for duration milliseconds,
+	// or one cycle of them if duration is 0, or a still frame if it doesn't flash
+	void addPageFrames(TeletextOffscreenRender &offscreenRender, TeletextOffscreenRender::Options options, int duration=0);
+	// Adds every subpage in turn, each shown for its cycle time with cycleTime milliseconds for pages timed in cycles
+	void addCarouselFrames(TeletextOffscreenRender &offscreenRender, const TeletextOffscreenRender::Options &options, const TeletextDocument &document, int cycleTime=TeletextDocument::DefaultCycleTime);
+	bool close();
+	QString errorString() const { return m_error; }
+
+private:
+	struct gifFrame {
+		QImage image;
+		QList<QRgb> colourTable;
+		int delay;
+		QRect rect;
+		bool masked;
+		int disposal;
+	};
+
+	QList<QRgb> frameColourTable(const QImage &frame) const;
+	QImage canvasFrame(const QImage &frame) const;
+	bool uncoversPixels(const QImage &previous, const QImage &current) const;
+	static QRect changedRect(const QImage &previous, const QImage &current);
+	static ColorMapObject *colourMap(const QList<QRgb> &colourTable);
+	bool writeHeader(bool animated);
+	bool writeFrame(const gifFrame &frame);
+	void writeFailed();
+
+	QList<QRgb> m_colourTable;
+	int m_transparentIndex;
+
+	QSaveFile m_file;
+	GifFileType *m_gifFile;
+	bool m_headerWritten;
+	int m_elapsed;
+	QString m_error;
+
+	QSize m_canvasSize;
+	QImage m_first, m_previous;
+	gifFrame m_pending;
+};
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "hamming.h"
+
+// Parity works eight bytes at a time in a 64 bit word, folding each byte down into its lowest bit.
+// Shifting pulls bits in from the next byte along but only into bits that get masked off.
+static constexpr uint64_t s_lowBits = 0x0101010101010101ULL;
+static constexpr uint64_t s_sevenBits = 0x7f7f7f7f7f7f7f7fULL;
+
+static inline uint64_t parityBits(uint64_t word)
+{
+	word ^= word >> 4;
+	word ^= word >> 2;
+	word ^= word >> 1;
+
+	return word & s_lowBits;
+}
+
+void encodeOddParity(unsigned char *data, int length)
+{
+	int i = 0;
+
+	for (; i+8<=length; i+=8) {
+		uint64_t word;
+
+		std::memcpy(&word, data + i, 8);
+		word &= s_sevenBits;
+		// Set bit 7 of the bytes that have an even number of bits
+		word |= (parityBits(word) ^ s_lowBits) << 7;
+		std::memcpy(data + i, &word, 8);
+	}
+
+	for (; i<length; i++)
+		data[i] = oddParity(data[i]);
+}
+
+int decodeOddParity(unsigned char *data, int length)
+{
+	int errors = 0;
+	int i = 0;
+
+	for (; i+8<=length; i+=8) {
+		uint64_t word;
+
+		std::memcpy(&word, data + i, 8);
+		// Each byte of the failed bits is 0 or 1, multiplying adds them all up into the top byte
+		errors += static_cast<int>(((parityBits(word) ^ s_lowBits) * s_lowBits) >> 56);
+		word &= s_sevenBits;
+		std::memcpy(data + i, &word, 8);
+	}
+
+	for (; i<length; i++) {
+		if (oddParity(data[i]) != data[i])
+			errors++;
+		data[i] &= 0x7f;
+	}
+
+	return errors;
+}
+
+void encodeHamming84(unsigned char *data, int length)
+{
+	for (int i=0; i<length; i++)
+		data[i] = HammingTables::encode84Table[data[i] & 0x0f];
+}
+
+int decodeHamming84(unsigned char *data, int length)
+{
+	int errors = 0;
+
+	for (int i=0; i<length; i++) {
+		data[i] = HammingTables::decode84Table[data[i]];
+		errors += data[i] == 0xff;
+	}
+
+	return errors;
+}
+
+void encodeHamming2418(unsigned char *data, int triplets)
+{
+	for (int t=0; t<triplets; t++, data+=3) {
+		if (data[0] == 0xff) {
+			data[0] = data[1] = data[2] = 0;
+			continue;
+		}
+
+		const unsigned int codeword = hamming2418Encode(data[0] | (data[1] << 6) | (data[2] << 12));
+
+		data[0] = codeword & 0xff;
+		data[1] = (codeword >> 8) & 0xff;
+		data[2] = codeword >> 16;
+	}
+}
+
+int decodeHamming2418(unsigned char *data, int triplets)
+{
+	int errors = 0;
+
+	for (int t=0; t<triplets; t++, data+=3) {
+		const int value = hamming2418Decode(data[0] | (data[1] << 8) | (data[2] << 16));
+
+		if (value == -1) {
+			data[0] = data[1] = data[2] = 0xff;
+			errors++;
+		} else {
+			data[0] = value & 0x3f;
+			data[1] = (value >> 6) & 0x3f;
+			data[2] = value >> 12;
+		}
+	}
+
+	return errors;
+}
@@ -1,262 +1,272 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
 #ifndef HAMMING_H
 #define HAMMING_H
 
-// Hamming 8/4 encoding table
-// encoded_value = hamming_8_4_encode[value_to_encode]
-const unsigned char hamming_8_4_encode[16] = {
-	0x15, 0x02, 0x49, 0x5e, 0x64, 0x73, 0x38, 0x2f,
-	0xd0, 0xc7, 0x8c, 0x9b, 0xa1, 0xb6, 0xfd, 0xea
-};
-
-// Hamming 8/4 decoding table
-// decoded_value = hamming_8_4_decode[encoded_value]
-// 0xff - double bit error that can't be corrected
-const unsigned char hamming_8_4_decode[256] = {
-	0x01, 0xff, 0x01, 0x01, 0xff, 0x00, 0x01, 0xff,
-	0xff, 0x02, 0x01, 0xff, 0x0a, 0xff, 0xff, 0x07,
-	0xff, 0x00, 0x01, 0xff, 0x00, 0x00, 0xff, 0x00,
-	0x06, 0xff, 0xff, 0x0b, 0xff, 0x00, 0x03, 0xff,
-	0xff, 0x0c, 0x01, 0xff, 0x04, 0xff, 0xff, 0x07,
-	0x06, 0xff, 0xff, 0x07, 0xff, 0x07, 0x07, 0x07,
-	0x06, 0xff, 0xff, 0x05, 0xff, 0x00, 0x0d, 0xff,
-	0x06, 0x06, 0x06, 0xff, 0x06, 0xff, 0xff, 0x07,
-	0xff, 0x02, 0x01, 0xff, 0x04, 0xff, 0xff, 0x09,
-	0x02, 0x02, 0xff, 0x02, 0xff, 0x02, 0x03, 0xff,
-	0x08, 0xff, 0xff, 0x05, 0xff, 0x00, 0x03, 0xff,
-	0xff, 0x02, 0x03, 0xff, 0x03, 0xff, 0x03, 0x03,
-	0x04, 0xff, 0xff, 0x05, 0x04, 0x04, 0x04, 0xff,
-	0xff, 0x02, 0x0f, 0xff, 0x04, 0xff, 0xff, 0x07,
-	0xff, 0x05, 0x05, 0x05, 0x04, 0xff, 0xff, 0x05,
-	0x06, 0xff, 0xff, 0x05, 0xff, 0x0e, 0x03, 0xff,
-	0xff, 0x0c, 0x01, 0xff, 0x0a, 0xff, 0xff, 0x09,
-	0x0a, 0xff, 0xff, 0x0b, 0x0a, 0x0a, 0x0a, 0xff,
-	0x08, 0xff, 0xff, 0x0b, 0xff, 0x00, 0x0d, 0xff,
-	0xff, 0x0b, 0x0b, 0x0b, 0x0a, 0xff, 0xff, 0x0b,
-	0x0c, 0x0c, 0xff, 0x0c, 0xff, 0x0c, 0x0d, 0xff,
-	0xff, 0x0c, 0x0f, 0xff, 0x0a, 0xff, 0xff, 0x07,
-	0xff, 0x0c, 0x0d, 0xff, 0x0d, 0xff, 0x0d, 0x0d,
-	0x06, 0xff, 0xff, 0x0b, 0xff, 0x0e, 0x0d, 0xff,
-	0x08, 0xff, 0xff, 0x09, 0xff, 0x09, 0x09, 0x09,
-	0xff, 0x02, 0x0f, 0xff, 0x0a, 0xff, 0xff, 0x09,
-	0x08, 0x08, 0x08, 0xff, 0x08, 0xff, 0xff, 0x09,
-	0x08, 0xff, 0xff, 0x0b, 0xff, 0x0e, 0x03, 0xff,
-	0xff, 0x0c, 0x0f, 0xff, 0x04, 0xff, 0xff, 0x09,
-	0x0f, 0xff, 0x0f, 0x0f, 0xff, 0x0e, 0x0f, 0xff,
-	0x08, 0xff, 0xff, 0x05, 0xff, 0x0e, 0x0d, 0xff,
-	0xff, 0x0e, 0x0f, 0xff, 0x0e, 0x0e, 0xff, 0x0e
-};
-
-const unsigned char hamming_24_18_forward[2][256] = {
-	{
-		0x8b, 0x8c, 0x92, 0x95, 0xa1, 0xa6, 0xb8, 0xbf,
-		0xc0, 0xc7, 0xd9, 0xde, 0xea, 0xed, 0xf3, 0xf4,
-		0x0a, 0x0d, 0x13, 0x14, 0x20, 0x27, 0x39, 0x3e,
-		0x41, 0x46, 0x58, 0x5f, 0x6b, 0x6c, 0x72, 0x75,
-		0x09, 0x0e, 0x10, 0x17, 0x23, 0x24, 0x3a, 0x3d,
-		0x42, 0x45, 0x5b, 0x5c, 0x68, 0x6f, 0x71, 0x76,
-		0x88, 0x8f, 0x91, 0x96, 0xa2, 0xa5, 0xbb, 0xbc,
-		0xc3, 0xc4, 0xda, 0xdd, 0xe9, 0xee, 0xf0, 0xf7,
-		0x08, 0x0f, 0x11, 0x16, 0x22, 0x25, 0x3b, 0x3c,
-		0x43, 0x44, 0x5a, 0x5d, 0x69, 0x6e, 0x70, 0x77,
-		0x89, 0x8e, 0x90, 0x97, 0xa3, 0xa4, 0xba, 0xbd,
-		0xc2, 0xc5, 0xdb, 0xdc, 0xe8, 0xef, 0xf1, 0xf6,
-		0x8a, 0x8d, 0x93, 0x94, 0xa0, 0xa7, 0xb9, 0xbe,
-		0xc1, 0xc6, 0xd8, 0xdf, 0xeb, 0xec, 0xf2, 0xf5,
-		0x0b, 0x0c, 0x12, 0x15, 0x21, 0x26, 0x38, 0x3f,
-		0x40, 0x47, 0x59, 0x5e, 0x6a, 0x6d, 0x73, 0x74,
-		0x03, 0x04, 0x1a, 0x1d, 0x29, 0x2e, 0x30, 0x37,
-		0x48, 0x4f, 0x51, 0x56, 0x62, 0x65, 0x7b, 0x7c,
-		0x82, 0x85, 0x9b, 0x9c, 0xa8, 0xaf, 0xb1, 0xb6,
-		0xc9, 0xce, 0xd0, 0xd7, 0xe3, 0xe4, 0xfa, 0xfd,
-		0x81, 0x86, 0x98, 0x9f, 0xab, 0xac, 0xb2, 0xb5,
-		0xca, 0xcd, 0xd3, 0xd4, 0xe0, 0xe7, 0xf9, 0xfe,
-		0x00, 0x07, 0x19, 0x1e, 0x2a, 0x2d, 0x33, 0x34,
-		0x4b, 0x4c, 0x52, 0x55, 0x61, 0x66, 0x78, 0x7f,
-		0x80, 0x87, 0x99, 0x9e, 0xaa, 0xad, 0xb3, 0xb4,
-		0xcb, 0xcc, 0xd2, 0xd5, 0xe1, 0xe6, 0xf8, 0xff,
-		0x01, 0x06, 0x18, 0x1f, 0x2b, 0x2c, 0x32, 0x35,
-		0x4a, 0x4d, 0x53, 0x54, 0x60, 0x67, 0x79, 0x7e,
-		0x02, 0x05, 0x1b, 0x1c, 0x28, 0x2f, 0x31, 0x36,
-		0x49, 0x4e, 0x50, 0x57, 0x63, 0x64, 0x7a, 0x7d,
-		0x83, 0x84, 0x9a, 0x9d, 0xa9, 0xae, 0xb0, 0xb7,
-		0xc8, 0xcf, 0xd1, 0xd6, 0xe2, 0xe5, 0xfb, 0xfc
-	},
-	{
-		0x00, 0x89, 0x8a, 0x03, 0x8b, 0x02, 0x01, 0x88,
-		0x01, 0x88, 0x8b, 0x02, 0x8a, 0x03, 0x00, 0x89,
-		0x02, 0x8b, 0x88, 0x01, 0x89, 0x00, 0x03, 0x8a,
-		0x03, 0x8a, 0x89, 0x00, 0x88, 0x01, 0x02, 0x8b,
-		0x03, 0x8a, 0x89, 0x00, 0x88, 0x01, 0x02, 0x8b,
-		0x02, 0x8b, 0x88, 0x01, 0x89, 0x00, 0x03, 0x8a,
-		0x01, 0x88, 0x8b, 0x02, 0x8a, 0x03, 0x00, 0x89,
-		0x00, 0x89, 0x8a, 0x03, 0x8b, 0x02, 0x01, 0x88,
-		0x08, 0x81, 0x82, 0x0b, 0x83, 0x0a, 0x09, 0x80,
-		0x09, 0x80, 0x83, 0x0a, 0x82, 0x0b, 0x08, 0x81,
-		0x0a, 0x83, 0x80, 0x09, 0x81, 0x08, 0x0b, 0x82,
-		0x0b, 0x82, 0x81, 0x08, 0x80, 0x09, 0x0a, 0x83,
-		0x0b, 0x82, 0x81, 0x08, 0x80, 0x09, 0x0a, 0x83,
-		0x0a, 0x83, 0x80, 0x09, 0x81, 0x08, 0x0b, 0x82,
-		0x09, 0x80, 0x83, 0x0a, 0x82, 0x0b, 0x08, 0x81,
-		0x08, 0x81, 0x82, 0x0b, 0x83, 0x0a, 0x09, 0x80,
-		0x09, 0x80, 0x83, 0x0a, 0x82, 0x0b, 0x08, 0x81,
-		0x08, 0x81, 0x82, 0x0b, 0x83, 0x0a, 0x09, 0x80,
-		0x0b, 0x82, 0x81, 0x08, 0x80, 0x09, 0x0a, 0x83,
-		0x0a, 0x83, 0x80, 0x09, 0x81, 0x08, 0x0b, 0x82,
-		0x0a, 0x83, 0x80, 0x09, 0x81, 0x08, 0x0b, 0x82,
-		0x0b, 0x82, 0x81, 0x08, 0x80, 0x09, 0x0a, 0x83,
-		0x08, 0x81, 0x82, 0x0b, 0x83, 0x0a, 0x09, 0x80,
-		0x09, 0x80, 0x83, 0x0a, 0x82, 0x0b, 0x08, 0x81,
-		0x01, 0x88, 0x8b, 0x02, 0x8a, 0x03, 0x00, 0x89,
-		0x00, 0x89, 0x8a, 0x03, 0x8b, 0x02, 0x01, 0x88,
-		0x03, 0x8a, 0x89, 0x00, 0x88, 0x01, 0x02, 0x8b,
-		0x02, 0x8b, 0x88, 0x01, 0x89, 0x00, 0x03, 0x8a,
-		0x02, 0x8b, 0x88, 0x01, 0x89, 0x00, 0x03, 0x8a,
-		0x03, 0x8a, 0x89, 0x00, 0x88, 0x01, 0x02, 0x8b,
-		0x00, 0x89, 0x8a, 0x03, 0x8b, 0x02, 0x01, 0x88,
-		0x01, 0x88, 0x8b, 0x02, 0x8a, 0x03, 0x00, 0x89
+#include <array>
+
+// Odd parity, Hamming 8/4 and Hamming 24/18 coding of teletext packets.
+// The tables are generated at compile time from the coding rules in ETS 300 706 section 8,
+// bit 0 of each byte being the first bit transmitted.
+
+namespace HammingTables {
+
+constexpr int bitsSet(unsigned int value)
+{
+	int result = 0;
+
+	for (; value != 0; value >>= 1)
+		result += value & 1;
+
+	return result;
+}
+
+// Seven bit character with bit 7 set if needed to give it odd parity
+constexpr std::array<unsigned char, 128> makeOddParity()
+{
+	std::array<unsigned char, 128> result {};
+
+	for (int c=0; c<128; c++)
+		result[c] = (bitsSet(c) & 1) ? c : (c | 0x80);
+
+	return result;
+}
+
+// Hamming 8/4: D1-D4 in bits 1, 3, 5 and 7, protection bits P1-P4 in bits 0, 2, 4 and 6
+constexpr unsigned char encode84(int value)
+{
+	const int d1 = value & 1;
+	const int d2 = (value >> 1) & 1;
+	const int d3 = (value >> 2) & 1;
+	const int d4 = (value >> 3) & 1;
+	const int p1 = 1 ^ d1 ^ d3 ^ d4;
+	const int p2 = 1 ^ d1 ^ d2 ^ d4;
+	const int p3 = 1 ^ d1 ^ d2 ^ d3;
+	const int p4 = 1 ^ p1 ^ d1 ^ p2 ^ d2 ^ p3 ^ d3 ^ d4;
+
+	return p1 | (d1 << 1) | (p2 << 2) | (d2 << 3) | (p3 << 4) | (d3 << 5) | (p4 << 6) | (d4 << 7);
+}
+
+constexpr std::array<unsigned char, 16> makeEncode84()
+{
+	std::array<unsigned char, 16> result {};
+
+	for (int i=0; i<16; i++)
+		result[i] = encode84(i);
+
+	return result;
+}
+
+// A byte within one bit of a codeword is corrected, anything further is 0xff
+constexpr std::array<unsigned char, 256> makeDecode84()
+{
+	std::array<unsigned char, 256> result {};
+
+	for (int b=0; b<256; b++) {
+		result[b] = 0xff;
+		for (int i=0; i<16; i++)
+			if (bitsSet(b ^ encode84(i)) <= 1)
+				result[b] = i;
 	}
-};
-
-const unsigned char hamming_24_18_forward_2[4] = {
-	0x00, 0x0a, 0x0b, 0x01
-};
-
-
-const unsigned char hamming_24_18_parities[3][256] = {
-	{ // Parities of first byte
-		0x00, 0x21, 0x22, 0x03, 0x23, 0x02, 0x01, 0x20, 
-		0x24, 0x05, 0x06, 0x27, 0x07, 0x26, 0x25, 0x04, 
-		0x25, 0x04, 0x07, 0x26, 0x06, 0x27, 0x24, 0x05, 
-		0x01, 0x20, 0x23, 0x02, 0x22, 0x03, 0x00, 0x21, 
-		0x26, 0x07, 0x04, 0x25, 0x05, 0x24, 0x27, 0x06, 
-		0x02, 0x23, 0x20, 0x01, 0x21, 0x00, 0x03, 0x22, 
-		0x03, 0x22, 0x21, 0x00, 0x20, 0x01, 0x02, 0x23, 
-		0x27, 0x06, 0x05, 0x24, 0x04, 0x25, 0x26, 0x07, 
-		0x27, 0x06, 0x05, 0x24, 0x04, 0x25, 0x26, 0x07, 
-		0x03, 0x22, 0x21, 0x00, 0x20, 0x01, 0x02, 0x23, 
-		0x02, 0x23, 0x20, 0x01, 0x21, 0x00, 0x03, 0x22, 
-		0x26, 0x07, 0x04, 0x25, 0x05, 0x24, 0x27, 0x06, 
-		0x01, 0x20, 0x23, 0x02, 0x22, 0x03, 0x00, 0x21, 
-		0x25, 0x04, 0x07, 0x26, 0x06, 0x27, 0x24, 0x05, 
-		0x24, 0x05, 0x06, 0x27, 0x07, 0x26, 0x25, 0x04, 
-		0x00, 0x21, 0x22, 0x03, 0x23, 0x02, 0x01, 0x20, 
-		0x28, 0x09, 0x0a, 0x2b, 0x0b, 0x2a, 0x29, 0x08, 
-		0x0c, 0x2d, 0x2e, 0x0f, 0x2f, 0x0e, 0x0d, 0x2c, 
-		0x0d, 0x2c, 0x2f, 0x0e, 0x2e, 0x0f, 0x0c, 0x2d, 
-		0x29, 0x08, 0x0b, 0x2a, 0x0a, 0x2b, 0x28, 0x09, 
-		0x0e, 0x2f, 0x2c, 0x0d, 0x2d, 0x0c, 0x0f, 0x2e, 
-		0x2a, 0x0b, 0x08, 0x29, 0x09, 0x28, 0x2b, 0x0a, 
-		0x2b, 0x0a, 0x09, 0x28, 0x08, 0x29, 0x2a, 0x0b, 
-		0x0f, 0x2e, 0x2d, 0x0c, 0x2c, 0x0d, 0x0e, 0x2f, 
-		0x0f, 0x2e, 0x2d, 0x0c, 0x2c, 0x0d, 0x0e, 0x2f, 
-		0x2b, 0x0a, 0x09, 0x28, 0x08, 0x29, 0x2a, 0x0b, 
-		0x2a, 0x0b, 0x08, 0x29, 0x09, 0x28, 0x2b, 0x0a, 
-		0x0e, 0x2f, 0x2c, 0x0d, 0x2d, 0x0c, 0x0f, 0x2e, 
-		0x29, 0x08, 0x0b, 0x2a, 0x0a, 0x2b, 0x28, 0x09, 
-		0x0d, 0x2c, 0x2f, 0x0e, 0x2e, 0x0f, 0x0c, 0x2d, 
-		0x0c, 0x2d, 0x2e, 0x0f, 0x2f, 0x0e, 0x0d, 0x2c, 
-		0x28, 0x09, 0x0a, 0x2b, 0x0b, 0x2a, 0x29, 0x08
-	},
-	{ // Parities of second byte
-		0x00, 0x29, 0x2a, 0x03, 0x2b, 0x02, 0x01, 0x28, 
-		0x2c, 0x05, 0x06, 0x2f, 0x07, 0x2e, 0x2d, 0x04, 
-		0x2d, 0x04, 0x07, 0x2e, 0x06, 0x2f, 0x2c, 0x05, 
-		0x01, 0x28, 0x2b, 0x02, 0x2a, 0x03, 0x00, 0x29, 
-		0x2e, 0x07, 0x04, 0x2d, 0x05, 0x2c, 0x2f, 0x06, 
-		0x02, 0x2b, 0x28, 0x01, 0x29, 0x00, 0x03, 0x2a, 
-		0x03, 0x2a, 0x29, 0x00, 0x28, 0x01, 0x02, 0x2b, 
-		0x2f, 0x06, 0x05, 0x2c, 0x04, 0x2d, 0x2e, 0x07, 
-		0x2f, 0x06, 0x05, 0x2c, 0x04, 0x2d, 0x2e, 0x07, 
-		0x03, 0x2a, 0x29, 0x00, 0x28, 0x01, 0x02, 0x2b, 
-		0x02, 0x2b, 0x28, 0x01, 0x29, 0x00, 0x03, 0x2a, 
-		0x2e, 0x07, 0x04, 0x2d, 0x05, 0x2c, 0x2f, 0x06, 
-		0x01, 0x28, 0x2b, 0x02, 0x2a, 0x03, 0x00, 0x29, 
-		0x2d, 0x04, 0x07, 0x2e, 0x06, 0x2f, 0x2c, 0x05, 
-		0x2c, 0x05, 0x06, 0x2f, 0x07, 0x2e, 0x2d, 0x04, 
-		0x00, 0x29, 0x2a, 0x03, 0x2b, 0x02, 0x01, 0x28, 
-		0x30, 0x19, 0x1a, 0x33, 0x1b, 0x32, 0x31, 0x18, 
-		0x1c, 0x35, 0x36, 0x1f, 0x37, 0x1e, 0x1d, 0x34, 
-		0x1d, 0x34, 0x37, 0x1e, 0x36, 0x1f, 0x1c, 0x35, 
-		0x31, 0x18, 0x1b, 0x32, 0x1a, 0x33, 0x30, 0x19, 
-		0x1e, 0x37, 0x34, 0x1d, 0x35, 0x1c, 0x1f, 0x36, 
-		0x32, 0x1b, 0x18, 0x31, 0x19, 0x30, 0x33, 0x1a, 
-		0x33, 0x1a, 0x19, 0x30, 0x18, 0x31, 0x32, 0x1b, 
-		0x1f, 0x36, 0x35, 0x1c, 0x34, 0x1d, 0x1e, 0x37, 
-		0x1f, 0x36, 0x35, 0x1c, 0x34, 0x1d, 0x1e, 0x37, 
-		0x33, 0x1a, 0x19, 0x30, 0x18, 0x31, 0x32, 0x1b, 
-		0x32, 0x1b, 0x18, 0x31, 0x19, 0x30, 0x33, 0x1a, 
-		0x1e, 0x37, 0x34, 0x1d, 0x35, 0x1c, 0x1f, 0x36, 
-		0x31, 0x18, 0x1b, 0x32, 0x1a, 0x33, 0x30, 0x19, 
-		0x1d, 0x34, 0x37, 0x1e, 0x36, 0x1f, 0x1c, 0x35, 
-		0x1c, 0x35, 0x36, 0x1f, 0x37, 0x1e, 0x1d, 0x34, 
-		0x30, 0x19, 0x1a, 0x33, 0x1b, 0x32, 0x31, 0x18
-	},
-	{ // Parities of third byte
-		0x3f, 0x0e, 0x0d, 0x3c, 0x0c, 0x3d, 0x3e, 0x0f, 
-		0x0b, 0x3a, 0x39, 0x08, 0x38, 0x09, 0x0a, 0x3b, 
-		0x0a, 0x3b, 0x38, 0x09, 0x39, 0x08, 0x0b, 0x3a, 
-		0x3e, 0x0f, 0x0c, 0x3d, 0x0d, 0x3c, 0x3f, 0x0e, 
-		0x09, 0x38, 0x3b, 0x0a, 0x3a, 0x0b, 0x08, 0x39, 
-		0x3d, 0x0c, 0x0f, 0x3e, 0x0e, 0x3f, 0x3c, 0x0d, 
-		0x3c, 0x0d, 0x0e, 0x3f, 0x0f, 0x3e, 0x3d, 0x0c, 
-		0x08, 0x39, 0x3a, 0x0b, 0x3b, 0x0a, 0x09, 0x38, 
-		0x08, 0x39, 0x3a, 0x0b, 0x3b, 0x0a, 0x09, 0x38, 
-		0x3c, 0x0d, 0x0e, 0x3f, 0x0f, 0x3e, 0x3d, 0x0c, 
-		0x3d, 0x0c, 0x0f, 0x3e, 0x0e, 0x3f, 0x3c, 0x0d, 
-		0x09, 0x38, 0x3b, 0x0a, 0x3a, 0x0b, 0x08, 0x39, 
-		0x3e, 0x0f, 0x0c, 0x3d, 0x0d, 0x3c, 0x3f, 0x0e, 
-		0x0a, 0x3b, 0x38, 0x09, 0x39, 0x08, 0x0b, 0x3a, 
-		0x0b, 0x3a, 0x39, 0x08, 0x38, 0x09, 0x0a, 0x3b, 
-		0x3f, 0x0e, 0x0d, 0x3c, 0x0c, 0x3d, 0x3e, 0x0f, 
-		0x1f, 0x2e, 0x2d, 0x1c, 0x2c, 0x1d, 0x1e, 0x2f, 
-		0x2b, 0x1a, 0x19, 0x28, 0x18, 0x29, 0x2a, 0x1b, 
-		0x2a, 0x1b, 0x18, 0x29, 0x19, 0x28, 0x2b, 0x1a, 
-		0x1e, 0x2f, 0x2c, 0x1d, 0x2d, 0x1c, 0x1f, 0x2e, 
-		0x29, 0x18, 0x1b, 0x2a, 0x1a, 0x2b, 0x28, 0x19, 
-		0x1d, 0x2c, 0x2f, 0x1e, 0x2e, 0x1f, 0x1c, 0x2d, 
-		0x1c, 0x2d, 0x2e, 0x1f, 0x2f, 0x1e, 0x1d, 0x2c, 
-		0x28, 0x19, 0x1a, 0x2b, 0x1b, 0x2a, 0x29, 0x18, 
-		0x28, 0x19, 0x1a, 0x2b, 0x1b, 0x2a, 0x29, 0x18, 
-		0x1c, 0x2d, 0x2e, 0x1f, 0x2f, 0x1e, 0x1d, 0x2c, 
-		0x1d, 0x2c, 0x2f, 0x1e, 0x2e, 0x1f, 0x1c, 0x2d, 
-		0x29, 0x18, 0x1b, 0x2a, 0x1a, 0x2b, 0x28, 0x19, 
-		0x1e, 0x2f, 0x2c, 0x1d, 0x2d, 0x1c, 0x1f, 0x2e, 
-		0x2a, 0x1b, 0x18, 0x29, 0x19, 0x28, 0x2b, 0x1a, 
-		0x2b, 0x1a, 0x19, 0x28, 0x18, 0x29, 0x2a, 0x1b, 
-		0x1f, 0x2e, 0x2d, 0x1c, 0x2c, 0x1d, 0x1e, 0x2f
+
+	return result;
+}
+
+// Hamming 24/18: P1-P5 at bit positions 1, 2, 4, 8 and 16 counting from 1, P6 at position 24,
+// and D1-D18 in the other positions in order.
+// P1-P5 each give odd parity over the positions with that bit set in the position number,
+// P6 gives odd parity over the whole triplet.
+constexpr bool isParityPosition2418(int position)
+{
+	return position == 1 || position == 2 || position == 4 || position == 8 || position == 16 || position == 24;
+}
+
+// Position from 1 to 24 of each data bit
+constexpr std::array<int, 18> makeDataPositions2418()
+{
+	std::array<int, 18> result {};
+	int d = 0;
+
+	for (int position=1; position<=24; position++)
+		if (!isParityPosition2418(position))
+			result[d++] = position;
+
+	return result;
+}
+
+inline constexpr std::array<int, 18> dataPositions2418 = makeDataPositions2418();
+
+// Codeword of the given data bits, with the parity bits giving odd or even parity
+constexpr unsigned int encode2418(unsigned int value, bool odd)
+{
+	unsigned int result = 0;
+
+	for (int d=0; d<18; d++)
+		if (value & (1u << d))
+			result |= 1u << (dataPositions2418[d] - 1);
+
+	for (int k=0; k<5; k++) {
+		unsigned int parity = odd;
+
+		for (int position=1; position<24; position++)
+			if ((position >> k) & 1)
+				parity ^= (result >> (position - 1)) & 1;
+		result |= parity << ((1 << k) - 1);
 	}
-};
-
-static const unsigned char hamming_24_18_decode_d1_d4[64] = {
-	0x00, 0x01, 0x00, 0x01, 0x02, 0x03, 0x02, 0x03, 
-	0x04, 0x05, 0x04, 0x05, 0x06, 0x07, 0x06, 0x07, 
-	0x08, 0x09, 0x08, 0x09, 0x0a, 0x0b, 0x0a, 0x0b, 
-	0x0c, 0x0d, 0x0c, 0x0d, 0x0e, 0x0f, 0x0e, 0x0f, 
-	0x00, 0x01, 0x00, 0x01, 0x02, 0x03, 0x02, 0x03, 
-	0x04, 0x05, 0x04, 0x05, 0x06, 0x07, 0x06, 0x07, 
-	0x08, 0x09, 0x08, 0x09, 0x0a, 0x0b, 0x0a, 0x0b, 
-	0x0c, 0x0d, 0x0c, 0x0d, 0x0e, 0x0f, 0x0e, 0x0f
-};
-
-// Mapping from parity checks in hamming_24_18_parities to incorrect bit
-// 0x80000000 - double bit error that can't be corrected
-static const unsigned int hamming_24_18_decode_correct[64] = {
-	0x00000000, 0x80000000, 0x80000000, 0x80000000, 
-	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
-	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
-	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
-	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
-	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
-	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
-	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
-	0x00000000, 0x00000000, 0x00000000, 0x00000001, 
-	0x00000000, 0x00000002, 0x00000004, 0x00000008, 
-	0x00000000, 0x00000010, 0x00000020, 0x00000040, 
-	0x00000080, 0x00000100, 0x00000200, 0x00000400, 
-	0x00000000, 0x00000800, 0x00001000, 0x00002000, 
-	0x00004000, 0x00008000, 0x00010000, 0x00020000, 
-	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
-	0x80000000, 0x80000000, 0x80000000, 0x80000000
-};
+
+	return result | ((odd ^ (bitsSet(result) & 1)) << 23);
+}
+
+// The code is linear apart from the parity being odd, so a codeword is the exclusive or of the
+// even parity codewords of each byte of data, with the codeword of zero put into the first table
+constexpr std::array<unsigned int, 256> makeEncode2418(int shift)
+{
+	std::array<unsigned int, 256> result {};
+
+	for (int i=0; i<256; i++)
+		result[i] = encode2418((i << shift) & 0x3ffff, false) ^ (shift == 0 ? encode2418(0, true) : 0);
+
+	return result;
+}
+
+// Six parity checks taken from each byte of a codeword, bit 5 being the whole triplet
+constexpr std::array<unsigned char, 256> makeChecks2418(int byte)
+{
+	std::array<unsigned char, 256> result {};
+
+	for (int i=0; i<256; i++)
+		for (int j=0; j<8; j++) {
+			const int position = byte * 8 + j + 1;
+
+			if (!((i >> j) & 1))
+				continue;
+			for (int k=0; k<5; k++)
+				if (position < 24 && ((position >> k) & 1))
+					result[i] ^= 1 << k;
+			result[i] ^= 0x20;
+		}
+
+	return result;
+}
+
+// Data bits held in each byte of a codeword
+constexpr std::array<unsigned int, 256> makeData2418(int byte)
+{
+	std::array<unsigned int, 256> result {};
+
+	for (int i=0; i<256; i++)
+		for (int d=0; d<18; d++) {
+			const int position = dataPositions2418[d];
+
+			if ((position - 1) / 8 == byte && ((i >> ((position - 1) % 8)) & 1))
+				result[i] |= 1u << d;
+		}
+
+	return result;
+}
+
+// Data bits to flip for each set of failed checks, 0x80000000 where the error can't be corrected.
+// A single error fails the whole triplet check along with the checks that point to its position,
+// two errors pass the whole triplet check but still fail some of the others.
+constexpr std::array<unsigned int, 64> makeCorrect2418()
+{
+	std::array<unsigned int, 64> result {};
+
+	for (int failed=0; failed<64; failed++) {
+		const int position = failed & 0x1f;
+
+		if (position == 0)
+			result[failed] = 0;
+		else if (!(failed & 0x20) || position > 23)
+			result[failed] = 0x80000000;
+		else if (isParityPosition2418(position))
+			result[failed] = 0;
+		else
+			for (int d=0; d<18; d++)
+				if (dataPositions2418[d] == position)
+					result[failed] = 1u << d;
+	}
+
+	return result;
+}
+
+inline constexpr std::array<unsigned char, 128> oddParityTable = makeOddParity();
+inline constexpr std::array<unsigned char, 16> encode84Table = makeEncode84();
+inline constexpr std::array<unsigned char, 256> decode84Table = makeDecode84();
+inline constexpr std::array<unsigned int, 256> encode2418Table[3] = { makeEncode2418(0), makeEncode2418(8), makeEncode2418(16) };
+inline constexpr std::array<unsigned char, 256> checks2418Table[3] = { makeChecks2418(0), makeChecks2418(1), makeChecks2418(2) };
+inline constexpr std::array<unsigned int, 256> data2418Table[3] = { makeData2418(0), makeData2418(1), makeData2418(2) };
+inline constexpr std::array<unsigned int, 64> correct2418Table = makeCorrect2418();
+
+}
+
+inline unsigned char oddParity(unsigned char c)
+{
+	return HammingTables::oddParityTable[c & 0x7f];
+}
+
+inline unsigned char hamming84Encode(int value)
+{
+	return HammingTables::encode84Table[value & 0x0f];
+}
+
+// 0xff if there is more than one bit in error
+inline unsigned char hamming84Decode(unsigned char byte)
+{
+	return HammingTables::decode84Table[byte];
+}
+
+// Value of 18 bits to a codeword of 24 bits, first byte to transmit in the lowest bits
+inline unsigned int hamming2418Encode(unsigned int value)
+{
+	return HammingTables::encode2418Table[0][value & 0xff] ^ HammingTables::encode2418Table[1][(value >> 8) & 0xff] ^ HammingTables::encode2418Table[2][(value >> 16) & 0x03];
+}
+
+// -1 if there is more than one bit in error
+inline int hamming2418Decode(unsigned int codeword)
+{
+	const unsigned char b0 = codeword & 0xff;
+	const unsigned char b1 = (codeword >> 8) & 0xff;
+	const unsigned char b2 = (codeword >> 16) & 0xff;
+	// Each check should come out as odd parity, so any that come out even have failed
+	const int failed = HammingTables::checks2418Table[0][b0] ^ HammingTables::checks2418Table[1][b1] ^ HammingTables::checks2418Table[2][b2] ^ 0x3f;
+	const unsigned int result = (HammingTables::data2418Table[0][b0] | HammingTables::data2418Table[1][b1] | HammingTables::data2418Table[2][b2]) ^ HammingTables::correct2418Table[failed];
+
+	return (result & 0x80000000) ? -1 : static_cast<int>(result);
+}
+
+// Batch versions working in place on whole packets or buffers of packets
+
+// Sets bit 7 of each byte to give it odd parity
+void encodeOddParity(unsigned char *data, int length);
+// Clears bit 7 of each byte, returning how many bytes didn't have odd parity
+int decodeOddParity(unsigned char *data, int length);
+
+void encodeHamming84(unsigned char *data, int length);
+// Bytes with more than one bit in error are set to 0xff, returning how many
+int decodeHamming84(unsigned char *data, int length);
+
+// Triplets are held as three bytes of six bits, lowest bits first, as PageBase holds them.
+// A triplet of 0xff is marked invalid and is encoded as all zeroes which fails decoding.
+void encodeHamming2418(unsigned char *data, int triplets);
+// Triplets with more than one bit in error are set to three bytes of 0xff, returning how many
+int decodeHamming2418(unsigned char *data, int triplets);
 
 #endif
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QImage>
+#include <QList>
+#include <QPainter>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "imagemosaic.h"
+
+#include "mosaicbitplane.h"
+
+// Character cells are 12 by 10 pixels, so sixels are about 6 by 3.33 pixels
+static constexpr int s_cellWidth = 12;
+static constexpr int s_cellHeight = 10;
+
+// 4x4 Bayer matrix spread around the threshold
+static constexpr int s_orderedBias[4][4] = {
+	{ -120,    8,  -88,   40 },
+	{   72,  -56,  104,  -24 },
+	{  -72,   56, -104,   24 },
+	{  120,   -8,   88,  -40 }
+};
+
+ImageMosaicConverter::ImageMosaicConverter()
+{
+	m_rows = m_columns = 0;
+	m_dither = OrderedDither;
+	m_threshold = 128;
+	m_reverse = false;
+	m_colourMode = Monochrome;
+}
+
+void ImageMosaicConverter::setImage(const QImage &image, int rows, int columns, bool keepAspectRatio)
+{
+	m_rows = qBound(0, rows, MosaicBitplane::Rows);
+	m_columns = qBound(0, columns, MosaicBitplane::Columns);
+
+	const int width = m_columns * 2;
+	const int height = m_rows * 3;
+
+	m_scaled = QImage(width, height, QImage::Format_RGB32);
+	m_scaled.fill(Qt::black);
+	m_luminance.clear();
+
+	if (image.isNull() || width == 0 || height == 0)
+		return;
+
+	QSize scaledSize(width, height);
+
+	if (keepAspectRatio) {
+		// Fit the image into the block as it would be displayed, then work out its size in sixels
+		const QSize displaySize = image.size().scaled(m_columns * s_cellWidth, m_rows * s_cellHeight, Qt::KeepAspectRatio);
+
+		scaledSize = QSize(qBound(1, (displaySize.width() * 2 + s_cellWidth / 2) / s_cellWidth, width), qBound(1, (displaySize.height() * 3 + s_cellHeight / 2) / s_cellHeight, height));
+	}
+
+	// Drawn over black so any transparent parts come out as unlit sixels
+	QPainter painter(&m_scaled);
+
+	painter.drawImage((width - scaledSize.width()) / 2, (height - scaledSize.height()) / 2, image.scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+	painter.end();
+
+	m_luminance.resize(width * height);
+
+	char *luminance = m_luminance.data();
+
+	for (int y=0; y<height; y++) {
+		const QRgb *line = reinterpret_cast<const QRgb *>(m_scaled.constScanLine(y));
+
+		for (int x=0; x<width; x++)
+			*luminance++ = static_cast<char>((qRed(line[x]) * 77 + qGreen(line[x]) * 150 + qBlue(line[x]) * 29) >> 8);
+	}
+}
+
+void ImageMosaicConverter::setPageRows(const QByteArrayList &pageRows, int leftColumn, int level)
+{
+	const bool blackCodes = level >= 2;
+
+	m_rowEdges.clear();
+
+	for (const QByteArray &pageRow : pageRows) {
+		rowEdges edges;
+		const int rightColumn = leftColumn + m_columns;
+
+		edges.left = stateBefore(pageRow, leftColumn, blackCodes);
+		edges.right = stateBefore(pageRow, rightColumn, blackCodes);
+		edges.restoreRight = rightColumn < pageRow.size();
+		m_rowEdges.append(edges);
+	}
+}
+
+// Only the set-after colour codes change the foreground colour and switch between alphanumerics and graphics.
+// Below Level 2.5 0x00 and 0x10 are NUL and change nothing, so black is never reached there and
+// the code that puts the page's state back after the block is never one of them.
+ImageMosaicConverter::pageState ImageMosaicConverter::stateBefore(const QByteArray &pageRow, int column, bool blackCodes)
+{
+	pageState result;
+
+	for (int c=0; c<column && c<pageRow.size(); c++) {
+		const unsigned char ch = pageRow.at(c) & 0x7f;
+
+		if ((ch == 0x00 || ch == 0x10) && !blackCodes)
+			continue;
+		if (ch <= 0x07 || (ch >= 0x10 && ch <= 0x17)) {
+			result.graphics = ch & 0x10;
+			result.colour = ch & 0x07;
+		}
+	}
+
+	return result;
+}
+
+QRgb ImageMosaicConverter::pixel(int x, int y) const
+{
+	const QRgb result = reinterpret_cast<const QRgb *>(m_scaled.constScanLine(y))[x];
+
+	return m_reverse ? (result ^ 0x00ffffff) : result;
+}
+
+MosaicBitplane ImageMosaicConverter::sixels() const
+{
+	MosaicBitplane result;
+
+	if (m_luminance.isEmpty())
+		return result;
+
+	const int width = m_columns * 2;
+	const int height = m_rows * 3;
+	const unsigned char *luminance = reinterpret_cast<const unsigned char *>(m_luminance.constData());
+
+	for (int r=0; r<m_rows; r++)
+		for (int c=0; c<m_columns; c++)
+			result.addCell(r, c);
+
+	// Errors carried to this line and the next, with a spare entry at each end
+	std::vector<int> thisError, nextError;
+
+	if (m_dither == ErrorDiffusion) {
+		thisError.assign(width + 2, 0);
+		nextError.assign(width + 2, 0);
+	}
+
+	for (int y=0; y<height; y++) {
+		for (int x=0; x<width; x++) {
+			const int value = m_reverse ? 255 - *luminance++ : *luminance++;
+			bool lit;
+
+			switch (m_dither) {
+				case OrderedDither:
+					lit = value > m_threshold + s_orderedBias[y & 3][x & 3];
+					break;
+				case ErrorDiffusion: {
+					// Floyd-Steinberg
+					const int corrected = value + thisError[x+1] / 16;
+					lit = corrected > m_threshold;
+
+					const int error = corrected - (lit ? 255 : 0);
+
+					thisError[x+2] += error * 7;
+					nextError[x] += error * 3;
+					nextError[x+1] += error * 5;
+					nextError[x+2] += error;
+					break;
+				}
+				default:
+					lit = value > m_threshold;
+			}
+
+			if (lit)
+				result.setSixel(x, y);
+		}
+
+		if (m_dither == ErrorDiffusion) {
+			thisError.swap(nextError);
+			std::fill(nextError.begin(), nextError.end(), 0);
+		}
+	}
+
+	return result;
+}
+
+QByteArrayList ImageMosaicConverter::convert() const
+{
+	QByteArrayList result;
+
+	result.reserve(m_rows);
+	for (int r=0; r<m_rows; r++)
+		result.append(QByteArray(m_columns, 0x20));
+
+	sixels().writeCharacters(result, 0, 0);
+
+	if (m_colourMode == SpacingAttributes)
+		for (int r=0; r<m_rows; r++)
+			fitColours(result[r], r);
+
+	return result;
+}
+
+// Picks the foreground colours along a row of mosaic characters.
+// Each change of colour needs a set-after graphics colour code, which takes up a cell that then
+// shows as blank, so the cheapest mix of colour changes and blanked cells is found for the whole row.
+// The row starts off in whatever the page has at the left of the block, so if that's alphanumerics
+// the first lit cell has to give up a cell. If the page carries on to the right of the block, the
+// row has to end up as the page had it there, which may take a colour code in the last cell.
+void ImageMosaicConverter::fitColours(QByteArray &rowCharacters, int r) const
+{
+	// State 0 is the page's state at the left of the block when it isn't a graphics colour that
+	// shows lit sixels, 1 to 7 are the graphics colours
+	constexpr int states = 8;
+	constexpr qint64 unreachable = Q_INT64_C(1) << 60;
+
+	const rowEdges edges = m_rowEdges.value(r);
+	const int startState = (edges.left.graphics && edges.left.colour != 0) ? edges.left.colour : 0;
+	// What each state leaves the rest of the row in
+	const auto stateAfter = [&](int s) {
+		return s == 0 ? edges.left : pageState { true, s };
+	};
+	static constexpr unsigned char sixelBits[6] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x40 };
+
+	// Squared difference of a pixel from each of the Level 1 colours, weighted roughly to the eye
+	const auto distance = [](QRgb p, int colour) {
+		const int dr = qRed(p) - ((colour & 1) ? 255 : 0);
+		const int dg = qGreen(p) - ((colour & 2) ? 255 : 0);
+		const int db = qBlue(p) - ((colour & 4) ? 255 : 0);
+
+		return 2 * dr * dr + 4 * dg * dg + 3 * db * db;
+	};
+
+	qint64 cost[states];
+	// State each cell was reached from, a different state meaning the cell holds a colour code
+	std::vector<std::array<char, states>> from(m_columns);
+
+	for (int s=0; s<states; s++)
+		cost[s] = s == startState ? 0 : unreachable;
+
+	// Costs before the last cell, in case that has to be given up to put the page's state back
+	qint64 lastCellCost[states];
+	qint64 lastBlankCost = 0;
+
+	for (int c=0; c<m_columns; c++) {
+		const unsigned char ch = rowCharacters.at(c);
+		qint64 cellCost[states] = { };
+
+		// Unlit sixels show the black background whatever the state, so only lit sixels count
+		for (int i=0; i<6; i++) {
+			if (!(ch & sixelBits[i]))
+				continue;
+
+			const QRgb p = pixel(c * 2 + (i & 1), r * 3 + i / 2);
+
+			for (int s=0; s<states; s++)
+				cellCost[s] += distance(p, s);
+		}
+
+		// Shown blank in alphanumerics or as a colour code
+		const qint64 blankCost = cellCost[0];
+		qint64 newCost[states];
+		int cheapest = 0;
+
+		if (c == m_columns-1) {
+			std::copy(cost, cost + states, lastCellCost);
+			lastBlankCost = blankCost;
+		}
+
+		for (int s=1; s<states; s++)
+			if (cost[s] < cost[cheapest])
+				cheapest = s;
+
+		newCost[0] = cost[0] + blankCost;
+		from[c][0] = 0;
+
+		for (int s=1; s<states; s++) {
+			newCost[s] = cost[s] + cellCost[s];
+			from[c][s] = s;
+
+			// Changing to this colour from the cheapest other state
+			int other = cheapest;
+
+			if (other == s) {
+				other = -1;
+				for (int t=0; t<states; t++)
+					if (t != s && (other == -1 || cost[t] < cost[other]))
+						other = t;
+			}
+
+			if (cost[other] + blankCost < newCost[s]) {
+				newCost[s] = cost[other] + blankCost;
+				from[c][s] = other;
+			}
+		}
+
+		std::copy(newCost, newCost + states, cost);
+	}
+
+	// Ending in a state that leaves the rest of the row as the page had it
+	int state = -1;
+	qint64 bestCost = unreachable;
+
+	for (int s=0; s<states; s++)
+		if (cost[s] < bestCost && (!edges.restoreRight || stateAfter(s) == edges.right)) {
+			state = s;
+			bestCost = cost[s];
+		}
+
+	// or ending in any state with the last cell turned into a code that puts the page's state back
+	bool restoreCode = false;
+
+	if (edges.restoreRight && m_columns > 0)
+		for (int s=0; s<states; s++)
+			if (lastCellCost[s] < unreachable && lastCellCost[s] + lastBlankCost < bestCost) {
+				state = s;
+				bestCost = lastCellCost[s] + lastBlankCost;
+				restoreCode = true;
+			}
+
+	int c = m_columns-1;
+
+	if (restoreCode) {
+		rowCharacters[c] = (edges.right.graphics ? 0x10 : 0x00) | edges.right.colour;
+		c--;
+	}
+
+	for (; c>=0; c--) {
+		const int previous = from[c][state];
+
+		if (previous != state)
+			rowCharacters[c] = 0x10 | state;
+		else if (state == 0)
+			rowCharacters[c] = 0x20;
+
+		state = previous;
+	}
+}
+
+QImage ImageMosaicConverter::preview(const QByteArrayList &characters) const
+{
+	QImage result(m_columns * 2, m_rows * 3, QImage::Format_RGB32);
+
+	result.fill(Qt::black);
+
+	for (int r=0; r<characters.size() && r<m_rows; r++) {
+		const QByteArray &rowCharacters = characters.at(r);
+		// Monochrome conversions have no colour codes, so show them as if they are in white graphics
+		const pageState left = m_rowEdges.value(r).left;
+		bool graphics = m_colourMode == Monochrome || left.graphics;
+		QRgb foreground = qRgb(255, 255, 255);
+
+		if (m_colourMode == SpacingAttributes)
+			foreground = qRgb((left.colour & 1) ? 255 : 0, (left.colour & 2) ? 255 : 0, (left.colour & 4) ? 255 : 0);
+
+		for (int c=0; c<rowCharacters.size() && c<m_columns; c++) {
+			const unsigned char ch = rowCharacters.at(c);
+
+			if (ch >= 0x10 && ch <= 0x17) {
+				graphics = true;
+				foreground = qRgb((ch & 1) ? 255 : 0, (ch & 2) ? 255 : 0, (ch & 4) ? 255 : 0);
+				continue;
+			}
+			if (ch <= 0x07)
+				graphics = false;
+			if (!graphics || !(ch & 0x20))
+				continue;
+
+			if (ch & 0x01)
+				result.setPixel(c * 2, r * 3, foreground);
+			if (ch & 0x02)
+				result.setPixel(c * 2 + 1, r * 3, foreground);
+			if (ch & 0x04)
+				result.setPixel(c * 2, r * 3 + 1, foreground);
+			if (ch & 0x08)
+				result.setPixel(c * 2 + 1, r * 3 + 1, foreground);
+			if (ch & 0x10)
+				result.setPixel(c * 2, r * 3 + 2, foreground);
+			if (ch & 0x40)
+				result.setPixel(c * 2 + 1, r * 3 + 2, foreground);
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGEMOSAIC_H
+#define IMAGEMOSAIC_H
+
+#include <QByteArray>
+#include <QByteArrayList>
+#include <QImage>
+#include <QList>
+
+#include "mosaicbitplane.h"
+
+// Converts an image into a block of mosaic characters, thresholding it into sixels with
+// optional dithering then optionally picking a foreground colour for each run of cells
+// with Level 1 spacing attributes.
+// The image is scaled down to one pixel per sixel when it's set, so converting again after
+// changing the other settings only has to go through a few thousand pixels.
+class ImageMosaicConverter
+{
+public:
+	enum Dither { NoDither, OrderedDither, ErrorDiffusion };
+	enum ColourMode { Monochrome, SpacingAttributes };
+
+	ImageMosaicConverter();
+
+	// Block of up to 25 rows and 40 columns
+	void setImage(const QImage &image, int rows, int columns, bool keepAspectRatio = true);
+	void setDither(Dither dither) { m_dither = dither; };
+	// Pixels brighter than this light up their sixel
+	void setThreshold(int threshold) { m_threshold = threshold; };
+	// Dark pixels light up their sixel instead
+	void setReverse(bool reverse) { m_reverse = reverse; };
+	void setColourMode(ColourMode colourMode) { m_colourMode = colourMode; };
+	// The whole rows of the page the block goes into, so that colours start from the page's own
+	// attributes at the left of the block and the rest of the row to the right is left as it was.
+	// Level is numbered as TeletextPageDecode does, alpha and graphics black need Level 2.5.
+	void setPageRows(const QByteArrayList &pageRows, int leftColumn, int level);
+
+	int rows() const { return m_rows; };
+	int columns() const { return m_columns; };
+
+	QByteArrayList convert() const;
+	// How the converted characters would look, one pixel per sixel
+	QImage preview(const QByteArrayList &characters) const;
+
+private:
+	// Level 1 alphanumerics or graphics and foreground colour at a point in a row
+	struct pageState {
+		bool graphics=false;
+		int colour=7;
+
+		bool operator==(const pageState &other) const { return graphics == other.graphics && colour == other.colour; }
+	};
+
+	struct rowEdges {
+		pageState left, right;
+		// False when the block reaches the end of the row
+		bool restoreRight=false;
+	};
+
+	static pageState stateBefore(const QByteArray &pageRow, int column, bool blackCodes);
+
+	MosaicBitplane sixels() const;
+	void fitColours(QByteArray &rowCharacters, int r) const;
+	QRgb pixel(int x, int y) const;
+
+	int m_rows, m_columns;
+	// The image scaled to one pixel per sixel, and the luminance of each pixel
+	QImage m_scaled;
+	QByteArray m_luminance;
+
+	Dither m_dither;
+	int m_threshold;
+	bool m_reverse;
+	ColourMode m_colourMode;
+	QList<rowEdges> m_rowEdges;
+};
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QImage>
+#include <QLabel>
+#include <QPixmap>
+#include <QSlider>
+#include <QVBoxLayout>
+
+#include "importimagedialog.h"
+
+#include "imagemosaic.h"
+
+ImportImageDialog::ImportImageDialog(const QImage &image, const QByteArrayList &pageRows, int leftColumn, int columns, int level, QWidget *parent) : QDialog(parent)
+{
+	m_image = image;
+
+	setWindowTitle(tr("Import image as mosaics"));
+
+	QVBoxLayout *dialogLayout = new QVBoxLayout(this);
+	QFormLayout *settingsLayout = new QFormLayout;
+
+	m_previewLabel = new QLabel;
+	m_previewLabel->setAlignment(Qt::AlignCenter);
+	dialogLayout->addWidget(m_previewLabel, 1);
+
+	m_ditherComboBox = new QComboBox;
+	m_ditherComboBox->addItem(tr("None"), ImageMosaicConverter::NoDither);
+	m_ditherComboBox->addItem(tr("Ordered"), ImageMosaicConverter::OrderedDither);
+	m_ditherComboBox->addItem(tr("Error diffusion"), ImageMosaicConverter::ErrorDiffusion);
+	m_ditherComboBox->setCurrentIndex(1);
+	settingsLayout->addRow(tr("Dithering"), m_ditherComboBox);
+
+	QHBoxLayout *thresholdLayout = new QHBoxLayout;
+
+	m_thresholdSlider = new QSlider(Qt::Horizontal);
+	m_thresholdSlider->setRange(0, 255);
+	m_thresholdSlider->setValue(128);
+	thresholdLayout->addWidget(m_thresholdSlider);
+	m_thresholdLabel = new QLabel;
+	m_thresholdLabel->setMinimumWidth(m_thresholdLabel->fontMetrics().horizontalAdvance("000"));
+	thresholdLayout->addWidget(m_thresholdLabel);
+	settingsLayout->addRow(tr("Threshold"), thresholdLayout);
+
+	m_colourComboBox = new QComboBox;
+	m_colourComboBox->addItem(tr("Monochrome"), ImageMosaicConverter::Monochrome);
+	m_colourComboBox->addItem(tr("Level 1 colours"), ImageMosaicConverter::SpacingAttributes);
+	m_colourComboBox->setToolTip(tr("Level 1 colours put graphics colour codes in the block, each one taking up a cell"));
+	settingsLayout->addRow(tr("Colours"), m_colourComboBox);
+
+	m_reverseCheckBox = new QCheckBox(tr("Reverse"));
+	settingsLayout->addRow(m_reverseCheckBox);
+	m_aspectRatioCheckBox = new QCheckBox(tr("Keep aspect ratio"));
+	m_aspectRatioCheckBox->setChecked(true);
+	settingsLayout->addRow(m_aspectRatioCheckBox);
+
+	dialogLayout->addLayout(settingsLayout);
+
+	QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+	connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+	connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+	dialogLayout->addWidget(buttonBox);
+
+	// Scaling the image is only needed when the block or aspect ratio changes,
+	// the other settings only need the converter to run again on the scaled image
+	m_converter.setImage(m_image, pageRows.size(), columns, true);
+	m_converter.setPageRows(pageRows, leftColumn, level);
+
+	connect(m_ditherComboBox, &QComboBox::currentIndexChanged, this, &ImportImageDialog::updatePreview);
+	connect(m_colourComboBox, &QComboBox::currentIndexChanged, this, &ImportImageDialog::updatePreview);
+	connect(m_thresholdSlider, &QSlider::valueChanged, this, &ImportImageDialog::updatePreview);
+	connect(m_reverseCheckBox, &QCheckBox::toggled, this, &ImportImageDialog::updatePreview);
+	connect(m_aspectRatioCheckBox, &QCheckBox::toggled, this, &ImportImageDialog::updateImage);
+
+	updatePreview();
+}
+
+void ImportImageDialog::updateImage()
+{
+	m_converter.setImage(m_image, m_converter.rows(), m_converter.columns(), m_aspectRatioCheckBox->isChecked());
+	updatePreview();
+}
+
+void ImportImageDialog::updatePreview()
+{
+	m_converter.setDither(static_cast<ImageMosaicConverter::Dither>(m_ditherComboBox->currentData().toInt()));
+	m_converter.setThreshold(m_thresholdSlider->value());
+	m_converter.setReverse(m_reverseCheckBox->isChecked());
+	m_converter.setColourMode(static_cast<ImageMosaicConverter::ColourMode>(m_colourComboBox->currentData().toInt()));
+	m_thresholdLabel->setNumber(m_thresholdSlider->value());
+
+	m_characters = m_converter.convert();
+
+	// Shown at twice the size of the characters on the page
+	const QImage preview = m_converter.preview(m_characters).scaled(m_converter.columns() * 24, m_converter.rows() * 20);
+
+	m_previewLabel->setPixmap(QPixmap::fromImage(preview));
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMPORTIMAGEDIALOG_H
+#define IMPORTIMAGEDIALOG_H
+
+#include <QByteArrayList>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QImage>
+#include <QLabel>
+#include <QSlider>
+
+#include "imagemosaic.h"
+
+// Settings for turning an image into mosaics, with a preview that follows the settings as they change
+class ImportImageDialog : public QDialog
+{
+	Q_OBJECT
+
+public:
+	// pageRows are the whole rows of the page that the block of characters goes into
+	ImportImageDialog(const QImage &image, const QByteArrayList &pageRows, int leftColumn, int columns, int level, QWidget *parent = nullptr);
+
+	QByteArrayList characters() const { return m_characters; };
+
+private:
+	void updateImage();
+	void updatePreview();
+
+	QImage m_image;
+	ImageMosaicConverter m_converter;
+	QByteArrayList m_characters;
+
+	QLabel *m_previewLabel, *m_thresholdLabel;
+	QComboBox *m_ditherComboBox, *m_colourComboBox;
+	QSlider *m_thresholdSlider;
+	QCheckBox *m_reverseCheckBox, *m_aspectRatioCheckBox;
+};
+
+#endif
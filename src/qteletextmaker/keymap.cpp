@@ -0,0 +1,592 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QChar>
+#include <array>
+
+#include "keymap.h"
+
+struct keymapEntry {
+	int charSet;
+	char16_t unicode;
+	char teletext;
+};
+
+// Unicode characters that are typed or pasted as a different teletext character in each character set
+static constexpr keymapEntry s_keymapEntries[] = {
+	// Only used by X/26 enhancements, not directly by keyboard
+	// 0 Latin G0
+
+	// 1 Cyrillic G0 1 Serbian/Croatian
+	{ 1, 0x0427, 0x40 }, // Ч CYRILLIC CAPITAL LETTER CHE
+	{ 1, 0x0410, 0x41 }, // А CYRILLIC CAPITAL LETTER A
+	{ 1, 0x0411, 0x42 }, // Б CYRILLIC CAPITAL LETTER BE
+	{ 1, 0x0426, 0x43 }, // Ц CYRILLIC CAPITAL LETTER TSE
+	{ 1, 0x0414, 0x44 }, // Д CYRILLIC CAPITAL LETTER DE
+	{ 1, 0x0415, 0x45 }, // Е CYRILLIC CAPITAL LETTER IE
+	{ 1, 0x0424, 0x46 }, // Ф CYRILLIC CAPITAL LETTER EF
+	{ 1, 0x0413, 0x47 }, // Г CYRILLIC CAPITAL LETTER GHE
+	{ 1, 0x0425, 0x48 }, // Х CYRILLIC CAPITAL LETTER HA
+	{ 1, 0x0418, 0x49 }, // И CYRILLIC CAPITAL LETTER I
+	{ 1, 0x0408, 0x4a }, // Ј CYRILLIC CAPITAL LETTER JE
+	{ 1, 0x041a, 0x4b }, // К CYRILLIC CAPITAL LETTER KA
+	{ 1, 0x041b, 0x4c }, // Л CYRILLIC CAPITAL LETTER EL
+	{ 1, 0x041c, 0x4d }, // М CYRILLIC CAPITAL LETTER EM
+	{ 1, 0x041d, 0x4e }, // Н CYRILLIC CAPITAL LETTER EN
+	{ 1, 0x041e, 0x4f }, // О CYRILLIC CAPITAL LETTER O
+	{ 1, 0x041f, 0x50 }, // П CYRILLIC CAPITAL LETTER PE
+	{ 1, 0x040c, 0x51 }, // Ќ CYRILLIC CAPITAL LETTER KJE
+	{ 1, 0x0420, 0x52 }, // Р CYRILLIC CAPITAL LETTER ER
+	{ 1, 0x0421, 0x53 }, // С CYRILLIC CAPITAL LETTER ES
+	{ 1, 0x0422, 0x54 }, // Т CYRILLIC CAPITAL LETTER TE
+	{ 1, 0x0423, 0x55 }, // У CYRILLIC CAPITAL LETTER U
+	{ 1, 0x0412, 0x56 }, // В CYRILLIC CAPITAL LETTER VE
+	{ 1, 0x0403, 0x57 }, // Ѓ CYRILLIC CAPITAL LETTER GJE
+	{ 1, 0x0409, 0x58 }, // Љ CYRILLIC CAPITAL LETTER LJE
+	{ 1, 0x040a, 0x59 }, // Њ CYRILLIC CAPITAL LETTER NJE
+	{ 1, 0x0417, 0x5a }, // З CYRILLIC CAPITAL LETTER ZE
+	{ 1, 0x040b, 0x5b }, // Ћ CYRILLIC CAPITAL LETTER TSHE
+	{ 1, 0x0416, 0x5c }, // Ж CYRILLIC CAPITAL LETTER ZHE
+	{ 1, 0x0402, 0x5d }, // Ђ CYRILLIC CAPITAL LETTER DJE
+	{ 1, 0x0428, 0x5e }, // Ш CYRILLIC CAPITAL LETTER SHA
+	{ 1, 0x040f, 0x5f }, // Џ CYRILLIC CAPITAL LETTER DZHE
+	{ 1, 0x0447, 0x60 }, // ч CYRILLIC SMALL LETTER CHE
+	{ 1, 0x0430, 0x61 }, // а CYRILLIC SMALL LETTER A
+	{ 1, 0x0431, 0x62 }, // б CYRILLIC SMALL LETTER BE
+	{ 1, 0x0446, 0x63 }, // ц CYRILLIC SMALL LETTER TSE
+	{ 1, 0x0434, 0x64 }, // д CYRILLIC SMALL LETTER DE
+	{ 1, 0x0435, 0x65 }, // е CYRILLIC SMALL LETTER IE
+	{ 1, 0x0444, 0x66 }, // ф CYRILLIC SMALL LETTER EF
+	{ 1, 0x0433, 0x67 }, // г CYRILLIC SMALL LETTER GHE
+	{ 1, 0x0445, 0x68 }, // х CYRILLIC SMALL LETTER HA
+	{ 1, 0x0438, 0x69 }, // и CYRILLIC SMALL LETTER I
+	{ 1, 0x0458, 0x6a }, // ј CYRILLIC SMALL LETTER JE
+	{ 1, 0x043a, 0x6b }, // к CYRILLIC SMALL LETTER KA
+	{ 1, 0x043b, 0x6c }, // л CYRILLIC SMALL LETTER EL
+	{ 1, 0x043c, 0x6d }, // м CYRILLIC SMALL LETTER EM
+	{ 1, 0x043d, 0x6e }, // н CYRILLIC SMALL LETTER EN
+	{ 1, 0x043e, 0x6f }, // о CYRILLIC SMALL LETTER O
+	{ 1, 0x043f, 0x70 }, // п CYRILLIC SMALL LETTER PE
+	{ 1, 0x045c, 0x71 }, // ќ CYRILLIC SMALL LETTER KJE
+	{ 1, 0x0440, 0x72 }, // р CYRILLIC SMALL LETTER ER
+	{ 1, 0x0441, 0x73 }, // с CYRILLIC SMALL LETTER ES
+	{ 1, 0x0442, 0x74 }, // т CYRILLIC SMALL LETTER TE
+	{ 1, 0x0443, 0x75 }, // у CYRILLIC SMALL LETTER U
+	{ 1, 0x0432, 0x76 }, // в CYRILLIC SMALL LETTER VE
+	{ 1, 0x0453, 0x77 }, // ѓ CYRILLIC SMALL LETTER GJE
+	{ 1, 0x0459, 0x78 }, // љ CYRILLIC SMALL LETTER LJE
+	{ 1, 0x045a, 0x79 }, // њ CYRILLIC SMALL LETTER NJE
+	{ 1, 0x0437, 0x7a }, // з CYRILLIC SMALL LETTER ZE
+	{ 1, 0x045b, 0x7b }, // ћ CYRILLIC SMALL LETTER TSHE
+	{ 1, 0x0436, 0x7c }, // ж CYRILLIC SMALL LETTER ZHE
+	{ 1, 0x0452, 0x7d }, // ђ CYRILLIC SMALL LETTER DJE
+	{ 1, 0x0448, 0x7e }, // ш CYRILLIC SMALL LETTER SHA
+
+	// 2 Cyrillic G0 2 Russian/Bulgarian
+	{ 2, 0x044b, 0x26 }, // ы CYRILLIC SMALL LETTER YERU
+	{ 2, 0x042e, 0x40 }, // Ю CYRILLIC CAPITAL LETTER YU
+	{ 2, 0x0410, 0x41 }, // А CYRILLIC CAPITAL LETTER A
+	{ 2, 0x0411, 0x42 }, // Б CYRILLIC CAPITAL LETTER BE
+	{ 2, 0x0426, 0x43 }, // Ц CYRILLIC CAPITAL LETTER TSE
+	{ 2, 0x0414, 0x44 }, // Д CYRILLIC CAPITAL LETTER DE
+	{ 2, 0x0415, 0x45 }, // Е CYRILLIC CAPITAL LETTER IE
+	{ 2, 0x0424, 0x46 }, // Ф CYRILLIC CAPITAL LETTER EF
+	{ 2, 0x0413, 0x47 }, // Г CYRILLIC CAPITAL LETTER GHE
+	{ 2, 0x0425, 0x48 }, // Х CYRILLIC CAPITAL LETTER HA
+	{ 2, 0x0418, 0x49 }, // И CYRILLIC CAPITAL LETTER I
+	{ 2, 0x0419, 0x4a }, // Й CYRILLIC CAPITAL LETTER SHORT I
+	{ 2, 0x041a, 0x4b }, // К CYRILLIC CAPITAL LETTER KA
+	{ 2, 0x041b, 0x4c }, // Л CYRILLIC CAPITAL LETTER EL
+	{ 2, 0x041c, 0x4d }, // М CYRILLIC CAPITAL LETTER EM
+	{ 2, 0x041d, 0x4e }, // Н CYRILLIC CAPITAL LETTER EN
+	{ 2, 0x041e, 0x4f }, // О CYRILLIC CAPITAL LETTER O
+	{ 2, 0x041f, 0x50 }, // П CYRILLIC CAPITAL LETTER PE
+	{ 2, 0x042f, 0x51 }, // Я CYRILLIC CAPITAL LETTER YA
+	{ 2, 0x0420, 0x52 }, // Р CYRILLIC CAPITAL LETTER ER
+	{ 2, 0x0421, 0x53 }, // С CYRILLIC CAPITAL LETTER ES
+	{ 2, 0x0422, 0x54 }, // Т CYRILLIC CAPITAL LETTER TE
+	{ 2, 0x0423, 0x55 }, // У CYRILLIC CAPITAL LETTER U
+	{ 2, 0x0416, 0x56 }, // Ж CYRILLIC CAPITAL LETTER ZHE
+	{ 2, 0x0412, 0x57 }, // В CYRILLIC CAPITAL LETTER VE
+	{ 2, 0x042c, 0x58 }, // Ь CYRILLIC CAPITAL LETTER SOFT SIGN
+	{ 2, 0x042a, 0x59 }, // Ъ CYRILLIC CAPITAL LETTER HARD SIGN
+	{ 2, 0x0417, 0x5a }, // З CYRILLIC CAPITAL LETTER ZE
+	{ 2, 0x0428, 0x5b }, // Ш CYRILLIC CAPITAL LETTER SHA
+	{ 2, 0x042d, 0x5c }, // Э CYRILLIC CAPITAL LETTER E
+	{ 2, 0x0429, 0x5d }, // Щ CYRILLIC CAPITAL LETTER SHCHA
+	{ 2, 0x0427, 0x5e }, // Ч CYRILLIC CAPITAL LETTER CHE
+	{ 2, 0x042b, 0x5f }, // Ы CYRILLIC CAPITAL LETTER YERU
+	{ 2, 0x044e, 0x60 }, // ю CYRILLIC SMALL LETTER YU
+	{ 2, 0x0430, 0x61 }, // а CYRILLIC SMALL LETTER A
+	{ 2, 0x0431, 0x62 }, // б CYRILLIC SMALL LETTER BE
+	{ 2, 0x0446, 0x63 }, // ц CYRILLIC SMALL LETTER TSE
+	{ 2, 0x0434, 0x64 }, // д CYRILLIC SMALL LETTER DE
+	{ 2, 0x0435, 0x65 }, // е CYRILLIC SMALL LETTER IE
+	{ 2, 0x0444, 0x66 }, // ф CYRILLIC SMALL LETTER EF
+	{ 2, 0x0433, 0x67 }, // г CYRILLIC SMALL LETTER GHE
+	{ 2, 0x0445, 0x68 }, // х CYRILLIC SMALL LETTER HA
+	{ 2, 0x0438, 0x69 }, // и CYRILLIC SMALL LETTER I
+	{ 2, 0x0439, 0x6a }, // й CYRILLIC SMALL LETTER SHORT I
+	{ 2, 0x043a, 0x6b }, // к CYRILLIC SMALL LETTER KA
+	{ 2, 0x043b, 0x6c }, // л CYRILLIC SMALL LETTER EL
+	{ 2, 0x043c, 0x6d }, // м CYRILLIC SMALL LETTER EM
+	{ 2, 0x043d, 0x6e }, // н CYRILLIC SMALL LETTER EN
+	{ 2, 0x043e, 0x6f }, // о CYRILLIC SMALL LETTER O
+	{ 2, 0x043f, 0x70 }, // п CYRILLIC SMALL LETTER PE
+	{ 2, 0x044f, 0x71 }, // я CYRILLIC SMALL LETTER YA
+	{ 2, 0x0440, 0x72 }, // р CYRILLIC SMALL LETTER ER
+	{ 2, 0x0441, 0x73 }, // с CYRILLIC SMALL LETTER ES
+	{ 2, 0x0442, 0x74 }, // т CYRILLIC SMALL LETTER TE
+	{ 2, 0x0443, 0x75 }, // у CYRILLIC SMALL LETTER U
+	{ 2, 0x0436, 0x76 }, // ж CYRILLIC SMALL LETTER ZHE
+	{ 2, 0x0432, 0x77 }, // в CYRILLIC SMALL LETTER VE
+	{ 2, 0x044c, 0x78 }, // ь CYRILLIC SMALL LETTER SOFT SIGN
+	{ 2, 0x044a, 0x79 }, // ъ CYRILLIC SMALL LETTER HARD SIGN
+	{ 2, 0x0437, 0x7a }, // з CYRILLIC SMALL LETTER ZE
+	{ 2, 0x0448, 0x7b }, // ш CYRILLIC SMALL LETTER SHA
+	{ 2, 0x044d, 0x7c }, // э CYRILLIC SMALL LETTER E
+	{ 2, 0x0449, 0x7d }, // щ CYRILLIC SMALL LETTER SHCHA
+	{ 2, 0x0447, 0x7e }, // ч CYRILLIC SMALL LETTER CHE
+
+	// 3 Cyrillic G0 3 Ukranian
+	{ 3, 0x0457, 0x26 }, // ї CYRILLIC SMALL LETTER YI
+	{ 3, 0x042e, 0x40 }, // Ю CYRILLIC CAPITAL LETTER YU
+	{ 3, 0x0410, 0x41 }, // А CYRILLIC CAPITAL LETTER A
+	{ 3, 0x0411, 0x42 }, // Б CYRILLIC CAPITAL LETTER BE
+	{ 3, 0x0426, 0x43 }, // Ц CYRILLIC CAPITAL LETTER TSE
+	{ 3, 0x0414, 0x44 }, // Д CYRILLIC CAPITAL LETTER DE
+	{ 3, 0x0415, 0x45 }, // Е CYRILLIC CAPITAL LETTER IE
+	{ 3, 0x0424, 0x46 }, // Ф CYRILLIC CAPITAL LETTER EF
+	{ 3, 0x0413, 0x47 }, // Г CYRILLIC CAPITAL LETTER GHE
+	{ 3, 0x0425, 0x48 }, // Х CYRILLIC CAPITAL LETTER HA
+	{ 3, 0x0418, 0x49 }, // И CYRILLIC CAPITAL LETTER I
+	{ 3, 0x0419, 0x4a }, // Й CYRILLIC CAPITAL LETTER SHORT I
+	{ 3, 0x041a, 0x4b }, // К CYRILLIC CAPITAL LETTER KA
+	{ 3, 0x041b, 0x4c }, // Л CYRILLIC CAPITAL LETTER EL
+	{ 3, 0x041c, 0x4d }, // М CYRILLIC CAPITAL LETTER EM
+	{ 3, 0x041d, 0x4e }, // Н CYRILLIC CAPITAL LETTER EN
+	{ 3, 0x041e, 0x4f }, // О CYRILLIC CAPITAL LETTER O
+	{ 3, 0x041f, 0x50 }, // П CYRILLIC CAPITAL LETTER PE
+	{ 3, 0x042f, 0x51 }, // Я CYRILLIC CAPITAL LETTER YA
+	{ 3, 0x0420, 0x52 }, // Р CYRILLIC CAPITAL LETTER ER
+	{ 3, 0x0421, 0x53 }, // С CYRILLIC CAPITAL LETTER ES
+	{ 3, 0x0422, 0x54 }, // Т CYRILLIC CAPITAL LETTER TE
+	{ 3, 0x0423, 0x55 }, // У CYRILLIC CAPITAL LETTER U
+	{ 3, 0x0416, 0x56 }, // Ж CYRILLIC CAPITAL LETTER ZHE
+	{ 3, 0x0412, 0x57 }, // В CYRILLIC CAPITAL LETTER VE
+	{ 3, 0x042c, 0x58 }, // Ь CYRILLIC CAPITAL LETTER SOFT SIGN
+	{ 3, 0x0406, 0x59 }, // І CYRILLIC CAPITAL LETTER BYELORUSSIAN-UKRAINIAN I
+	{ 3, 0x0417, 0x5a }, // З CYRILLIC CAPITAL LETTER ZE
+	{ 3, 0x0428, 0x5b }, // Ш CYRILLIC CAPITAL LETTER SHA
+	{ 3, 0x0404, 0x5c }, // Є CYRILLIC CAPITAL LETTER UKRAINIAN IE
+	{ 3, 0x0429, 0x5d }, // Щ CYRILLIC CAPITAL LETTER SHCHA
+	{ 3, 0x0427, 0x5e }, // Ч CYRILLIC CAPITAL LETTER CHE
+	{ 3, 0x0407, 0x5f }, // Ї CYRILLIC CAPITAL LETTER YI
+	{ 3, 0x044e, 0x60 }, // ю CYRILLIC SMALL LETTER YU
+	{ 3, 0x0430, 0x61 }, // а CYRILLIC SMALL LETTER A
+	{ 3, 0x0431, 0x62 }, // б CYRILLIC SMALL LETTER BE
+	{ 3, 0x0446, 0x63 }, // ц CYRILLIC SMALL LETTER TSE
+	{ 3, 0x0434, 0x64 }, // д CYRILLIC SMALL LETTER DE
+	{ 3, 0x0435, 0x65 }, // е CYRILLIC SMALL LETTER IE
+	{ 3, 0x0444, 0x66 }, // ф CYRILLIC SMALL LETTER EF
+	{ 3, 0x0433, 0x67 }, // г CYRILLIC SMALL LETTER GHE
+	{ 3, 0x0445, 0x68 }, // х CYRILLIC SMALL LETTER HA
+	{ 3, 0x0438, 0x69 }, // и CYRILLIC SMALL LETTER I
+	{ 3, 0x0439, 0x6a }, // й CYRILLIC SMALL LETTER SHORT I
+	{ 3, 0x043a, 0x6b }, // к CYRILLIC SMALL LETTER KA
+	{ 3, 0x043b, 0x6c }, // л CYRILLIC SMALL LETTER EL
+	{ 3, 0x043c, 0x6d }, // м CYRILLIC SMALL LETTER EM
+	{ 3, 0x043d, 0x6e }, // н CYRILLIC SMALL LETTER EN
+	{ 3, 0x043e, 0x6f }, // о CYRILLIC SMALL LETTER O
+	{ 3, 0x043f, 0x70 }, // п CYRILLIC SMALL LETTER PE
+	{ 3, 0x044f, 0x71 }, // я CYRILLIC SMALL LETTER YA
+	{ 3, 0x0440, 0x72 }, // р CYRILLIC SMALL LETTER ER
+	{ 3, 0x0441, 0x73 }, // с CYRILLIC SMALL LETTER ES
+	{ 3, 0x0442, 0x74 }, // т CYRILLIC SMALL LETTER TE
+	{ 3, 0x0443, 0x75 }, // у CYRILLIC SMALL LETTER U
+	{ 3, 0x0436, 0x76 }, // ж CYRILLIC SMALL LETTER ZHE
+	{ 3, 0x0432, 0x77 }, // в CYRILLIC SMALL LETTER VE
+	{ 3, 0x044c, 0x78 }, // ь CYRILLIC SMALL LETTER SOFT SIGN
+	{ 3, 0x0456, 0x79 }, // і CYRILLIC SMALL LETTER BYELORUSSIAN-UKRAINIAN I
+	{ 3, 0x0437, 0x7a }, // з CYRILLIC SMALL LETTER ZE
+	{ 3, 0x0448, 0x7b }, // ш CYRILLIC SMALL LETTER SHA
+	{ 3, 0x0454, 0x7c }, // є CYRILLIC SMALL LETTER UKRAINIAN IE
+	{ 3, 0x0449, 0x7d }, // щ CYRILLIC SMALL LETTER SHCHA
+	{ 3, 0x0447, 0x7e }, // ч CYRILLIC SMALL LETTER CHE
+
+	// 4 Greek
+	{ 4, 0x0390, 0x40 }, // ΐ GREEK SMALL LETTER IOTA WITH DIALYTIKA AND TONOS
+	{ 4, 0x0391, 0x41 }, // Α GREEK CAPITAL LETTER ALPHA
+	{ 4, 0x0392, 0x42 }, // Β GREEK CAPITAL LETTER BETA
+	{ 4, 0x0393, 0x43 }, // Γ GREEK CAPITAL LETTER GAMMA
+	{ 4, 0x0394, 0x44 }, // Δ GREEK CAPITAL LETTER DELTA
+	{ 4, 0x0395, 0x45 }, // Ε GREEK CAPITAL LETTER EPSILON
+	{ 4, 0x0396, 0x46 }, // Ζ GREEK CAPITAL LETTER ZETA
+	{ 4, 0x0397, 0x47 }, // Η GREEK CAPITAL LETTER ETA
+	{ 4, 0x0398, 0x48 }, // Θ GREEK CAPITAL LETTER THETA
+	{ 4, 0x0399, 0x49 }, // Ι GREEK CAPITAL LETTER IOTA
+	{ 4, 0x039a, 0x4a }, // Κ GREEK CAPITAL LETTER KAPPA
+	{ 4, 0x039b, 0x4b }, // Λ GREEK CAPITAL LETTER LAMBDA
+	{ 4, 0x039c, 0x4c }, // Μ GREEK CAPITAL LETTER MU
+	{ 4, 0x039d, 0x4d }, // Ν GREEK CAPITAL LETTER NU
+	{ 4, 0x039e, 0x4e }, // Ξ GREEK CAPITAL LETTER XI
+	{ 4, 0x039f, 0x4f }, // Ο GREEK CAPITAL LETTER OMICRON
+	{ 4, 0x03a0, 0x50 }, // Π GREEK CAPITAL LETTER PI
+	{ 4, 0x03a1, 0x51 }, // Ρ GREEK CAPITAL LETTER RHO
+	{ 4, 0x03a3, 0x53 }, // Σ GREEK CAPITAL LETTER SIGMA
+	{ 4, 0x03a4, 0x54 }, // Τ GREEK CAPITAL LETTER TAU
+	{ 4, 0x03a5, 0x55 }, // Υ GREEK CAPITAL LETTER UPSILON
+	{ 4, 0x03a6, 0x56 }, // Φ GREEK CAPITAL LETTER PHI
+	{ 4, 0x03a7, 0x57 }, // Χ GREEK CAPITAL LETTER CHI
+	{ 4, 0x03a8, 0x58 }, // Ψ GREEK CAPITAL LETTER PSI
+	{ 4, 0x03a9, 0x59 }, // Ω GREEK CAPITAL LETTER OMEGA
+	{ 4, 0x03aa, 0x5a }, // Ϊ GREEK CAPITAL LETTER IOTA WITH DIALYTIKA
+	{ 4, 0x03ab, 0x5b }, // Ϋ GREEK CAPITAL LETTER UPSILON WITH DIALYTIKA
+	{ 4, 0x03ac, 0x5c }, // ά GREEK SMALL LETTER ALPHA WITH TONOS
+	{ 4, 0x03ad, 0x5d }, // έ GREEK SMALL LETTER EPSILON WITH TONOS
+	{ 4, 0x03ae, 0x5e }, // ή GREEK SMALL LETTER ETA WITH TONOS
+	{ 4, 0x03af, 0x5f }, // ί GREEK SMALL LETTER IOTO WITH TONOS
+	{ 4, 0x03b0, 0x60 }, // ΰ GREEK SMALL LETTER UPSILON WITH DIALYTIKA AND TONOS
+	{ 4, 0x03b1, 0x61 }, // α GREEK SMALL LETTER ALPHA
+	{ 4, 0x03b2, 0x62 }, // β GREEK SMALL LETTER BETA
+	{ 4, 0x03b3, 0x63 }, // γ GREEK SMALL LETTER GAMMA
+	{ 4, 0x03b4, 0x64 }, // δ GREEK SMALL LETTER DELTA
+	{ 4, 0x03b5, 0x65 }, // ε GREEK SMALL LETTER EPSILON
+	{ 4, 0x03b6, 0x66 }, // ζ GREEK SMALL LETTER ZETA
+	{ 4, 0x03b7, 0x67 }, // η GREEK SMALL LETTER ETA
+	{ 4, 0x03b8, 0x68 }, // θ GREEK SMALL LETTER THETA
+	{ 4, 0x03b9, 0x69 }, // ι GREEK SMALL LETTER IOTA
+	{ 4, 0x03ba, 0x6a }, // κ GREEK SMALL LETTER KAPPA
+	{ 4, 0x03bb, 0x6b }, // λ GREEK SMALL LETTER LAMBDA
+	{ 4, 0x03bc, 0x6c }, // μ GREEK SMALL LETTER MU
+	{ 4, 0x03bd, 0x6d }, // ν GREEK SMALL LETTER NU
+	{ 4, 0x03be, 0x6e }, // ξ GREEK SMALL LETTER XI
+	{ 4, 0x03bf, 0x6f }, // ο GREEK SMALL LETTER OMICRON
+	{ 4, 0x03c0, 0x70 }, // π GREEK SMALL LETTER PI
+	{ 4, 0x03c1, 0x71 }, // ρ GREEK SMALL LETTER RHO
+	{ 4, 0x03c2, 0x72 }, // ς GREEK SMALL LETTER FINAL SIGMA
+	{ 4, 0x03c3, 0x73 }, // σ GREEK SMALL LETTER SIGMA
+	{ 4, 0x03c4, 0x74 }, // τ GREEK SMALL LETTER TAU
+	{ 4, 0x03c5, 0x75 }, // υ GREEK SMALL LETTER UPSILON
+	{ 4, 0x03c6, 0x76 }, // φ GREEK SMALL LETTER PHI
+	{ 4, 0x03c7, 0x77 }, // χ GREEK SMALL LETTER CHI
+	{ 4, 0x03c8, 0x78 }, // ψ GREEK SMALL LETTER PSI
+	{ 4, 0x03c9, 0x79 }, // ω GREEK SMALL LETTER OMEGA
+	{ 4, 0x03ca, 0x7a }, // ϊ GREEK SMALL LETTER IOTA WITH DIALYTIKA
+	{ 4, 0x03cb, 0x7b }, // ϋ GREEK SMALL LETTER UPSILON WITH DIALYTIKA
+	{ 4, 0x03cc, 0x7c }, // ό GREEK SMALL LETTER OMICRON WITH TONOS
+	{ 4, 0x03cd, 0x7d }, // ύ GREEK SMALL LETTER UPSILON WITH TONOS
+	{ 4, 0x03ce, 0x7e }, // ώ GREEK SMALL LETTER OMEGA WITH TONOS
+
+	// TODO 5 Arabic G0
+
+	// 6 Hebrew G0
+	{ 6, 0x05d0, 0x60 }, // א HEBREW LETTER ALEF
+	{ 6, 0x05d1, 0x61 }, // ב HEBREW LETTER BET
+	{ 6, 0x05d2, 0x62 }, // ג HEBREW LETTER GIMEL
+	{ 6, 0x05d3, 0x63 }, // ד HEBREW LETTER DALET
+	{ 6, 0x05d4, 0x64 }, // ה HEBREW LETTER HE
+	{ 6, 0x05d5, 0x65 }, // ו HEBREW LETTER VAV
+	{ 6, 0x05d6, 0x66 }, // ז HEBREW LETTER ZAYIN
+	{ 6, 0x05d7, 0x67 }, // ח HEBREW LETTER HET
+	{ 6, 0x05d8, 0x68 }, // ט HEBREW LETTER TET
+	{ 6, 0x05d9, 0x69 }, // י HEBREW LETTER YOD
+	{ 6, 0x05da, 0x6a }, // ך HEBREW LETTER FINAL KAF
+	{ 6, 0x05db, 0x6b }, // כ HEBREW LETTER KAF
+	{ 6, 0x05dc, 0x6c }, // ל HEBREW LETTER LAMED
+	{ 6, 0x05dd, 0x6d }, // ם HEBREW LETTER FINAL MEM
+	{ 6, 0x05de, 0x6e }, // מ HEBREW LETTER MEM
+	{ 6, 0x05df, 0x6f }, // ן HEBREW LETTER FINAL NUN
+	{ 6, 0x05e0, 0x70 }, // נ HEBREW LETTER NUN
+	{ 6, 0x05e1, 0x71 }, // ס HEBREW LETTER SAMEKH
+	{ 6, 0x05e2, 0x72 }, // ע HEBREW LETTER AYIN
+	{ 6, 0x05e3, 0x73 }, // ף HEBREW LETTER FINAL PE
+	{ 6, 0x05e4, 0x74 }, // פ HEBREW LETTER PE
+	{ 6, 0x05e5, 0x75 }, // ץ HEBREW LETTER FINAL TSADI
+	{ 6, 0x05e6, 0x76 }, // צ HEBREW LETTER TSADI
+	{ 6, 0x05e7, 0x77 }, // ק HEBREW LETTER QOF
+	{ 6, 0x05e8, 0x78 }, // ר HEBREW LETTER RESH
+	{ 6, 0x05e9, 0x79 }, // ש HEBREW LETTER SHIN
+	{ 6, 0x05ea, 0x7a }, // ת HEBREW LETTER TAV
+	{ 6, 0x20aa, 0x7b }, // ₪ NEW SHEQEL SIGN
+	{ 6, 0x00be, 0x7d }, // ½ VULGAR FRACTION THREE QUARTERS
+	{ 6, 0x00f7, 0x7e }, // ÷ DIVISION SIGN
+
+	// Only used by X/26 enhancements, not directly by keyboard
+	// 7 Latin G2
+	// 8 Cyrillic G2
+	// 9 Greek G2
+	// 10 Arabic G2
+
+	// 11 Czech/Slovak
+	{ 11, 0x016f, 0x24 }, // ů LATIN SMALL LETTER U WITH RING ABOVE
+	{ 11, 0x010d, 0x40 }, // č LATIN SMALL LETTER C WITH CARON
+	{ 11, 0x0165, 0x5b }, // ť LATIN SMALL LETTER T WITH CARON
+	{ 11, 0x017e, 0x5c }, // ž LATIN SMALL LETTER Z WITH CARON
+	{ 11, 0x00fd, 0x5d }, // ý LATIN SMALL LETTER Y WITH ACUTE
+	{ 11, 0x00ed, 0x5e }, // í LATIN SMALL LETTER I WITH ACUTE
+	{ 11, 0x0159, 0x5f }, // ř LATIN SMALL LETTER R WITH CARON
+	{ 11, 0x00e9, 0x60 }, // é LATIN SMALL LETTER E WITH ACUTE
+	{ 11, 0x00e1, 0x7b }, // á LATIN SMALL LETTER A WITH ACUTE
+	{ 11, 0x011b, 0x7c }, // ě LATIN SMALL LETTER E WITH CARON
+	{ 11, 0x00fa, 0x7d }, // ú LATIN SMALL LETTER U WITH ACUTE
+	{ 11, 0x0161, 0x7e }, // š LATIN SMALL LETTER S WITH CARON
+
+	// 12 English
+	{ 12, 0x00a3, 0x23 }, // £ POUND SIGN
+	{ 12, 0x0023, 0x5f }, // # NUMBER SIGN
+	{ 12, 0x005f, 0x60 }, // ─ LOW LINE - rendered as U+2500 BOX DRAWINGS LIGHT HORIZONTAL
+
+	{ 12, 0x00bc, 0x7b }, // ¼ VULGAR FRACTION ONE QUARTER
+	{ 12, 0x00bd, 0x5c }, // ½ VULGAR FRACTION ONE HALF
+	{ 12, 0x00be, 0x7b }, // ¾ VULGAR FRACTION THREE QUARTERS
+	{ 12, 0x00f7, 0x7e }, // ÷ DIVISION SIGN
+
+	// 13 Estonian
+	{ 13, 0x00f5, 0x24 }, // õ LATIN SMALL LETTER O WITH TILDE
+	{ 13, 0x0160, 0x40 }, // Š LATIN CAPITAL LETTER S WITH CARON
+	{ 13, 0x00c4, 0x5b }, // Ä LATIN CAPITAL LETTER A WITH DIAERESIS
+	{ 13, 0x00d6, 0x5c }, // Ö LATIN CAPITAL LETTER O WITH DIAERESIS
+	{ 13, 0x017d, 0x5d }, // Ž LATIN CAPITAL LETTER Z WITH CARON
+	{ 13, 0x00dc, 0x5e }, // Ü LATIN CAPITAL LETTER U WITH DIAERESIS
+	{ 13, 0x00d5, 0x5f }, // Õ LATIN CAPITAL LETTER O WITH TILDE
+	{ 13, 0x0161, 0x60 }, // š LATIN SMALL LETTER S WITH CARON
+	{ 13, 0x00e4, 0x7b }, // ä LATIN SMALL LETTER A WITH DIAERESIS
+	{ 13, 0x00f6, 0x7c }, // ö LATIN SMALL LETTER O WITH DIAERESIS
+	{ 13, 0x017e, 0x7d }, // ž LATIN SMALL LETTER Z WITH CARON
+	{ 13, 0x00fc, 0x7e }, // ü LATIN SMALL LETTER U WITH DIAERESIS
+
+	// 14 French - aze qsd wxc
+	{ 14, 0x00e9, 0x23 }, // é LATIN SMALL LETTER E WITH ACUTE
+	{ 14, 0x00ef, 0x24 }, // ï LATIN SMALL LETTER I WITH DIAERESIS
+	{ 14, 0x00e0, 0x40 }, // à LATIN SMALL LETTER A WITH GRAVE
+	{ 14, 0x00eb, 0x5b }, // ë LATIN SMALL LETTER E WITH DIAERESIS
+	{ 14, 0x00ea, 0x5c }, // ê LATIN SMALL LETTER E WITH CIRCUMFLEX
+	{ 14, 0x00f9, 0x5d }, // ù LATIN SMALL LETTER U WITH GRAVE
+	{ 14, 0x00ee, 0x5e }, // î LATIN SMALL LETTER I WITH CIRCUMFLEX
+	{ 14, 0x0023, 0x5f }, // # NUMBER SIGN
+	{ 14, 0x00e8, 0x60 }, // è LATIN SMALL LETTER E WITH GRAVE
+	{ 14, 0x00e2, 0x7b }, // â LATIN SMALL LETTER A WITH CIRCUMFLEX
+	{ 14, 0x00f4, 0x7c }, // ô LATIN SMALL LETTER O WITH CIRCUMFLEX
+	{ 14, 0x00fb, 0x7d }, // û LATIN SMALL LETTER U WITH CIRCUMFLEX
+	{ 14, 0x00e7, 0x7e }, // ç LATIN SMALL LETTER C WITH CEDILLA
+
+	// 15 German
+	{ 15, 0x00a7, 0x40 }, // § SECTION SIGN
+	{ 15, 0x00c4, 0x5b }, // Ä LATIN CAPITAL LETTER A WITH DIAERESIS
+	{ 15, 0x00d6, 0x5c }, // Ö LATIN CAPITAL LETTER O WITH DIAERESIS
+	{ 15, 0x00dc, 0x5d }, // Ü LATIN CAPITAL LETTER U WITH DIAERESIS
+	{ 15, 0x00b0, 0x60 }, // ° DEGREE SIGN
+	{ 15, 0x00e4, 0x7b }, // ä LATIN SMALL LETTER A WITH DIAERESIS
+	{ 15, 0x00f6, 0x7c }, // ö LATIN SMALL LETTER O WITH DIAERESIS
+	{ 15, 0x00fc, 0x7d }, // ü LATIN SMALL LETTER U WITH DIAERESIS
+	{ 15, 0x00df, 0x7e }, // ß LATIN SMALL LETTER SHARP S
+
+	// 16 Italian
+	{ 16, 0x00a3, 0x23 }, // £ POUND SIGN
+	{ 16, 0x00e9, 0x40 }, // é LATIN SMALL LETTER E WITH ACUTE
+	{ 16, 0x00b0, 0x5b }, // ° DEGREE SIGN
+	{ 16, 0x00e7, 0x5c }, // ç LATIN SMALL LETTER C WITH CEDILLA
+	{ 16, 0x0023, 0x5f }, // # NUMBER SIGN
+	{ 16, 0x00f9, 0x60 }, // ù LATIN SMALL LETTER U WITH GRAVE
+	{ 16, 0x00e0, 0x7b }, // à LATIN SMALL LETTER A WITH GRAVE
+	{ 16, 0x00f2, 0x7c }, // ò LATIN SMALL LETTER O WITH GRAVE
+	{ 16, 0x00e8, 0x7d }, // è LATIN SMALL LETTER E WITH GRAVE
+	{ 16, 0x00ec, 0x7e }, // ì LATIN SMALL LETTER I WITH GRAVE
+
+	// 17 Lettish/Lithuanian
+	{ 17, 0x0160, 0x40 }, // Š LATIN CAPITAL LETTER S WITH CARON
+	{ 17, 0x0117, 0x5b }, // ė LATIN SMALL LETTER E WITH DOT ABOVE
+	{ 17, 0x0119, 0x5c }, // ę LATIN SMALL LETTER E WITH OGONEK
+	{ 17, 0x017d, 0x5d }, // Ž LATIN CAPITAL LETTER Z WITH CARON
+	{ 17, 0x010d, 0x5e }, // č LATIN SMALL LETTER C WITH CARON
+	{ 17, 0x016b, 0x5f }, // ū LATIN SMALL LETTER U WITH MACRON
+	{ 17, 0x0161, 0x60 }, // š LATIN SMALL LETTER S WITH CARON
+	{ 17, 0x0105, 0x7b }, // ą LATIN SMALL LETTER A WITH OGONEK
+	{ 17, 0x0173, 0x7c }, // ų LATIN SMALL LETTER U WITH OGONEK
+	{ 17, 0x017e, 0x7d }, // ž LATIN SMALL LETTER Z WITH CARON
+	{ 17, 0x012f, 0x7e }, // į LATIN SMALL LETTER I WITH OGONEK
+
+	// 18 Polish
+	{ 18, 0x0144, 0x24 }, // ń LATIN SMALL LETTER N WITH ACUTE
+	{ 18, 0x0105, 0x40 }, // ą LATIN SMALL LETTER A WITH OGONEK
+	{ 18, 0x017b, 0x5b }, // Ż LATIN CAPITAL LETTER Z WITH DOT ABOVE - rendered as U+01B5 ...WITH STROKE
+	{ 18, 0x015a, 0x5c }, // Ś LATIN CAPITAL LETTER S WITH ACUTE
+	{ 18, 0x0141, 0x5d }, // Ł LATIN CAPITAL LETTER L WITH STROKE
+	{ 18, 0x0107, 0x5e }, // ć LATIN SMALL LETTER C WITH ACUTE
+	{ 18, 0x00f3, 0x5f }, // ó LATIN SMALL LETTER O WITH ACUTE
+	{ 18, 0x0119, 0x60 }, // ę LATIN SMALL LETTER E WITH OGONEK
+	{ 18, 0x017c, 0x7b }, // ż LATIN SMALL LETTER Z WITH DOT ABOVE
+	{ 18, 0x015b, 0x7c }, // ś LATIN SMALL LETTER S WITH ACUTE
+	{ 18, 0x0142, 0x7d }, // ł LATIN SMALL LETTER L WITH STROKE
+	{ 18, 0x017a, 0x7e }, // ź LATIN SMALL LETTER Z WITH ACUTE
+
+	// 19 Portuguese/Spanish
+	{ 19, 0x00e7, 0x23 }, // ç LATIN SMALL LETTER C WITH CEDILLA
+	{ 19, 0x00a1, 0x40 }, // ¡ INVERTED EXCLAMATION MARK
+	{ 19, 0x00e1, 0x5b }, // á LATIN SMALL LETTER A WITH ACUTE
+	{ 19, 0x00e9, 0x5c }, // é LATIN SMALL LETTER E WITH ACUTE
+	{ 19, 0x00ed, 0x5d }, // í LATIN SMALL LETTER I WITH ACUTE
+	{ 19, 0x00f3, 0x5e }, // ó LATIN SMALL LETTER O WITH ACUTE
+	{ 19, 0x00fa, 0x5f }, // ú LATIN SMALL LETTER U WITH ACUTE
+	{ 19, 0x00bf, 0x60 }, // ¿ INVERTED QUESTION MARK
+	{ 19, 0x00fc, 0x7b }, // ü LATIN SMALL LETTER U WITH DIAERESIS
+	{ 19, 0x00f1, 0x7c }, // ñ LATIN SMALL LETTER N WITH TILDE
+	{ 19, 0x00e8, 0x7d }, // è LATIN SMALL LETTER E WITH GRAVE
+	{ 19, 0x00e0, 0x7e }, // à LATIN SMALL LETTER A WITH GRAVE
+
+	// 20 Rumanian
+	{ 20, 0x00a4, 0x24 }, // ¤ CURRENCY SIGN
+	{ 20, 0x021a, 0x40 }, // Ț LATIN CAPITAL LETTER T WITH COMMA BELOW
+	{ 20, 0x00c2, 0x5b }, // Â LATIN CAPITAL LETTER A WITH CIRCUMFLEX
+	{ 20, 0x0218, 0x5c }, // Ș LATIN CAPITAL LETTER S WITH COMMA BELOW
+	{ 20, 0x0102, 0x5d }, // Ă LATIN CAPITAL LETTER A WITH BREVE
+	{ 20, 0x00c3, 0x5e }, // Î LATIN CAPITAL LETTER I WITH CIRCUMFLEX
+	{ 20, 0x0131, 0x5f }, // ı LATIN SMALL LETTER DOTLESS I
+	{ 20, 0x021b, 0x60 }, // ț LATIN SMALL LETTER T WITH COMMA BELOW
+	{ 20, 0x00e2, 0x7b }, // â LATIN SMALL LETTER A WITH CIRCUMFLEX
+	{ 20, 0x0219, 0x7c }, // ș LATIN SMALL LETTER S WITH COMMA BELOW
+	{ 20, 0x0103, 0x7d }, // ă LATIN SMALL LETTER A WITH BREVE
+	{ 20, 0x00ee, 0x7e }, // î LATIN SMALL LETTER I WITH CIRCUMFLEX
+
+	// 21 Serbian/Croatian/Slovenian
+	{ 21, 0x00cb, 0x24 }, // Ë LATIN CAPITAL LETTER E WITH DIAERESIS
+	{ 21, 0x010c, 0x40 }, // Č LATIN CAPITAL LETTER C WITH CARON
+	{ 21, 0x0106, 0x5b }, // Ć LATIN CAPITAL LETTER C WITH ACUTE
+	{ 21, 0x017d, 0x5c }, // Ž LATIN CAPITAL LETTER Z WITH CARON
+	{ 21, 0x0110, 0x5d }, // Đ LATIN CAPITAL LETTER D WITH STROKE
+	{ 21, 0x0160, 0x5e }, // Š LATIN CAPITAL LETTER S WITH CARON
+	{ 21, 0x00eb, 0x5f }, // ë LATIN SMALL LETTER E WITH DIAERESIS
+	{ 21, 0x010d, 0x60 }, // č LATIN SMALL LETTER C WITH CARON
+	{ 21, 0x0107, 0x7b }, // ć LATIN SMALL LETTER C WITH ACUTE
+	{ 21, 0x017e, 0x7c }, // ž LATIN SMALL LETTER Z WITH CARON
+	{ 21, 0x0111, 0x7d }, // đ LATIN SMALL LETTER D WITH STROKE
+	{ 21, 0x0161, 0x7e }, // š LATIN SMALL LETTER S WITH CARON
+
+	// 22 Swedish/Finnish/Hungarian
+	{ 22, 0x00a4, 0x24 }, // ¤ CURRENCY SIGN
+	{ 22, 0x00c9, 0x40 }, // É LATIN CAPITAL LETTER E WITH ACUTE
+	{ 22, 0x00c4, 0x5b }, // Ä LATIN CAPITAL LETTER A WITH DIAERESIS
+	{ 22, 0x00d6, 0x5c }, // Ö LATIN CAPITAL LETTER O WITH DIAERESIS
+	{ 22, 0x00c5, 0x5d }, // Å LATIN CAPITAL LETTER A WITH RING ABOVE
+	{ 22, 0x00dc, 0x5e }, // Ü LATIN CAPITAL LETTER U WITH DIAERESIS
+	{ 22, 0x00e9, 0x60 }, // é LATIN SMALL LETTER E WITH ACUTE
+	{ 22, 0x00e4, 0x7b }, // ä LATIN SMALL LETTER A WITH DIAERESIS
+	{ 22, 0x00f6, 0x7c }, // ö LATIN SMALL LETTER O WITH DIAERESIS
+	{ 22, 0x00e5, 0x7d }, // å LATIN SMALL LETTER A WITH RING ABOVE
+	{ 22, 0x00fc, 0x7e }, // ü LATIN SMALL LETTER U WITH DIAERESIS
+
+	// 23 Turkish
+	{ 23, 0x20ba, 0x23 }, // ₺ TURKISH LIRA SIGN
+	{ 23, 0x011f, 0x24 }, // ğ LATIN SMALL LETTER G WITH BREVE
+	{ 23, 0x0130, 0x40 }, // İ LATIN CAPITAL LETTER I WITH DOT ABOVE
+	{ 23, 0x015e, 0x5b }, // Ş LATIN CAPITAL LETTER S WITH CEDILLA
+	{ 23, 0x00d6, 0x5c }, // Ö LATIN CAPITAL LETTER O WITH DIAERESIS
+	{ 23, 0x00c7, 0x5d }, // Ç LATIN CAPITAL LETTER C WITH CEDILLA
+	{ 23, 0x00dc, 0x5e }, // Ü LATIN CAPITAL LETTER U WITH DIAERESIS
+	{ 23, 0x011e, 0x5f }, // Ğ LATIN CAPITAL LETTER G WITH BREVE
+	{ 23, 0x0131, 0x60 }, // ı LATIN SMALL LETTER DOTLESS I
+	{ 23, 0x015f, 0x7b }, // ş LATIN SMALL LETTER S WITH CEDILLA
+	{ 23, 0x00f6, 0x7c }, // ö LATIN SMALL LETTER O WITH DIAERESIS
+	{ 23, 0x00e7, 0x7d }, // ç LATIN SMALL LETTER C WITH CEDILLA
+	{ 23, 0x00fc, 0x7e }  // ü LATIN SMALL LETTER U WITH DIAERESIS
+};
+
+static constexpr int s_keymapSize = sizeof(s_keymapEntries) / sizeof(s_keymapEntries[0]);
+
+// Sorted by character set then unicode character at compile time, so lookups are a binary search
+static constexpr std::array<keymapEntry, s_keymapSize> makeSortedKeymap()
+{
+	std::array<keymapEntry, s_keymapSize> result {};
+
+	for (int i=0; i<s_keymapSize; i++) {
+		const keymapEntry entry = s_keymapEntries[i];
+		int j = i;
+
+		for (; j>0 && (result[j-1].charSet > entry.charSet || (result[j-1].charSet == entry.charSet && result[j-1].unicode > entry.unicode)); j--)
+			result[j] = result[j-1];
+		result[j] = entry;
+	}
+
+	return result;
+}
+
+static constexpr std::array<keymapEntry, s_keymapSize> s_sortedKeymap = makeSortedKeymap();
+
+// Where each character set starts in the sorted keymap, with the end of the last one after it
+static constexpr std::array<int, KeymapCharSets+1> makeCharSetStarts()
+{
+	std::array<int, KeymapCharSets+1> result {};
+	int i = 0;
+
+	for (int s=0; s<=KeymapCharSets; s++) {
+		while (i < s_keymapSize && s_sortedKeymap[i].charSet < s)
+			i++;
+		result[s] = i;
+	}
+
+	return result;
+}
+
+static constexpr std::array<int, KeymapCharSets+1> s_charSetStarts = makeCharSetStarts();
+
+// Teletext characters back to unicode characters, 0 where the character isn't remapped.
+// Where more than one unicode character gives the same teletext character the lowest is used.
+static constexpr std::array<std::array<char16_t, 128>, KeymapCharSets> makeReverseKeymap()
+{
+	std::array<std::array<char16_t, 128>, KeymapCharSets> result {};
+
+	for (int i=s_keymapSize-1; i>=0; i--)
+		result[s_sortedKeymap[i].charSet][s_sortedKeymap[i].teletext & 0x7f] = s_sortedKeymap[i].unicode;
+
+	return result;
+}
+
+static constexpr std::array<std::array<char16_t, 128>, KeymapCharSets> s_reverseKeymap = makeReverseKeymap();
+
+char keymapToTeletext(int charSet, QChar unicode)
+{
+	if (charSet < 0 || charSet >= KeymapCharSets)
+		return 0;
+
+	int low = s_charSetStarts[charSet];
+	int high = s_charSetStarts[charSet+1];
+
+	while (low < high) {
+		const int middle = (low + high) / 2;
+
+		if (s_sortedKeymap[middle].unicode < unicode.unicode())
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	if (low < s_charSetStarts[charSet+1] && s_sortedKeymap[low].unicode == unicode.unicode())
+		return s_sortedKeymap[low].teletext;
+
+	return 0;
+}
+
+QChar keymapToUnicode(int charSet, char teletext)
+{
+	if (charSet < 0 || charSet >= KeymapCharSets || teletext < 0)
+		return QChar();
+
+	return QChar(s_reverseKeymap[charSet][teletext]);
+}
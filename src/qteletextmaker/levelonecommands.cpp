@@ -24,14 +24,18 @@
 #include <QImage>
 #include <QMimeData>
 #include <QRegularExpression>
-#include <QSet>
+
+#include <memory>
 
 #include "levelonecommands.h"
 
 #include "document.h"
 #include "keymap.h"
+#include "levelonepage.h"
+#include "undohistory.h"
+#include "x26triplets.h"
 
-LevelOneCommand::LevelOneCommand(TeletextDocument *teletextDocument, QUndoCommand *parent) : QUndoCommand(parent)
+LevelOneCommand::LevelOneCommand(TeletextDocument *teletextDocument, QUndoCommand *parent) : HistoryCommand(parent)
 {
 	m_teletextDocument = teletextDocument;
 	m_subPageIndex = teletextDocument->currentSubPageIndex();
@@ -43,45 +47,52 @@ LevelOneCommand::LevelOneCommand(TeletextDocument *teletextDocument, QUndoComman
 QByteArrayList LevelOneCommand::storeCharacters(int topRow, int leftColumn, int bottomRow, int rightColumn)
 {
 	QByteArrayList result;
+	const int width = rightColumn - leftColumn + 1;
 
-	for (int r=topRow; r<=bottomRow; r++) {
-		QByteArray rowArray;
-
-		for (int c=leftColumn; c<=rightColumn; c++)
-			// Guard against size of pasted block going beyond last line or column
-			if (r < 25 && c < 40)
-				rowArray.append(m_teletextDocument->currentSubPage()->character(r, c));
-			else
-				// Gone beyond last line or column - store a filler character which we won't see
-				// Not sure if this is really necessary as out-of-bounds access might not occur?
-				rowArray.append(0x7f);
+	result.reserve(bottomRow - topRow + 1);
 
-		result.append(rowArray);
-	}
+	for (int r=topRow; r<=bottomRow; r++)
+		// Guard against size of pasted block going beyond last line or column
+		// by storing a filler character there which we won't see
+		if (r < 25 && leftColumn < 40)
+			result.append(m_teletextDocument->currentSubPage()->row(r).mid(leftColumn, width).leftJustified(width, 0x7f));
+		else
+			result.append(QByteArray(width, 0x7f));
 
 	return result;
 }
 
 void LevelOneCommand::retrieveCharacters(int topRow, int leftColumn, const QByteArrayList &storedChars)
 {
-	const int bottomRow = topRow + storedChars.size() - 1;
-	const int rightColumn = leftColumn + storedChars.at(0).size() - 1;
+	// setBlock clips anything beyond the last line or column
+	m_teletextDocument->currentSubPage()->setBlock(topRow, leftColumn, storedChars);
+}
+
+void LevelOneCommand::applyDelta(int topRow, int leftColumn, int bottomRow, int rightColumn, const XorDelta &delta)
+{
+	if (delta.isNull())
+		return;
 
-	int arrayR = 0;
-	int arrayC;
+	const int width = rightColumn - leftColumn + 1;
+	QByteArray block = storeCharacters(topRow, leftColumn, bottomRow, rightColumn).join();
+	QByteArrayList blockRows;
 
-	for (int r=topRow; r<=bottomRow; r++) {
-		arrayC = 0;
-		for (int c=leftColumn; c<=rightColumn; c++)
-			// Guard against size of pasted block going beyond last line or column
-			if (r < 25 && c < 40) {
-				m_teletextDocument->currentSubPage()->setCharacter(r, c, storedChars.at(arrayR).at(arrayC));
+	delta.apply(block);
+	for (int r=0; r<=bottomRow-topRow; r++)
+		blockRows.append(block.mid(r * width, width));
 
-				arrayC++;
-			}
+	retrieveCharacters(topRow, leftColumn, blockRows);
+}
 
-		arrayR++;
-	}
+void LevelOneCommand::applyRowDelta(int r, const XorDelta &delta)
+{
+	if (delta.isNull())
+		return;
+
+	QByteArray rowArray = m_teletextDocument->currentSubPage()->row(r);
+
+	delta.apply(rowArray);
+	m_teletextDocument->currentSubPage()->setRow(r, rowArray);
 }
 
 
@@ -91,9 +102,6 @@ TypeCharacterCommand::TypeCharacterCommand(TeletextDocument *teletextDocument, u
 	m_newCharacter = newCharacter;
 	m_insertMode = insertMode;
 
-	for (int c=0; c<40; c++)
-		m_oldRowContents[c] = m_newRowContents[c] = m_teletextDocument->currentSubPage()->character(m_row, c);
-
 	if (m_insertMode)
 		setText(QObject::tr("insert character"));
 	else
@@ -104,18 +112,21 @@ void TypeCharacterCommand::redo()
 {
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
-	// Only apply the typed character on the first do, m_newRowContents will remember it if we redo
+	// Only apply the typed character on the first do, m_delta will remember it if we redo
 	if (m_firstDo) {
+		const QByteArray oldRowContents = m_teletextDocument->currentSubPage()->row(m_row);
+		QByteArray newRowContents = oldRowContents;
+
 		if (m_insertMode) {
 			// Insert - Move characters rightwards
 			for (int c=39; c>m_columnEnd; c--)
-				m_newRowContents[c] = m_newRowContents[c-1];
+				newRowContents[c] = newRowContents.at(c-1);
 		}
-		m_newRowContents[m_columnEnd] = m_newCharacter;
+		newRowContents[m_columnEnd] = m_newCharacter;
+		m_delta = XorDelta(oldRowContents, newRowContents);
 		m_firstDo = false;
 	}
-	for (int c=0; c<40; c++)
-		m_teletextDocument->currentSubPage()->setCharacter(m_row, c, m_newRowContents[c]);
+	applyRowDelta(m_row, m_delta);
 
 	m_teletextDocument->moveCursor(m_row, m_columnEnd);
 	m_teletextDocument->cursorRight();
@@ -126,8 +137,7 @@ void TypeCharacterCommand::undo()
 {
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
-	for (int c=0; c<40; c++)
-		m_teletextDocument->currentSubPage()->setCharacter(m_row, c, m_oldRowContents[c]);
+	applyRowDelta(m_row, m_delta);
 
 	m_teletextDocument->moveCursor(m_row, m_columnStart);
 	emit m_teletextDocument->contentsChanged();
@@ -142,8 +152,7 @@ bool TypeCharacterCommand::mergeWith(const QUndoCommand *command)
 		return false;
 
 	m_columnEnd = newerCommand->m_columnEnd;
-	for (int c=0; c<40; c++)
-		m_newRowContents[c] = newerCommand->m_newRowContents[c];
+	m_delta.merge(newerCommand->m_delta);
 
 	return true;
 }
@@ -211,9 +220,6 @@ BackspaceKeyCommand::BackspaceKeyCommand(TeletextDocument *teletextDocument, boo
 	m_columnEnd = m_columnStart;
 	m_insertMode = insertMode;
 
-	for (int c=0; c<40; c++)
-		m_oldRowContents[c] = m_newRowContents[c] = m_teletextDocument->currentSubPage()->character(m_row, c);
-
 	setText(QObject::tr("backspace"));
 }
 
@@ -222,19 +228,22 @@ void BackspaceKeyCommand::redo()
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
 	if (m_firstDo) {
+		const QByteArray oldRowContents = m_teletextDocument->currentSubPage()->row(m_row);
+		QByteArray newRowContents = oldRowContents;
+
 		if (m_insertMode) {
 			// Insert - Move characters leftwards and put a space on the far right
 			for (int c=m_columnEnd; c<39; c++)
-				m_newRowContents[c] = m_newRowContents[c+1];
-			m_newRowContents[39] = 0x20;
+				newRowContents[c] = newRowContents.at(c+1);
+			newRowContents[39] = 0x20;
 		} else
 			// Replace - Overwrite backspaced character with a space
-			m_newRowContents[m_columnEnd] = 0x20;
+			newRowContents[m_columnEnd] = 0x20;
+		m_delta = XorDelta(oldRowContents, newRowContents);
 		m_firstDo = false;
 	}
 
-	for (int c=0; c<40; c++)
-		m_teletextDocument->currentSubPage()->setCharacter(m_row, c, m_newRowContents[c]);
+	applyRowDelta(m_row, m_delta);
 
 	m_teletextDocument->moveCursor(m_row, m_columnEnd);
 	emit m_teletextDocument->contentsChanged();
@@ -244,8 +253,7 @@ void BackspaceKeyCommand::undo()
 {
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
-	for (int c=0; c<40; c++)
-		m_teletextDocument->currentSubPage()->setCharacter(m_row, c, m_oldRowContents[c]);
+	applyRowDelta(m_row, m_delta);
 
 	m_teletextDocument->moveCursor(m_row, m_columnStart);
 	m_teletextDocument->cursorRight();
@@ -263,8 +271,7 @@ bool BackspaceKeyCommand::mergeWith(const QUndoCommand *command)
 	// For backspacing m_columnStart is where we began backspacing and m_columnEnd is where we ended backspacing
 	// so m_columnEnd will be less than m_columnStart
 	m_columnEnd = newerCommand->m_columnEnd;
-	for (int c=0; c<40; c++)
-		m_newRowContents[c] = newerCommand->m_newRowContents[c];
+	m_delta.merge(newerCommand->m_delta);
 
 	return true;
 }
@@ -272,9 +279,6 @@ bool BackspaceKeyCommand::mergeWith(const QUndoCommand *command)
 
 DeleteKeyCommand::DeleteKeyCommand(TeletextDocument *teletextDocument, QUndoCommand *parent) : LevelOneCommand(teletextDocument, parent)
 {
-	for (int c=0; c<40; c++)
-		m_oldRowContents[c] = m_newRowContents[c] = m_teletextDocument->currentSubPage()->character(m_row, c);
-
 	setText(QObject::tr("delete"));
 }
 
@@ -282,13 +286,19 @@ void DeleteKeyCommand::redo()
 {
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
-	// Move characters leftwards and put a space on the far right
-	for (int c=m_column; c<39; c++)
-		m_newRowContents[c] = m_newRowContents[c+1];
-	m_newRowContents[39] = 0x20;
+	if (m_firstDo) {
+		const QByteArray oldRowContents = m_teletextDocument->currentSubPage()->row(m_row);
+		QByteArray newRowContents = oldRowContents;
+
+		// Move characters leftwards and put a space on the far right
+		for (int c=m_column; c<39; c++)
+			newRowContents[c] = newRowContents.at(c+1);
+		newRowContents[39] = 0x20;
+		m_delta = XorDelta(oldRowContents, newRowContents);
+		m_firstDo = false;
+	}
 
-	for (int c=0; c<40; c++)
-		m_teletextDocument->currentSubPage()->setCharacter(m_row, c, m_newRowContents[c]);
+	applyRowDelta(m_row, m_delta);
 
 	m_teletextDocument->moveCursor(m_row, m_column);
 	emit m_teletextDocument->contentsChanged();
@@ -298,8 +308,7 @@ void DeleteKeyCommand::undo()
 {
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
-	for (int c=0; c<40; c++)
-		m_teletextDocument->currentSubPage()->setCharacter(m_row, c, m_oldRowContents[c]);
+	applyRowDelta(m_row, m_delta);
 
 	m_teletextDocument->moveCursor(m_row, m_column);
 	emit m_teletextDocument->contentsChanged();
@@ -312,14 +321,13 @@ bool DeleteKeyCommand::mergeWith(const QUndoCommand *command)
 	if (m_subPageIndex != newerCommand->m_subPageIndex || m_row != newerCommand->m_row || m_column != newerCommand->m_column)
 		return false;
 
-	for (int c=0; c<40; c++)
-		m_newRowContents[c] = newerCommand->m_newRowContents[c];
+	m_delta.merge(newerCommand->m_delta);
 
 	return true;
 }
 
 
-ShiftMosaicsCommand::ShiftMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent) : LevelOneCommand(teletextDocument, parent)
+ShiftMosaicsCommand::ShiftMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent) : LevelOneCommand(teletextDocument, parent)
 {
 	m_selectionTopRow = m_teletextDocument->selectionTopRow();
 	m_selectionLeftColumn = m_teletextDocument->selectionLeftColumn();
@@ -329,16 +337,27 @@ ShiftMosaicsCommand::ShiftMosaicsCommand(TeletextDocument *teletextDocument, con
 	m_selectionCornerRow = m_teletextDocument->selectionCornerRow();
 	m_selectionCornerColumn = m_teletextDocument->selectionCornerColumn();
 
-	m_mosaicList = mosaicList;
-
 	m_oldCharacters = storeCharacters(m_selectionTopRow, m_selectionLeftColumn, m_selectionBottomRow, m_selectionRightColumn);
-	m_newCharacters = m_oldCharacters;
+
+	m_mosaics = std::make_unique<MosaicBitplane>(mosaics);
+	m_mosaics->readCharacters(m_oldCharacters, m_selectionTopRow, m_selectionLeftColumn);
 }
 
 void ShiftMosaicsCommand::redo()
 {
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
-	retrieveCharacters(m_selectionTopRow, m_selectionLeftColumn, m_newCharacters);
+
+	// The constructors of the subclasses change the sixels in m_mosaics, so the delta is taken here
+	if (m_firstDo) {
+		QByteArrayList newCharacters = m_oldCharacters;
+
+		m_mosaics->writeCharacters(newCharacters, m_selectionTopRow, m_selectionLeftColumn);
+		m_delta = XorDelta(m_oldCharacters.join(), newCharacters.join());
+		m_oldCharacters.clear();
+		m_mosaics.reset();
+		m_firstDo = false;
+	}
+	applyDelta(m_selectionTopRow, m_selectionLeftColumn, m_selectionBottomRow, m_selectionRightColumn, m_delta);
 
 	emit m_teletextDocument->contentsChanged();
 
@@ -349,7 +368,7 @@ void ShiftMosaicsCommand::redo()
 void ShiftMosaicsCommand::undo()
 {
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
-	retrieveCharacters(m_selectionTopRow, m_selectionLeftColumn, m_oldCharacters);
+	applyDelta(m_selectionTopRow, m_selectionLeftColumn, m_selectionBottomRow, m_selectionRightColumn, m_delta);
 
 	emit m_teletextDocument->contentsChanged();
 
@@ -357,6 +376,18 @@ void ShiftMosaicsCommand::undo()
 	m_teletextDocument->moveCursor(m_row, m_column, true);
 }
 
+qsizetype ShiftMosaicsCommand::memoryUsage() const
+{
+	qsizetype result = LevelOneCommand::memoryUsage();
+
+	if (m_mosaics)
+		result += sizeof(MosaicBitplane);
+	for (const QByteArray &row : m_oldCharacters)
+		result += row.capacity();
+
+	return result;
+}
+
 bool ShiftMosaicsCommand::mergeWith(const QUndoCommand *command)
 {
 	const ShiftMosaicsCommand *newerCommand = static_cast<const ShiftMosaicsCommand *>(command);
@@ -364,119 +395,56 @@ bool ShiftMosaicsCommand::mergeWith(const QUndoCommand *command)
 	if (m_subPageIndex != newerCommand->m_subPageIndex || m_selectionTopRow != newerCommand->m_selectionTopRow || m_selectionLeftColumn != newerCommand->m_selectionLeftColumn || m_selectionBottomRow != newerCommand->m_selectionBottomRow || m_selectionRightColumn != newerCommand->m_selectionRightColumn)
 		return false;
 
-	m_newCharacters = newerCommand->m_newCharacters;
+	m_delta.merge(newerCommand->m_delta);
 
 	return true;
 }
 
-ShiftMosaicsUpCommand::ShiftMosaicsUpCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaicList, parent)
+ShiftMosaicsUpCommand::ShiftMosaicsUpCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaics, parent)
 {
-	for (int r=m_selectionTopRow; r<=m_selectionBottomRow; r++)
-		for (int c=m_selectionLeftColumn; c<=m_selectionRightColumn; c++)
-			if (m_mosaicList.contains(qMakePair(r, c))) {
-				const int lr = r - m_selectionTopRow;
-				const int lc = c - m_selectionLeftColumn;
-				unsigned char mosaicWrap = 0x00;
-
-				for (int sr=r+1; sr<=m_selectionBottomRow; sr++)
-					if (m_mosaicList.contains(qMakePair(sr, c))) {
-						mosaicWrap = m_newCharacters[sr - m_selectionTopRow][lc];
-						mosaicWrap = ((mosaicWrap & 0x01) << 4) | ((mosaicWrap & 0x02) << 5);
-						break;
-					}
-
-				m_newCharacters[lr][lc] = ((m_newCharacters[lr][lc] >> 2) & 0x07) | ((m_newCharacters[lr][lc] & 0x40) >> 3) | mosaicWrap | 0x20;
-			}
+	m_mosaics->shiftUp();
 
 	setText(QObject::tr("shift mosaics up"));
 }
 
-ShiftMosaicsDownCommand::ShiftMosaicsDownCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaicList, parent)
+ShiftMosaicsDownCommand::ShiftMosaicsDownCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaics, parent)
 {
-	for (int r=m_selectionBottomRow; r>=m_selectionTopRow; r--)
-		for (int c=m_selectionLeftColumn; c<=m_selectionRightColumn; c++)
-			if (m_mosaicList.contains(qMakePair(r, c))) {
-				const int lr = r - m_selectionTopRow;
-				const int lc = c - m_selectionLeftColumn;
-				unsigned char mosaicWrap = 0x00;
-
-				for (int sr=r-1; sr>=m_selectionTopRow; sr--)
-					if (m_mosaicList.contains(qMakePair(sr, c))) {
-						mosaicWrap = m_newCharacters[sr - m_selectionTopRow][lc];
-						mosaicWrap = ((mosaicWrap & 0x10) >> 4) | ((mosaicWrap & 0x40) >> 5);
-						break;
-					}
-
-				m_newCharacters[lr][lc] = ((m_newCharacters[lr][lc] & 0x07) << 2) | ((m_newCharacters[lr][lc] & 0x08) << 3) | mosaicWrap | 0x20;
-			}
+	m_mosaics->shiftDown();
 
 	setText(QObject::tr("shift mosaics down"));
 }
 
-ShiftMosaicsLeftCommand::ShiftMosaicsLeftCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaicList, parent)
+ShiftMosaicsLeftCommand::ShiftMosaicsLeftCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaics, parent)
 {
-	for (int c=m_selectionLeftColumn; c<=m_selectionRightColumn; c++)
-		for (int r=m_selectionTopRow; r<=m_selectionBottomRow; r++)
-			if (m_mosaicList.contains(qMakePair(r, c))) {
-				const int lr = r - m_selectionTopRow;
-				const int lc = c - m_selectionLeftColumn;
-				unsigned char mosaicWrap = 0x00;
-
-				for (int sc=c+1; sc<=m_selectionRightColumn; sc++)
-					if (m_mosaicList.contains(qMakePair(r, sc))) {
-						mosaicWrap = m_newCharacters[lr][sc - m_selectionLeftColumn];
-						mosaicWrap = ((mosaicWrap & 0x05) << 1) | ((mosaicWrap & 0x10) << 2);
-						break;
-					}
-
-				m_newCharacters[lr][lc] = ((m_newCharacters[lr][lc] & 0x0a) >> 1) | ((m_newCharacters[lr][lc] & 0x40) >> 2) | mosaicWrap | 0x20;
-			}
+	m_mosaics->shiftLeft();
 
 	setText(QObject::tr("shift mosaics left"));
 }
 
-ShiftMosaicsRightCommand::ShiftMosaicsRightCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaicList, parent)
+ShiftMosaicsRightCommand::ShiftMosaicsRightCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaics, parent)
 {
-	for (int c=m_selectionRightColumn; c>=m_selectionLeftColumn; c--)
-		for (int r=m_selectionTopRow; r<=m_selectionBottomRow; r++)
-			if (m_mosaicList.contains(qMakePair(r, c))) {
-				const int lr = r - m_selectionTopRow;
-				const int lc = c - m_selectionLeftColumn;
-				unsigned char mosaicWrap = 0x00;
-
-				for (int sc=c-1; sc>=m_selectionLeftColumn; sc--)
-					if (m_mosaicList.contains(qMakePair(r, sc))) {
-						mosaicWrap = m_newCharacters[lr][sc - m_selectionLeftColumn];
-						mosaicWrap = ((mosaicWrap & 0x0a) >> 1) | ((mosaicWrap & 0x40) >> 2);
-						break;
-					}
-
-				m_newCharacters[lr][lc] = ((m_newCharacters[lr][lc] & 0x05) << 1) | ((m_newCharacters[lr][lc] & 0x10) << 2) | mosaicWrap | 0x20;
-			}
+	m_mosaics->shiftRight();
 
 	setText(QObject::tr("shift mosaics right"));
 }
 
-FillMosaicsCommand::FillMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaicList, parent)
+FillMosaicsCommand::FillMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaics, parent)
 {
-	for (const auto &m : m_mosaicList)
-		m_newCharacters[m.first - m_selectionTopRow][m.second - m_selectionLeftColumn] = 0x7f;
+	m_mosaics->fill();
 
 	setText(QObject::tr("fill mosaics"));
 }
 
-ClearMosaicsCommand::ClearMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaicList, parent)
+ClearMosaicsCommand::ClearMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaics, parent)
 {
-	for (const auto &m : m_mosaicList)
-		m_newCharacters[m.first - m_selectionTopRow][m.second - m_selectionLeftColumn] = 0x20;
+	m_mosaics->clear();
 
 	setText(QObject::tr("clear mosaics"));
 }
 
-InvertMosaicsCommand::InvertMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaicList, parent)
+InvertMosaicsCommand::InvertMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaics, parent)
 {
-	for (const auto &m : m_mosaicList)
-		m_newCharacters[m.first - m_selectionTopRow][m.second - m_selectionLeftColumn] ^= 0x5f;
+	m_mosaics->invert();
 
 	setText(QObject::tr("reverse mosaics"));
 }
@@ -492,14 +460,60 @@ bool InvertMosaicsCommand::mergeWith(const QUndoCommand *command)
 	return true;
 }
 
-DitherMosaicsCommand::DitherMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaicList, parent)
+DitherMosaicsCommand::DitherMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent) : ShiftMosaicsCommand(teletextDocument, mosaics, parent)
 {
-	for (const auto &m : m_mosaicList)
-		m_newCharacters[m.first - m_selectionTopRow][m.second - m_selectionLeftColumn] = (m.first & 1) ? 0x66 : 0x39;
+	m_mosaics->dither();
 
 	setText(QObject::tr("dither mosaics"));
 }
 
+ImportImageCommand::ImportImageCommand(TeletextDocument *teletextDocument, int topRow, int leftColumn, const QByteArrayList &characters, QUndoCommand *parent) : LevelOneCommand(teletextDocument, parent)
+{
+	m_topRow = topRow;
+	m_leftColumn = leftColumn;
+	m_bottomRow = m_topRow + characters.size() - 1;
+	m_rightColumn = m_leftColumn + (characters.isEmpty() ? 0 : characters.first().size()) - 1;
+
+	m_selectionActive = m_teletextDocument->selectionActive();
+	m_selectionCornerRow = m_teletextDocument->selectionCornerRow();
+	m_selectionCornerColumn = m_teletextDocument->selectionCornerColumn();
+
+	// The whole change is known already so the delta is taken here
+	if (!characters.isEmpty())
+		m_delta = XorDelta(storeCharacters(m_topRow, m_leftColumn, m_bottomRow, m_rightColumn).join(), characters.join());
+
+	setText(QObject::tr("import image"));
+}
+
+void ImportImageCommand::restoreSelection()
+{
+	if (m_selectionActive) {
+		m_teletextDocument->setSelectionCorner(m_selectionCornerRow, m_selectionCornerColumn);
+		m_teletextDocument->moveCursor(m_row, m_column, true);
+	} else
+		m_teletextDocument->moveCursor(m_row, m_column);
+}
+
+void ImportImageCommand::redo()
+{
+	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
+	applyDelta(m_topRow, m_leftColumn, m_bottomRow, m_rightColumn, m_delta);
+
+	emit m_teletextDocument->contentsChanged();
+
+	restoreSelection();
+}
+
+void ImportImageCommand::undo()
+{
+	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
+	applyDelta(m_topRow, m_leftColumn, m_bottomRow, m_rightColumn, m_delta);
+
+	emit m_teletextDocument->contentsChanged();
+
+	restoreSelection();
+}
+
 
 InsertRowCommand::InsertRowCommand(TeletextDocument *teletextDocument, bool copyRow, QUndoCommand *parent) : LevelOneCommand(teletextDocument, parent)
 {
@@ -516,16 +530,13 @@ void InsertRowCommand::redo()
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 	m_teletextDocument->moveCursor(m_row, -1);
 	// Store copy of the bottom row we're about to push out, for undo
-	for (int c=0; c<40; c++)
-		m_deletedBottomRow[c] = m_teletextDocument->currentSubPage()->character(23, c);
+	m_delta = XorDelta(QByteArray(40, ' '), m_teletextDocument->currentSubPage()->row(23));
 	// Move lines below the inserting row downwards without affecting the FastText row
 	for (int r=22; r>=m_row; r--)
-		for (int c=0; c<40; c++)
-			m_teletextDocument->currentSubPage()->setCharacter(r+1, c, m_teletextDocument->currentSubPage()->character(r, c));
+		m_teletextDocument->currentSubPage()->setRow(r+1, m_teletextDocument->currentSubPage()->row(r));
 	if (!m_copyRow)
 		// The above movement leaves a duplicate of the current row, so blank it if requested
-		for (int c=0; c<40; c++)
-			m_teletextDocument->currentSubPage()->setCharacter(m_row, c, ' ');
+		m_teletextDocument->currentSubPage()->setRow(m_row, QByteArray(40, ' '));
 
 	emit m_teletextDocument->contentsChanged();
 }
@@ -536,11 +547,12 @@ void InsertRowCommand::undo()
 	m_teletextDocument->moveCursor(m_row, -1);
 	// Move lines below the deleting row upwards without affecting the FastText row
 	for (int r=m_row; r<23; r++)
-		for (int c=0; c<40; c++)
-			m_teletextDocument->currentSubPage()->setCharacter(r, c, m_teletextDocument->currentSubPage()->character(r+1, c));
+		m_teletextDocument->currentSubPage()->setRow(r, m_teletextDocument->currentSubPage()->row(r+1));
 	// Now repair the bottom row we pushed out
-	for (int c=0; c<40; c++)
-		m_teletextDocument->currentSubPage()->setCharacter(23, c, m_deletedBottomRow[c]);
+	QByteArray bottomRow(40, ' ');
+
+	m_delta.apply(bottomRow);
+	m_teletextDocument->currentSubPage()->setRow(23, bottomRow);
 
 	emit m_teletextDocument->contentsChanged();
 }
@@ -556,16 +568,13 @@ void DeleteRowCommand::redo()
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 	m_teletextDocument->moveCursor(m_row, -1);
 	// Store copy of the row we're going to delete, for undo
-	for (int c=0; c<40; c++)
-		m_deletedRow[c] = m_teletextDocument->currentSubPage()->character(m_row, c);
+	m_delta = XorDelta(QByteArray(40, ' '), m_teletextDocument->currentSubPage()->row(m_row));
 	// Move lines below the deleting row upwards without affecting the FastText row
 	for (int r=m_row; r<23; r++)
-		for (int c=0; c<40; c++)
-			m_teletextDocument->currentSubPage()->setCharacter(r, c, m_teletextDocument->currentSubPage()->character(r+1, c));
+		m_teletextDocument->currentSubPage()->setRow(r, m_teletextDocument->currentSubPage()->row(r+1));
 	// If we deleted the FastText row blank that row, otherwise blank the last row
 	int blankingRow = (m_row < 24) ? 23 : 24;
-		for (int c=0; c<40; c++)
-			m_teletextDocument->currentSubPage()->setCharacter(blankingRow, c, ' ');
+	m_teletextDocument->currentSubPage()->setRow(blankingRow, QByteArray(40, ' '));
 
 	emit m_teletextDocument->contentsChanged();
 }
@@ -576,11 +585,12 @@ void DeleteRowCommand::undo()
 	m_teletextDocument->moveCursor(m_row, -1);
 	// Move lines below the inserting row downwards without affecting the FastText row
 	for (int r=22; r>=m_row; r--)
-		for (int c=0; c<40; c++)
-			m_teletextDocument->currentSubPage()->setCharacter(r+1, c, m_teletextDocument->currentSubPage()->character(r, c));
+		m_teletextDocument->currentSubPage()->setRow(r+1, m_teletextDocument->currentSubPage()->row(r));
 	// Now repair the row we deleted
-	for (int c=0; c<40; c++)
-		m_teletextDocument->currentSubPage()->setCharacter(m_row, c, m_deletedRow[c]);
+	QByteArray deletedRow(40, ' ');
+
+	m_delta.apply(deletedRow);
+	m_teletextDocument->currentSubPage()->setRow(m_row, deletedRow);
 
 	emit m_teletextDocument->contentsChanged();
 }
@@ -597,7 +607,9 @@ CutCommand::CutCommand(TeletextDocument *teletextDocument, QUndoCommand *parent)
 	m_selectionCornerRow = m_teletextDocument->selectionCornerRow();
 	m_selectionCornerColumn = m_teletextDocument->selectionCornerColumn();
 
-	m_oldCharacters = storeCharacters(m_selectionTopRow, m_selectionLeftColumn, m_selectionBottomRow, m_selectionRightColumn);
+	const QByteArray oldCharacters = storeCharacters(m_selectionTopRow, m_selectionLeftColumn, m_selectionBottomRow, m_selectionRightColumn).join();
+
+	m_delta = XorDelta(oldCharacters, QByteArray(oldCharacters.size(), 0x20));
 
 	setText(QObject::tr("cut"));
 }
@@ -606,10 +618,7 @@ void CutCommand::redo()
 {
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
-	for (int r=m_selectionTopRow; r<=m_selectionBottomRow; r++) {
-		for (int c=m_selectionLeftColumn; c<=m_selectionRightColumn; c++)
-			m_teletextDocument->currentSubPage()->setCharacter(r, c, 0x20);
-	}
+	applyDelta(m_selectionTopRow, m_selectionLeftColumn, m_selectionBottomRow, m_selectionRightColumn, m_delta);
 
 	emit m_teletextDocument->contentsChanged();
 }
@@ -618,7 +627,7 @@ void CutCommand::undo()
 {
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
-	retrieveCharacters(m_selectionTopRow, m_selectionLeftColumn, m_oldCharacters);
+	applyDelta(m_selectionTopRow, m_selectionLeftColumn, m_selectionBottomRow, m_selectionRightColumn, m_delta);
 
 	emit m_teletextDocument->contentsChanged();
 
@@ -774,16 +783,17 @@ PasteCommand::PasteCommand(TeletextDocument *teletextDocument, int pageCharSet,
 					convertedChar = -1;
 				else if (charToConvert >= QChar(0x01) && charToConvert <= QChar(0x1f))
 					convertedChar = ' ';
-				else if (keymapping[pageCharSet].contains(charToConvert))
-					// Remapped character or non-Latin character converted successfully
-					convertedChar = keymapping[pageCharSet].value(charToConvert);
 				else {
-					// Either a Latin character or non-Latin character that can't be converted
-					// See if it's a Latin character
-					convertedChar = charToConvert.toLatin1();
-					if (convertedChar <= 0)
-						// Couldn't convert - make it a block character so it doesn't need to be inserted-between later on
-						convertedChar = 0x7f;
+					// Remapped character or non-Latin character converted successfully
+					convertedChar = keymapToTeletext(pageCharSet, charToConvert);
+					if (convertedChar == 0) {
+						// Either a Latin character or non-Latin character that can't be converted
+						// See if it's a Latin character
+						convertedChar = charToConvert.toLatin1();
+						if (convertedChar <= 0)
+							// Couldn't convert - make it a block character so it doesn't need to be inserted-between later on
+							convertedChar = 0x7f;
+					}
 				}
 
 				m_pastingCharacters[r].append(convertedChar);
@@ -872,8 +882,6 @@ PasteCommand::PasteCommand(TeletextDocument *teletextDocument, int pageCharSet,
 	if (m_clipboardDataWidth == 0 || m_clipboardDataHeight == 0)
 		return;
 
-	m_oldCharacters = storeCharacters(m_pasteTopRow, m_pasteLeftColumn, m_pasteBottomRow, m_pasteRightColumn);
-
 	setText(QObject::tr("paste"));
 }
 
@@ -884,41 +892,51 @@ void PasteCommand::redo()
 
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
-	int arrayR = 0;
-	int arrayC;
-
-	for (int r=m_pasteTopRow; r<=m_pasteBottomRow; r++) {
-		arrayC = 0;
-		for (int c=m_pasteLeftColumn; c<=m_pasteRightColumn; c++)
-			// Guard against size of pasted block going beyond last line or column
-			if (r < 25 && c < 40) {
-				// Check for 0xff bytes using "-1"
-				// gcc complains about "comparision always true due to limited range"
-				if (m_pastingCharacters.at(arrayR).at(arrayC) != -1)
-					m_teletextDocument->currentSubPage()->setCharacter(r, c, m_pastingCharacters.at(arrayR).at(arrayC));
-
-				arrayC++;
-
+	// Only build up the paste on the first do, m_delta will remember it if we redo
+	if (m_firstDo) {
+		const QByteArray oldCharacters = storeCharacters(m_pasteTopRow, m_pasteLeftColumn, m_pasteBottomRow, m_pasteRightColumn).join();
+
+		// Build up the whole pasting rectangle first so each row of the page is written once
+		// 0xff bytes represent character cells that won't overwrite what's on the page
+		// Guard against size of pasted block going beyond last line or column
+		const int pasteWidth = qMin(m_pasteRightColumn, 39) - m_pasteLeftColumn + 1;
+		QByteArrayList pasteBlock;
+		int arrayR = 0;
+
+		for (int r=m_pasteTopRow; r<=m_pasteBottomRow && r<25; r++) {
+			const QByteArray &pastingRow = m_pastingCharacters.at(arrayR);
+			QByteArray blockRow;
+
+			if (m_plainText)
+				blockRow = pastingRow.left(pasteWidth).leftJustified(pasteWidth, -1);
+			else {
 				// If paste area is wider than clipboard data, repeat the pattern
 				// if it wasn't plain text
-				if (arrayC == m_clipboardDataWidth) {
-					if (!m_plainText)
-						arrayC = 0;
-					else
-						break;
-				}
+				blockRow.reserve(pasteWidth);
+				while (blockRow.size() < pasteWidth)
+					blockRow.append(pastingRow.left(pasteWidth - blockRow.size()));
+			}
+			pasteBlock.append(blockRow);
+
+			arrayR++;
+			// If paste area is taller than clipboard data, repeat the pattern
+			// if it wasn't plain text
+			if (arrayR == m_clipboardDataHeight) {
+				if (!m_plainText)
+					arrayR = 0;
+				else
+					break;
 			}
-
-		arrayR++;
-		// If paste area is taller than clipboard data, repeat the pattern
-		// if it wasn't plain text
-		if (arrayR == m_clipboardDataHeight) {
-			if (!m_plainText)
-				arrayR = 0;
-			else
-				break;
 		}
-	}
+
+		if (pasteWidth > 0)
+			m_teletextDocument->currentSubPage()->setBlock(m_pasteTopRow, m_pasteLeftColumn, pasteBlock, true);
+
+		m_delta = XorDelta(oldCharacters, storeCharacters(m_pasteTopRow, m_pasteLeftColumn, m_pasteBottomRow, m_pasteRightColumn).join());
+		m_pastingCharacters.clear();
+		m_firstDo = false;
+	} else
+		applyDelta(m_pasteTopRow, m_pasteLeftColumn, m_pasteBottomRow, m_pasteRightColumn, m_delta);
 
 	emit m_teletextDocument->contentsChanged();
 
@@ -938,7 +956,7 @@ void PasteCommand::undo()
 
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex);
 
-	retrieveCharacters(m_pasteTopRow, m_pasteLeftColumn, m_oldCharacters);
+	applyDelta(m_pasteTopRow, m_pasteLeftColumn, m_pasteBottomRow, m_pasteRightColumn, m_delta);
 
 	emit m_teletextDocument->contentsChanged();
 
@@ -975,11 +993,25 @@ void InsertSubPageCommand::undo()
 
 DeleteSubPageCommand::DeleteSubPageCommand(TeletextDocument *teletextDocument, QUndoCommand *parent) : LevelOneCommand(teletextDocument, parent)
 {
+	m_subPageMemory = 0;
+
 	setText(QObject::tr("delete subpage"));
 }
 
 void DeleteSubPageCommand::redo()
 {
+	LevelOnePage *subPage = m_teletextDocument->subPage(m_subPageIndex);
+
+	// Roughly what the subpage holds in packets and enhancement triplets
+	m_subPageMemory = sizeof(LevelOnePage) + subPage->enhancements()->size() * sizeof(X26Triplet);
+	for (int y=0; y<26; y++)
+		if (subPage->packetExists(y))
+			m_subPageMemory += 40;
+	for (int y=27; y<29; y++)
+		for (int d=0; d<16; d++)
+			if (subPage->packetExists(y, d))
+				m_subPageMemory += 40;
+
 	m_teletextDocument->deleteSubPageToRecycle(m_subPageIndex);
 	m_teletextDocument->selectSubPageIndex(qMin(m_subPageIndex, m_teletextDocument->numberOfSubPages()-1), true);
 }
@@ -988,4 +1020,13 @@ void DeleteSubPageCommand::undo()
 {
 	m_teletextDocument->unDeleteSubPageFromRecycle(m_subPageIndex);
 	m_teletextDocument->selectSubPageIndex(m_subPageIndex, true);
+	m_subPageMemory = 0;
+}
+
+void DeleteSubPageCommand::evict()
+{
+	// Evicted commands are always ones that have been done, and are evicted oldest first,
+	// so this command's subpage is the oldest one in the recycle bin
+	m_teletextDocument->discardOldestRecycledSubPage();
+	m_subPageMemory = 0;
 }
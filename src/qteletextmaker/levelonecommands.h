@@ -20,24 +20,36 @@
 #ifndef LEVELONECOMMANDS_H
 #define LEVELONECOMMANDS_H
 
+#include <QByteArray>
 #include <QByteArrayList>
-#include <QSet>
 #include <QUndoCommand>
 
+#include <memory>
+
 #include "document.h"
+#include "mosaicbitplane.h"
+#include "undohistory.h"
 
-class LevelOneCommand : public QUndoCommand
+class LevelOneCommand : public HistoryCommand
 {
 public:
 	LevelOneCommand(TeletextDocument *teletextDocument, QUndoCommand *parent = 0);
 
+	qsizetype memoryUsage() const override { return HistoryCommand::memoryUsage() + m_delta.memoryUsage(); }
+	void evict() override { m_delta.clear(); }
+
 protected:
 	QByteArrayList storeCharacters(int topRow, int leftColumn, int bottomRow, int rightColumn);
 	void retrieveCharacters(int topRow, int leftColumn, const QByteArrayList &oldChars);
+	// Applies a delta of a rectangle of characters, or of a whole row, to the current subpage
+	void applyDelta(int topRow, int leftColumn, int bottomRow, int rightColumn, const XorDelta &delta);
+	void applyRowDelta(int r, const XorDelta &delta);
 
 	TeletextDocument *m_teletextDocument;
 	int m_subPageIndex, m_row, m_column;
 	bool m_firstDo;
+	// Characters changed by the command, taken the first time it is done
+	XorDelta m_delta;
 };
 
 class TypeCharacterCommand : public LevelOneCommand
@@ -53,7 +65,7 @@ public:
 	int id() const override { return Id; }
 
 private:
-	unsigned char m_newCharacter, m_oldRowContents[40], m_newRowContents[40];
+	unsigned char m_newCharacter;
 	int m_columnStart, m_columnEnd;
 	bool m_insertMode;
 };
@@ -87,7 +99,6 @@ public:
 	int id() const override { return Id; }
 
 private:
-	unsigned char m_oldRowContents[40], m_newRowContents[40];
 	int m_columnStart, m_columnEnd;
 	bool m_insertMode;
 };
@@ -103,23 +114,22 @@ public:
 	void undo() override;
 	bool mergeWith(const QUndoCommand *command) override;
 	int id() const override { return Id; }
-
-private:
-	unsigned char m_oldRowContents[40], m_newRowContents[40];
 };
 
 class ShiftMosaicsCommand : public LevelOneCommand
 {
 public:
-	ShiftMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent = 0);
+	ShiftMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent = 0);
 
 	void redo() override;
 	void undo() override;
 	bool mergeWith(const QUndoCommand *command) override;
+	qsizetype memoryUsage() const override;
 
 protected:
-	QByteArrayList m_oldCharacters, m_newCharacters;
-	QSet<QPair<int, int>> m_mosaicList;
+	// Only needed until the command is first done, after that the delta holds the change
+	QByteArrayList m_oldCharacters;
+	std::unique_ptr<MosaicBitplane> m_mosaics;
 	int m_selectionTopRow, m_selectionBottomRow, m_selectionLeftColumn, m_selectionRightColumn;
 	int m_selectionCornerRow, m_selectionCornerColumn;
 };
@@ -129,7 +139,7 @@ class ShiftMosaicsUpCommand : public ShiftMosaicsCommand
 public:
 	enum { Id = 110 };
 
-	ShiftMosaicsUpCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent = 0);
+	ShiftMosaicsUpCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent = 0);
 
 	int id() const override { return Id; }
 };
@@ -139,7 +149,7 @@ class ShiftMosaicsDownCommand : public ShiftMosaicsCommand
 public:
 	enum { Id = 111 };
 
-	ShiftMosaicsDownCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent = 0);
+	ShiftMosaicsDownCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent = 0);
 
 	int id() const override { return Id; }
 };
@@ -149,7 +159,7 @@ class ShiftMosaicsLeftCommand : public ShiftMosaicsCommand
 public:
 	enum { Id = 112 };
 
-	ShiftMosaicsLeftCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent = 0);
+	ShiftMosaicsLeftCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent = 0);
 
 	int id() const override { return Id; }
 };
@@ -159,7 +169,7 @@ class ShiftMosaicsRightCommand : public ShiftMosaicsCommand
 public:
 	enum { Id = 113 };
 
-	ShiftMosaicsRightCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent = 0);
+	ShiftMosaicsRightCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent = 0);
 
 	int id() const override { return Id; }
 };
@@ -169,7 +179,7 @@ class FillMosaicsCommand : public ShiftMosaicsCommand
 public:
 	enum { Id = 120 };
 
-	FillMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent = 0);
+	FillMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent = 0);
 
 	int id() const override { return Id; }
 };
@@ -179,7 +189,7 @@ class ClearMosaicsCommand : public ShiftMosaicsCommand
 public:
 	enum { Id = 121 };
 
-	ClearMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent = 0);
+	ClearMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent = 0);
 
 	int id() const override { return Id; }
 };
@@ -189,7 +199,7 @@ class InvertMosaicsCommand : public ShiftMosaicsCommand
 public:
 	enum { Id = 122 };
 
-	InvertMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent = 0);
+	InvertMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent = 0);
 
 	bool mergeWith(const QUndoCommand *command) override;
 	int id() const override { return Id; }
@@ -200,11 +210,27 @@ class DitherMosaicsCommand : public ShiftMosaicsCommand
 public:
 	enum { Id = 123 };
 
-	DitherMosaicsCommand(TeletextDocument *teletextDocument, const QSet<QPair<int, int>> &mosaicList, QUndoCommand *parent = 0);
+	DitherMosaicsCommand(TeletextDocument *teletextDocument, const MosaicBitplane &mosaics, QUndoCommand *parent = 0);
 
 	int id() const override { return Id; }
 };
 
+class ImportImageCommand : public LevelOneCommand
+{
+public:
+	ImportImageCommand(TeletextDocument *teletextDocument, int topRow, int leftColumn, const QByteArrayList &characters, QUndoCommand *parent = 0);
+
+	void redo() override;
+	void undo() override;
+
+private:
+	void restoreSelection();
+
+	int m_topRow, m_bottomRow, m_leftColumn, m_rightColumn;
+	int m_selectionCornerRow, m_selectionCornerColumn;
+	bool m_selectionActive;
+};
+
 class InsertSubPageCommand : public LevelOneCommand
 {
 public:
@@ -225,6 +251,12 @@ public:
 
 	void redo() override;
 	void undo() override;
+	qsizetype memoryUsage() const override { return HistoryCommand::memoryUsage() + m_subPageMemory; }
+	void evict() override;
+
+private:
+	// Rough memory held by the deleted subpage waiting to be undeleted
+	qsizetype m_subPageMemory;
 };
 
 class InsertRowCommand : public LevelOneCommand
@@ -237,7 +269,6 @@ public:
 
 private:
 	bool m_copyRow;
-	unsigned char m_deletedBottomRow[40];
 };
 
 class DeleteRowCommand : public LevelOneCommand
@@ -247,9 +278,6 @@ public:
 
 	void redo() override;
 	void undo() override;
-
-private:
-	unsigned char m_deletedRow[40];
 };
 
 #ifndef QT_NO_CLIPBOARD
@@ -262,7 +290,6 @@ public:
 	void undo() override;
 
 private:
-	QByteArrayList m_oldCharacters;
 	int m_selectionTopRow, m_selectionBottomRow, m_selectionLeftColumn, m_selectionRightColumn;
 	int m_selectionCornerRow, m_selectionCornerColumn;
 };
@@ -276,7 +303,8 @@ public:
 	void undo() override;
 
 private:
-	QByteArrayList m_oldCharacters, m_pastingCharacters;
+	// Only needed until the paste is first done
+	QByteArrayList m_pastingCharacters;
 	int m_pasteTopRow, m_pasteBottomRow, m_pasteLeftColumn, m_pasteRightColumn;
 	int m_clipboardDataHeight, m_clipboardDataWidth;
 	int m_selectionCornerRow, m_selectionCornerColumn;
@@ -26,17 +26,108 @@
 #include <QString>
 #include <QStringList>
 #include <QVariant>
+#include <QtEndian>
+
+#include <algorithm>
+#include <bitset>
+#include <charconv>
+#include <cstring>
 
 #include "hamming.h"
 #include "levelonepage.h"
 #include "pagebase.h"
+#include "projectformat.h"
+
+// Same characters as trimmed() removes
+static inline bool isTTISpace(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Value of the whole of a field, as QByteArray::toInt() would give
+static bool parseTTIValue(const char *begin, const char *end, int base, int &value)
+{
+	// from_chars won't skip surrounding whitespace or a plus sign like toInt() does
+	while (begin < end && isTTISpace(*begin))
+		begin++;
+	while (begin < end && isTTISpace(end[-1]))
+		end--;
+	if (end - begin > 1 && *begin == '+' && begin[1] != '-')
+		begin++;
+
+	if (begin >= end)
+		return false;
+
+	const auto [ptr, ec] = std::from_chars(begin, end, value, base);
+
+	return ec == std::errc() && ptr == end;
+}
+
+static constexpr int ttiCommand(unsigned char first, unsigned char second)
+{
+	return first << 8 | second;
+}
+
+static QString subPageMetadataKey(const char *name, int subPageNum)
+{
+	return QLatin1String(name) + QString::number(subPageNum).rightJustified(3, '0');
+}
+
+// Decodes the escaped characters of an OL line of a display row straight into a 40 byte packet
+static void decodeTTIRow(const char *in, const char *end, char *out)
+{
+	for (int c=0; c<40; c++) {
+		// Spaces at the end of a 40 character row were trimmed with the line ending, so put them back
+		if (in >= end) {
+			out[c] = ' ';
+			continue;
+		}
+
+		char ch = *in++;
+
+		if (ch & 0x80)
+			ch &= 0x7f;
+		else if (ch == 0x10)
+			ch = 0x0d;
+		else if (ch == 0x1b)
+			ch = (in < end) ? (*in++ & 0xbf) : ' ';
+		out[c] = ch;
+	}
+}
+
+// Copies an OL line of X/26, X/27, X/28 or M/29 triplets or Hamming 8/4 into a 40 byte packet
+static void decodeTTIDesignationPacket(int lineNumber, const char *in, const char *end, char *out)
+{
+	int size = qMin(static_cast<int>(end - in), 40);
+
+	// For a too-short enhancement triplets OL, first trim the line down to the last whole triplet
+	if (lineNumber == 26 && size < 40)
+		size = (size - 1) / 3 * 3 + 1;
+
+	std::memcpy(out, in, size);
+
+	for (int i=size; i<40; i++)
+		if (lineNumber == 26)
+			// Then use "dummy" enhancement triplets to extend the line to the proper length
+			out[i] = "i^@"[(i - size) % 3]; // Address 41, Mode 0x1e, Data 0
+		else
+			// For other triplet OLs and Hamming 8/4 OLs, just pad with zero data
+			out[i] = '@';
+
+	for (int i=1; i<=39; i++)
+		out[i] &= 0x3f;
+}
 
 bool LoadTTIFormat::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash *metadata)
 {
 	m_warnings.clear();
 	m_error.clear();
 
-	QByteArray inLine;
+	// The whole file is read into one buffer and each line is parsed where it lies in there
+	const QByteArray inData = inFile->readAll();
+	const char *next = inData.constData();
+	const char *const dataEnd = next + inData.size();
+
 	int pageNum = 0;
 	int currentSubPageNum = 0;
 	bool firstSubPageAlreadyFound = false;
@@ -47,152 +138,147 @@ bool LoadTTIFormat::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash
 
 	PageBase* loadingPage = &subPages[0];
 
-	for (;;) {
-		inLine = inFile->readLine(160).trimmed();
-		if (inLine.isEmpty())
+	while (next < dataEnd) {
+		const char *lineStart = next;
+		const char *lineEnd = static_cast<const char *>(std::memchr(next, '\n', dataEnd - next));
+
+		if (lineEnd == nullptr)
+			lineEnd = dataEnd;
+		next = (lineEnd == dataEnd) ? dataEnd : lineEnd + 1;
+
+		while (lineStart < lineEnd && isTTISpace(*lineStart))
+			lineStart++;
+		while (lineEnd > lineStart && isTTISpace(lineEnd[-1]))
+			lineEnd--;
+
+		// A blank line ends the page
+		if (lineStart == lineEnd)
 			break;
-		if (inLine.startsWith("DE,") && metadata != nullptr)
-			metadata->insert("description", QString(inLine.remove(0, 3)));
-		if (inLine.startsWith("PN,")) {
-			if (!firstSubPageAlreadyFound) {
-				// First PN command found, set the page number
-				bool valueOk;
-
-				if (int pageNumRead = inLine.mid(3, 3).toInt(&valueOk, 16); valueOk)
-					if (pageNumRead >= 0x100 && pageNumRead <= 0x8ff) {
-						// Keep page number: to check if page is xFF if we load M/29
-						pageNum = pageNumRead;
-						if (metadata != nullptr)
-							metadata->insert("pageNumber", pageNum);
-					}
+		if (lineEnd - lineStart < 3 || lineStart[2] != ',')
+			continue;
 
-				firstSubPageAlreadyFound = true;
-			} else {
-				// Subsequent PN command found; this assumes that PN is the first command of a new subpage
-				currentSubPageNum++;
-				subPages.append(PageBase { } );
-				loadingPage = &subPages[subPages.size()-1];
+		const char *args = lineStart + 3;
+
+		switch (ttiCommand(lineStart[0], lineStart[1])) {
+			case ttiCommand('D', 'E'):
+				if (metadata != nullptr)
+					metadata->insert("description", QString::fromUtf8(args, lineEnd - args));
+				break;
+			case ttiCommand('P', 'N'):
+				if (!firstSubPageAlreadyFound) {
+					// First PN command found, set the page number
+					int pageNumRead;
+
+					if (parseTTIValue(args, qMin(args + 3, lineEnd), 16, pageNumRead))
+						if (pageNumRead >= 0x100 && pageNumRead <= 0x8ff) {
+							// Keep page number: to check if page is xFF if we load M/29
+							pageNum = pageNumRead;
+							if (metadata != nullptr)
+								metadata->insert("pageNumber", pageNum);
+						}
+
+					firstSubPageAlreadyFound = true;
+				} else {
+					// Subsequent PN command found; this assumes that PN is the first command of a new subpage
+					currentSubPageNum++;
+					subPages.append(PageBase { } );
+					loadingPage = &subPages[subPages.size()-1];
+				}
+				break;
+/*			case ttiCommand('S', 'C'): {
+				int subPageNumberRead;
+				if (!parseTTIValue(args, qMin(args + 4, lineEnd), 16, subPageNumberRead) || subPageNumberRead > 0x3f7f)
+					subPageNumberRead = 0;
+				loadingPage->setSubPageNumber(subPageNumberRead);
+				break;
+			}*/
+			case ttiCommand('P', 'S'): {
+				int pageStatusRead;
+
+				if (parseTTIValue(args, qMin(args + 4, lineEnd), 16, pageStatusRead)) {
+					loadingPage->setControlBit(PageBase::C4ErasePage, pageStatusRead & 0x4000);
+
+					for (int i=PageBase::C5Newsflash, pageStatusBit=0x0001; i<=PageBase::C11SerialMagazine; i++, pageStatusBit<<=1)
+						loadingPage->setControlBit(i, pageStatusRead & pageStatusBit);
+
+					loadingPage->setControlBit(PageBase::C12NOS, pageStatusRead & 0x0200);
+					loadingPage->setControlBit(PageBase::C13NOS, pageStatusRead & 0x0100);
+					loadingPage->setControlBit(PageBase::C14NOS, pageStatusRead & 0x0080);
+				}
+				break;
 			}
-		}
-/*		if (lineType == "SC,") {
-			bool subPageNumberOk;
-			int subPageNumberRead = inLine.mid(3, 4).toInt(&subPageNumberOk, 16);
-			if ((!subPageNumberOk) || subPageNumberRead > 0x3f7f)
-				subPageNumberRead = 0;
-			loadingPage->setSubPageNumber(subPageNumberRead);
-		}*/
-		if (inLine.startsWith("PS,")) {
-			bool pageStatusOk;
-			const int pageStatusRead = inLine.mid(3, 4).toInt(&pageStatusOk, 16);
-			if (pageStatusOk) {
-				loadingPage->setControlBit(PageBase::C4ErasePage, pageStatusRead & 0x4000);
-
-				for (int i=PageBase::C5Newsflash, pageStatusBit=0x0001; i<=PageBase::C11SerialMagazine; i++, pageStatusBit<<=1)
-					loadingPage->setControlBit(i, pageStatusRead & pageStatusBit);
-
-				loadingPage->setControlBit(PageBase::C12NOS, pageStatusRead & 0x0200);
-				loadingPage->setControlBit(PageBase::C13NOS, pageStatusRead & 0x0100);
-				loadingPage->setControlBit(PageBase::C14NOS, pageStatusRead & 0x0080);
+			case ttiCommand('R', 'E'): {
+				int regionValueRead;
+
+				if (parseTTIValue(args, lineEnd, 10, regionValueRead) && metadata != nullptr && regionValueRead >= 0 && regionValueRead <= 15)
+					metadata->insert(subPageMetadataKey("region", currentSubPageNum), regionValueRead);
+				break;
 			}
-		}
-		if (inLine.startsWith("RE,")) {
-			bool regionValueOk;
-			const int regionValueRead = inLine.remove(0, 3).toInt(&regionValueOk);
-			if (regionValueOk && metadata != nullptr && regionValueRead >= 0 && regionValueRead <= 15)
-#if QT_VERSION >= QT_VERSION_CHECK(6, 9, 0)
-				metadata->insert(QString("region%1").arg(currentSubPageNum, 3, '0'), regionValueRead);
-#else
-				metadata->insert(QString("region%1").arg(currentSubPageNum, 3, QChar('0')), regionValueRead);
-#endif
-		}
-		if (inLine.startsWith("CT,") && (inLine.endsWith(",C") || inLine.endsWith(",T"))) {
-			bool cycleValueOk;
-			const int cycleValueRead = inLine.mid(3, inLine.size()-5).toInt(&cycleValueOk);
-			if (cycleValueOk && metadata != nullptr && cycleValueRead >= 1 && cycleValueRead <= 99) {
-#if QT_VERSION >= QT_VERSION_CHECK(6, 9, 0)
-				metadata->insert(QString("cycleValue%1").arg(currentSubPageNum, 3, '0'), cycleValueRead);
-				metadata->insert(QString("cycleType%1").arg(currentSubPageNum, 3, '0'), inLine.at(inLine.size()-1));
-#else
-				metadata->insert(QString("cycleValue%1").arg(currentSubPageNum, 3, QChar('0')), cycleValueRead);
-				metadata->insert(QString("cycleType%1").arg(currentSubPageNum, 3, QChar('0')), inLine.at(inLine.size()-1));
-#endif
+			case ttiCommand('C', 'T'): {
+				int cycleValueRead;
+
+				if (lineEnd - args < 2 || lineEnd[-2] != ',' || (lineEnd[-1] != 'C' && lineEnd[-1] != 'T'))
+					break;
+				if (parseTTIValue(args, lineEnd - 2, 10, cycleValueRead) && metadata != nullptr && cycleValueRead >= 1 && cycleValueRead <= 99) {
+					metadata->insert(subPageMetadataKey("cycleValue", currentSubPageNum), cycleValueRead);
+					metadata->insert(subPageMetadataKey("cycleType", currentSubPageNum), QChar(lineEnd[-1]));
+				}
+				break;
 			}
-		}
-		if (inLine.startsWith("FL,")) {
-			const QString flLine = QString(inLine.remove(0, 3));
-			if (flLine.count(',') == 5) {
+			case ttiCommand('F', 'L'): {
+				if (std::count(args, lineEnd, ',') != 5)
+					break;
+
 				// Init packet to all 0xf's as page xFF:3F7F means no page is specified
 				QByteArray fastTextPacket(40, 0xf);
-				fastTextPacket[0] = 0x0;  // Designation code
-				fastTextPacket[38] = 0x0; // CRC word
-				fastTextPacket[39] = 0x0; // CRC word
+				char *packetData = fastTextPacket.data();
+
+				packetData[0] = 0x0;  // Designation code
+				packetData[38] = 0x0; // CRC word
+				packetData[39] = 0x0; // CRC word
+
+				const char *field = args;
 
 				for (int i=0; i<6; i++) {
-					bool fastTextLinkOk;
-					int fastTextLinkRead = flLine.section(',', i, i).toInt(&fastTextLinkOk, 16);
-
-					if (fastTextLinkOk) {
-						if (fastTextLinkRead == 0)
-							fastTextLinkRead = 0x8ff;
-						else if (fastTextLinkRead >= 0x100 && fastTextLinkRead <= 0x8ff) {
-							fastTextPacket[i*6+1] = fastTextLinkRead & 0x00f;
-							fastTextPacket[i*6+2] = (fastTextLinkRead & 0x0f0) >> 4;
-							fastTextPacket[i*6+4] = 0x7 | ((fastTextLinkRead & 0x100) >> 5);
-							fastTextPacket[i*6+6] = 0x3 | ((fastTextLinkRead & 0x600) >> 7);
-						}
+					const char *fieldEnd = std::find(field, lineEnd, ',');
+					int fastTextLinkRead;
+
+					if (parseTTIValue(field, fieldEnd, 16, fastTextLinkRead) && fastTextLinkRead >= 0x100 && fastTextLinkRead <= 0x8ff) {
+						packetData[i*6+1] = fastTextLinkRead & 0x00f;
+						packetData[i*6+2] = (fastTextLinkRead & 0x0f0) >> 4;
+						packetData[i*6+4] = 0x7 | ((fastTextLinkRead & 0x100) >> 5);
+						packetData[i*6+6] = 0x3 | ((fastTextLinkRead & 0x600) >> 7);
 					}
+					field = fieldEnd + 1;
 				}
 				loadingPage->setPacket(27, 0, fastTextPacket);
 
 				if (metadata != nullptr)
 					metadata->insert(QString("fastextAbsolute"), true);
+				break;
 			}
-		}
-		if (inLine.startsWith("OL,")) {
-			bool lineNumberOk;
-			int lineNumber;
+			case ttiCommand('O', 'L'): {
+				const char *secondComma = static_cast<const char *>(std::memchr(args, ',', lineEnd - args));
+				int lineNumber;
 
-			const int secondCommaPosition = inLine.indexOf(',', 3);
-			if (secondCommaPosition != 4 && secondCommaPosition != 5)
-				continue;
+				if (secondComma == nullptr || (secondComma - lineStart != 4 && secondComma - lineStart != 5))
+					break;
+				if (!parseTTIValue(args, secondComma, 10, lineNumber) || lineNumber < 0 || lineNumber > 29)
+					break;
+
+				const char *payload = secondComma + 1;
 
-			lineNumber = inLine.mid(3, secondCommaPosition-3).toInt(&lineNumberOk, 10);
-			if (lineNumberOk && lineNumber >= 0 && lineNumber <= 29) {
-				inLine.remove(0, secondCommaPosition+1);
 				if (lineNumber <= 25) {
-					for (int c=0; c<40; c++) {
-						// trimmed() helpfully removes CRLF line endings from the just-read line for us
-						// But it also (un)helpfully removes spaces at the end of a 40 character line, so put them back
-						if (c >= inLine.size())
-							inLine.append(' ');
-						if (inLine.at(c) & 0x80)
-							inLine[c] = inLine.at(c) & 0x7f;
-						else if (inLine.at(c) == 0x10)
-							inLine[c] = 0x0d;
-						else if (inLine.at(c) == 0x1b) {
-							inLine.remove(c, 1);
-							inLine[c] = inLine.at(c) & 0xbf;
-						}
-					}
+					QByteArray packet(40, Qt::Uninitialized);
+
+					decodeTTIRow(payload, lineEnd, packet.data());
 					pageBodyPacketsFound = true;
-					loadingPage->setPacket(lineNumber, inLine);
-				} else if (inLine.at(0) >= 0x40 && inLine.at(0) <= 0x4f) {
-					const int designationCode = inLine.at(0) & 0x3f;
-					if (inLine.size() < 40) {
-						// OL is too short!
-						if (lineNumber == 26) {
-							// For a too-short enhancement triplets OL, first trim the line down to nearest whole triplet
-							inLine.resize((inLine.size() / 3 * 3) + 1);
-							// Then use "dummy" enhancement triplets to extend the line to the proper length
-							for (int i=inLine.size(); i<40; i+=3)
-								inLine.append("i^@"); // Address 41, Mode 0x1e, Data 0
-						} else
-							// For other triplet OLs and Hamming 8/4 OLs, just pad with zero data
-							for (int i=inLine.size(); i<40; i++)
-								inLine.append("@");
-					}
-					for (int i=1; i<=39; i++)
-						inLine[i] = inLine.at(i) & 0x3f;
+					loadingPage->setPacket(lineNumber, packet);
+				} else if (payload < lineEnd && *payload >= 0x40 && *payload <= 0x4f) {
+					const int designationCode = *payload & 0x3f;
+					QByteArray packet(40, Qt::Uninitialized);
+
+					decodeTTIDesignationPacket(lineNumber, payload, lineEnd, packet.data());
 					// Import M/29 whole-magazine packets as X/28 per-page packets
 					if (lineNumber == 29) {
 						if ((pageNum & 0xff) != 0xff)
@@ -200,8 +286,9 @@ bool LoadTTIFormat::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash
 						lineNumber = 28;
 					}
 					pageBodyPacketsFound = true;
-					loadingPage->setPacket(lineNumber, designationCode, inLine);
+					loadingPage->setPacket(lineNumber, designationCode, packet);
 				}
+				break;
 			}
 		}
 	}
@@ -248,9 +335,7 @@ bool LoadT42Format::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash
 			break;
 
 		// Magazine and packet numbers
-		m_inLine[0] = hamming_8_4_decode[m_inLine[0]];
-		m_inLine[1] = hamming_8_4_decode[m_inLine[1]];
-		if (m_inLine[0] == 0xff || m_inLine[1] == 0xff)
+		if (decodeHamming84(m_inLine, 2) != 0)
 			// Error decoding magazine or packet number
 			continue;
 		readMagazineNumber = m_inLine[0] & 0x07;
@@ -258,8 +343,7 @@ bool LoadT42Format::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash
 
 		if (readPacketNumber == 0) {
 			// Hamming decode page number, subcodes and control bits
-			for (int i=2; i<10; i++)
-				m_inLine[i] = hamming_8_4_decode[m_inLine[i]];
+			decodeHamming84(m_inLine + 2, 8);
 			// See if the page number is valid
 			if (m_inLine[2] == 0xff || m_inLine[3] == 0xff)
 				// Error decoding page number
@@ -313,11 +397,12 @@ bool LoadT42Format::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash
 				// See if there's text in the header row
 				bool headerText = false;
 
+				// TODO - obey odd parity?
+				decodeOddParity(m_inLine + 10, 32);
 				for (int i=10; i<42; i++)
 					if (m_inLine[i] != 0x20) {
-						// TODO - obey odd parity?
-						m_inLine[i] &= 0x7f;
 						headerText = true;
+						break;
 					}
 				if (headerText) {
 					// Clear the page address and control bits to spaces before putting the row in
@@ -344,15 +429,14 @@ bool LoadT42Format::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash
 		// At the moment this only loads a Level One Page properly
 		// because it assumes X/1 to X/25 is odd partity
 		if (readPacketNumber < 25) {
-			for (int i=2; i<42; i++)
-				// TODO - obey odd parity?
-				m_inLine[i] &= 0x7f;
+			// TODO - obey odd parity?
+			decodeOddParity(m_inLine + 2, 40);
 			loadingPage->setPacket(readPacketNumber, QByteArray((const char *)&m_inLine[2], 40));
 			continue;
 		}
 
 		// X/26, X/27 or X/28
-		int readDesignationCode = hamming_8_4_decode[m_inLine[2]];
+		int readDesignationCode = hamming84Decode(m_inLine[2]);
 
 		if (readDesignationCode == 0xff)
 			// Error decoding designation code
@@ -362,18 +446,9 @@ bool LoadT42Format::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash
 			// X/27/0 to X/27/3 for Editorial Linking
 			// Decode Hamming 8/4 on each of the six links, checking for errors on the way
 			for (int i=0; i<6; i++) {
-				bool decodingError = false;
 				const int b = 3 + i*6; // First byte of this link
 
-				for (int j=0; j<6; j++) {
-					m_inLine[b+j] = hamming_8_4_decode[m_inLine[b+j]];
-					if (m_inLine[b+j] == 0xff) {
-						decodingError = true;
-						break;
-					}
-				}
-
-				if (decodingError) {
+				if (decodeHamming84(m_inLine + b, 6) != 0) {
 					// Error found in at least one byte of the link
 					// Neutralise the whole link to same magazine, page FF, subcode 3F7F
 					qDebug("X/27/%d link %d decoding error", readDesignationCode, i);
@@ -393,51 +468,26 @@ bool LoadT42Format::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash
 
 		// X/26, or X/27/4 to X/27/15, or X/28
 		// Decode Hamming 24/18
-		for (int i=0; i<13; i++) {
-			const int b = 3 + i*3; // First byte of triplet
-
-			const int p0 = m_inLine[b];
-			const int p1 = m_inLine[b+1];
-			const int p2 = m_inLine[b+2];
-
-			unsigned int D1_D4;
-			unsigned int D5_D11;
-			unsigned int D12_D18;
-			unsigned int ABCDEF;
-			int32_t d;
-
-			D1_D4 = hamming_24_18_decode_d1_d4[p0 >> 2];
-			D5_D11 = p1 & 0x7f;
-			D12_D18 = p2 & 0x7f;
+		if (decodeHamming2418(m_inLine + 3, 13) != 0)
+			for (int i=0; i<13; i++) {
+				const int b = 3 + i*3; // First byte of triplet
 
-			d = D1_D4 | (D5_D11 << 4) | (D12_D18 << 11);
-
-			ABCDEF = (hamming_24_18_parities[0][p0] ^ hamming_24_18_parities[1][p1]  ^ hamming_24_18_parities[2][p2]);
-
-			d ^= (int)hamming_24_18_decode_correct[ABCDEF];
+				if (m_inLine[b] != 0xff)
+					continue;
 
-			if ((d & 0x80000000) == 0x80000000) {
 				// Error decoding Hamming 24/18
 				qDebug("X/%d/%d triplet %d decoding error", readPacketNumber, readDesignationCode, i);
-				if (readPacketNumber == 26) {
-					// Enhancements packet, set to invalid triplet
-					m_inLine[b]   = 0xff;
-					m_inLine[b+1] = 0xff;
-					m_inLine[b+2] = 0xff;
+				if (readPacketNumber == 26)
+					// Enhancements packet, leave as invalid triplet
 					errorEnhancements = true;
-				} else {
+				else {
 					// Zero out whole decoded triplet, bound to make things go wrong...
 					m_inLine[b]   = 0x00;
 					m_inLine[b+1] = 0x00;
 					m_inLine[b+2] = 0x00;
 					errorPresentation = true;
 				}
-			} else {
-				m_inLine[b]   = d & 0x0003f;
-				m_inLine[b+1] = (d & 0x00fc0) >> 6;
-				m_inLine[b+2] = d >> 12;
 			}
-		}
 		loadingPage->setPacket(readPacketNumber, readDesignationCode, QByteArray((const char *)&m_inLine[2], 40));
 	}
 
@@ -608,6 +658,130 @@ bool LoadEP1Format::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash
 }
 
 
+bool LoadProjectFormat::load(QFile *inFile, QList<PageBase>& subPages, QVariantHash *metadata)
+{
+	m_warnings.clear();
+	m_error.clear();
+
+	// Packets are copied straight out of the mapped file, falling back to reading it all in
+	// for devices that can't be mapped
+	const qint64 size = inFile->size();
+	uchar *mappedData = (size > 0) ? inFile->map(0, size) : nullptr;
+	bool result;
+
+	if (mappedData != nullptr) {
+		result = loadData(mappedData, size, subPages, metadata);
+		inFile->unmap(mappedData);
+	} else {
+		const QByteArray inData = inFile->readAll();
+
+		result = loadData(reinterpret_cast<const uchar *>(inData.constData()), inData.size(), subPages, metadata);
+	}
+
+	return result;
+}
+
+bool LoadProjectFormat::loadData(const uchar *data, qint64 size, QList<PageBase>& subPages, QVariantHash *metadata)
+{
+	if (size < ProjectFormat::HeaderSize || std::memcmp(data, ProjectFormat::Magic, sizeof(ProjectFormat::Magic)) != 0) {
+		m_error = "Not a QTeletextMaker project file";
+		return false;
+	}
+
+	if (qFromLittleEndian<quint16>(data + 8) > ProjectFormat::Version) {
+		m_error = "Project file was saved by a newer version";
+		return false;
+	}
+
+	const int headerSize = qFromLittleEndian<quint16>(data + 10);
+	const int pageNumber = qFromLittleEndian<quint16>(data + 12);
+	const int recordSize = qFromLittleEndian<quint16>(data + 14);
+	const qint64 descriptionSize = qFromLittleEndian<quint32>(data + 16);
+
+	if (headerSize < ProjectFormat::HeaderSize || recordSize < ProjectFormat::SubPageRecordSize || headerSize + descriptionSize > size) {
+		m_error = "Project file header is corrupt";
+		return false;
+	}
+
+	if (metadata != nullptr) {
+		if (pageNumber >= 0x100 && pageNumber <= 0x8ff)
+			metadata->insert("pageNumber", pageNumber);
+		if (descriptionSize != 0)
+			metadata->insert("description", QString::fromUtf8(reinterpret_cast<const char *>(data + headerSize), descriptionSize));
+	}
+
+	const uchar *next = data + headerSize + descriptionSize;
+	const uchar *const dataEnd = data + size;
+	int subPageNum = 0;
+
+	while (next < dataEnd) {
+		if (dataEnd - next < recordSize) {
+			m_error = "Project file is truncated";
+			return false;
+		}
+
+		const int controlBits = qFromLittleEndian<quint16>(next);
+		const int region = next[2];
+		const int cycleValue = next[3];
+		const char cycleType = next[4];
+		const quint32 displayPackets = qFromLittleEndian<quint32>(next + 8);
+		const int designationPackets[3] = { qFromLittleEndian<quint16>(next + 12), qFromLittleEndian<quint16>(next + 14), qFromLittleEndian<quint16>(next + 16) };
+		const qint64 packetCount = qFromLittleEndian<quint32>(next + 20);
+
+		int packetsPresent = std::bitset<26>(displayPackets).count();
+
+		for (int i=0; i<3; i++)
+			packetsPresent += std::bitset<16>(designationPackets[i]).count();
+
+		next += recordSize;
+
+		if (packetCount != packetsPresent || dataEnd - next < packetCount * ProjectFormat::PacketSize) {
+			m_error = "Project file is truncated or corrupt";
+			return false;
+		}
+
+		subPages.append(PageBase { } );
+
+		PageBase *loadingPage = &subPages[subPages.size()-1];
+
+		for (int i=PageBase::C4ErasePage; i<=PageBase::C14NOS; i++)
+			loadingPage->setControlBit(i, controlBits & (1 << i));
+
+		for (int y=0; y<26; y++)
+			if (displayPackets & (1 << y)) {
+				loadingPage->setPacket(y, QByteArray(reinterpret_cast<const char *>(next), ProjectFormat::PacketSize));
+				next += ProjectFormat::PacketSize;
+			}
+
+		for (int y=26; y<29; y++)
+			for (int d=0; d<16; d++)
+				if (designationPackets[y-26] & (1 << d)) {
+					loadingPage->setPacket(y, d, QByteArray(reinterpret_cast<const char *>(next), ProjectFormat::PacketSize));
+					next += ProjectFormat::PacketSize;
+				}
+
+		if (metadata != nullptr) {
+			if (region <= 15)
+				metadata->insert(subPageMetadataKey("region", subPageNum), region);
+			// Same range as the TTI CT command, anything else leaves the default cycle
+			if ((cycleType == 'C' || cycleType == 'T') && cycleValue >= 1 && cycleValue <= 99) {
+				metadata->insert(subPageMetadataKey("cycleValue", subPageNum), cycleValue);
+				metadata->insert(subPageMetadataKey("cycleType", subPageNum), QChar(cycleType));
+			}
+		}
+
+		subPageNum++;
+	}
+
+	if (subPageNum == 0) {
+		m_error = "No subpages found";
+		return false;
+	}
+
+	return true;
+}
+
+
 int LoadFormats::s_instances = 0;
 
 LoadFormats::LoadFormats()
@@ -617,6 +791,7 @@ LoadFormats::LoadFormats()
 		s_fileFormat[1] = new LoadT42Format;
 		s_fileFormat[2] = new LoadEP1Format;
 		s_fileFormat[3] = new LoadHTTFormat;
+		s_fileFormat[4] = new LoadProjectFormat;
 
 		s_filters = "All Supported Files (*.";
 
@@ -654,3 +829,10 @@ LoadFormat *LoadFormats::findFormat(const QString &suffix) const
 
 	return nullptr;
 }
+
+LoadFormat *LoadFormats::createFormat(const QString &suffix) const
+{
+	const LoadFormat *format = findFormat(suffix);
+
+	return (format != nullptr) ? format->create() : nullptr;
+}
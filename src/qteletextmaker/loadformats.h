@@ -36,6 +36,8 @@ public:
 	virtual ~LoadFormat() {};
 
 	virtual bool load(QFile *inFile, QList<PageBase> &subPages, QVariantHash *metadata = nullptr) =0;
+	// New instance of the same format, for loading on another thread
+	virtual LoadFormat *create() const =0;
 
 	virtual QString description() const =0;
 	virtual QStringList extensions() const =0;
@@ -53,6 +55,7 @@ protected:
 class LoadTTIFormat : public LoadFormat
 {
 public:
+	LoadFormat *create() const override { return new LoadTTIFormat; };
 	bool load(QFile *inFile, QList<PageBase> &subPages, QVariantHash *metadata = nullptr) override;
 
 	QString description() const override { return QString("MRG Systems TTI"); };
@@ -62,6 +65,7 @@ public:
 class LoadT42Format : public LoadFormat
 {
 public:
+	LoadFormat *create() const override { return new LoadT42Format; };
 	bool load(QFile *inFile, QList<PageBase> &subPages, QVariantHash *metadata = nullptr) override;
 
 	QString description() const override { return QString("t42 packet stream"); };
@@ -77,6 +81,7 @@ protected:
 class LoadHTTFormat : public LoadT42Format
 {
 public:
+	LoadFormat *create() const override { return new LoadHTTFormat; };
 	QString description() const override { return QString("HMS SD-Teletext HTT"); };
 	QStringList extensions() const override { return QStringList { "htt" }; };
 
@@ -87,6 +92,7 @@ protected:
 class LoadEP1Format : public LoadFormat
 {
 public:
+	LoadFormat *create() const override { return new LoadEP1Format; };
 	bool load(QFile *inFile, QList<PageBase> &subPages, QVariantHash *metadata = nullptr) override;
 
 	QString description() const override { return QString("Softel EP1"); };
@@ -106,6 +112,19 @@ protected:
 	};
 };
 
+class LoadProjectFormat : public LoadFormat
+{
+public:
+	LoadFormat *create() const override { return new LoadProjectFormat; };
+	bool load(QFile *inFile, QList<PageBase> &subPages, QVariantHash *metadata = nullptr) override;
+
+	QString description() const override { return QString("QTeletextMaker project"); };
+	QStringList extensions() const override { return QStringList { "tmb" }; };
+
+protected:
+	bool loadData(const uchar *data, qint64 size, QList<PageBase> &subPages, QVariantHash *metadata);
+};
+
 
 class LoadFormats
 {
@@ -114,10 +133,11 @@ public:
 	~LoadFormats();
 
 	LoadFormat *findFormat(const QString &suffix) const;
+	LoadFormat *createFormat(const QString &suffix) const;
 	QString filters() const { return s_filters; };
 
 private:
-	static const inline int s_size = 4;
+	static const inline int s_size = 5;
 	static int s_instances;
 	inline static LoadFormat *s_fileFormat[s_size];
 	inline static QString s_filters;
@@ -19,18 +19,343 @@
 
 #include <QApplication>
 #include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QPointer>
+#include <QSize>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <QVariant>
 
+#include <iostream>
+#include <memory>
+
+#include "batchexport.h"
+#include "document.h"
+#include "loadformats.h"
 #include "mainwindow.h"
+#include "offscreenrender.h"
+#include "packetstream.h"
+#include "startuptiming.h"
+#include "videowriter.h"
+
+static void setApplicationDetails()
+{
+	QCoreApplication::setApplicationName("QTeletextMaker");
+	QCoreApplication::setOrganizationName("gkmac.co.uk");
+	QCoreApplication::setOrganizationDomain("gkmac.co.uk");
+	QCoreApplication::setApplicationVersion("0.8.1-beta");
+}
+
+// Batch export, video and packet streams don't open any windows,
+// so they have to be spotted before the application object is created
+static bool commandLineOnlyRequested(int argc, char *argv[])
+{
+	for (int i=1; i<argc; i++)
+		if (qstrncmp(argv[i], "--export", 8) == 0 || qstrncmp(argv[i], "--video", 7) == 0 || qstrncmp(argv[i], "--stream", 8) == 0)
+			return true;
+
+	return false;
+}
+
+static bool loadDocument(const QString &fileName, TeletextDocument &document)
+{
+	LoadFormats loadFormats;
+	std::unique_ptr<LoadFormat> loadingFormat(loadFormats.createFormat(QFileInfo(fileName).suffix()));
+
+	if (loadingFormat == nullptr) {
+		std::cerr << qPrintable(QDir::toNativeSeparators(fileName)) << ": Unknown file format or extension" << std::endl;
+		return false;
+	}
+
+	QFile file(fileName);
+
+	if (!file.open(QFile::ReadOnly)) {
+		std::cerr << qPrintable(QDir::toNativeSeparators(fileName)) << ": " << qPrintable(file.errorString()) << std::endl;
+		return false;
+	}
+
+	QList<PageBase> subPages;
+	QVariantHash metadata;
+
+	if (!loadingFormat->load(&file, subPages, &metadata)) {
+		std::cerr << qPrintable(QDir::toNativeSeparators(fileName)) << ": " << qPrintable(loadingFormat->errorString()) << std::endl;
+		return false;
+	}
+
+	document.loadFromList(subPages);
+	document.loadMetaData(metadata);
+
+	return true;
+}
+
+// Named pipes are opened like any other file, waiting here until something reads from them
+static bool openOutput(QFile &outputFile, const QString &output)
+{
+	bool opened;
+
+	if (output == "-")
+		opened = outputFile.open(stdout, QIODevice::WriteOnly);
+	else {
+		outputFile.setFileName(output);
+		opened = outputFile.open(QIODevice::WriteOnly);
+	}
+
+	if (!opened)
+		std::cerr << "Cannot open " << qPrintable(QDir::toNativeSeparators(output)) << " for writing: " << qPrintable(outputFile.errorString()) << std::endl;
+
+	return opened;
+}
+
+static int videoStream(const QCommandLineParser &parser, const QString &output, TeletextOffscreenRender::Options options)
+{
+	const QString pixelFormatName = parser.value("pixel-format").toLower();
+	const int frameRate = parser.value("fps").toInt();
+	RawVideoWriter::PixelFormat pixelFormat;
+
+	if (pixelFormatName == "rgb24")
+		pixelFormat = RawVideoWriter::PixelRGB24;
+	else if (pixelFormatName == "rgba")
+		pixelFormat = RawVideoWriter::PixelRGBA;
+	else if (pixelFormatName == "yuv420")
+		pixelFormat = RawVideoWriter::PixelYUV420;
+	else {
+		std::cerr << "Unknown pixel format " << qPrintable(pixelFormatName) << std::endl;
+		return BatchExport::ExitUsageError;
+	}
+
+	if (frameRate != 25 && frameRate != 50) {
+		std::cerr << "Frame rate must be 25 or 50" << std::endl;
+		return BatchExport::ExitUsageError;
+	}
+	if (parser.positionalArguments().size() != 1) {
+		std::cerr << "Give one file to stream" << std::endl;
+		return BatchExport::ExitUsageError;
+	}
+
+	TeletextDocument document;
+
+	if (!loadDocument(parser.positionalArguments().first(), document))
+		return BatchExport::ExitFileErrors;
+
+	options.level = document.levelRequired();
+
+	RawVideoWriter videoWriter(document);
+
+	videoWriter.setRenderOptions(options);
+	videoWriter.setPixelFormat(pixelFormat);
+	videoWriter.setFrameRate(frameRate);
+	videoWriter.setCycleTime(qMax(parser.value("cycle-time").toInt(), 1));
+
+	QFile outputFile;
+
+	if (!openOutput(outputFile, output))
+		return BatchExport::ExitFileErrors;
+
+	const QSize frameSize = videoWriter.frameSize();
+
+	// Standard output carries the frames, so anything else goes to standard error
+	std::cerr << frameSize.width() << "x" << frameSize.height() << " " << qPrintable(pixelFormatName) << " at " << frameRate << " fps" << std::endl;
+
+	// No duration streams one cycle through the subpages, 0 streams until the reader goes away
+	const int duration = parser.isSet("duration") ? qMax(parser.value("duration").toInt(), 0) * 1000 : -1;
+	const bool written = videoWriter.write(&outputFile, duration);
+
+	outputFile.close();
+
+	if (!written) {
+		std::cerr << qPrintable(videoWriter.errorString()) << std::endl;
+		return BatchExport::ExitFileErrors;
+	}
+
+	std::cerr << videoWriter.renderCount() << " frames rendered" << std::endl;
+	return BatchExport::ExitSuccess;
+}
+
+static int packetStream(const QCommandLineParser &parser, const QString &output)
+{
+	const int linesPerField = parser.value("lines").toInt();
+	const int reportInterval = qMax(parser.value("report").toInt(), 0) * T42PacketStream::FieldsPerSecond;
+
+	if (linesPerField < 1 || linesPerField > 32) {
+		std::cerr << "Lines per field must be from 1 to 32" << std::endl;
+		return BatchExport::ExitUsageError;
+	}
+
+	T42PacketStream packetStream;
+	LoadFormats loadFormats;
+	int failures = 0;
+
+	packetStream.setLinesPerField(linesPerField);
+	packetStream.setMagazineMode(parser.isSet("serial") ? T42PacketStream::SerialMagazines : T42PacketStream::ParallelMagazines);
+	packetStream.setHeaderClock(!parser.isSet("no-clock"));
+
+	// Directories hold a whole service, so take every loadable file within them
+	for (const QString &input : parser.positionalArguments()) {
+		QStringList fileNames { input };
+
+		if (QFileInfo(input).isDir()) {
+			fileNames.clear();
+			for (const QFileInfo &entry : QDir(input).entryInfoList(QDir::Files, QDir::Name))
+				if (loadFormats.findFormat(entry.suffix()) != nullptr)
+					fileNames.append(entry.filePath());
+		}
+
+		for (const QString &fileName : fileNames) {
+			TeletextDocument document;
+
+			if (loadDocument(fileName, document))
+				packetStream.addDocument(document);
+			else
+				failures++;
+		}
+	}
+
+	if (packetStream.pageCount() == 0) {
+		std::cerr << "No pages to stream" << std::endl;
+		return BatchExport::ExitUsageError;
+	}
+
+	QFile outputFile;
+
+	if (!openOutput(outputFile, output))
+		return BatchExport::ExitFileErrors;
+
+	std::cerr << packetStream.pageCount() << " pages at " << linesPerField << " lines per field" << std::endl;
+
+	// Without a duration the stream carries on until the reader goes away
+	const qint64 fieldsToSend = qMax(parser.value("duration").toInt(), 0) * qint64(T42PacketStream::FieldsPerSecond);
+	const bool realTime = parser.isSet("realtime");
+	QElapsedTimer clock;
+	bool written = true;
+
+	clock.start();
+
+	while (fieldsToSend == 0 || packetStream.fieldCount() < fieldsToSend) {
+		// Real time output is kept no more than one field ahead of the clock
+		if (realTime) {
+			const qint64 due = packetStream.fieldCount() * 1000 / T42PacketStream::FieldsPerSecond;
+
+			if (clock.elapsed() < due)
+				QThread::msleep(due - clock.elapsed());
+		}
+
+		const QByteArray field = packetStream.nextField();
+
+		if (outputFile.write(field) != field.size()) {
+			std::cerr << qPrintable(outputFile.errorString()) << std::endl;
+			written = false;
+			break;
+		}
+		if (realTime)
+			outputFile.flush();
+
+		if (reportInterval != 0 && packetStream.fieldCount() % reportInterval == 0)
+			std::cerr << qPrintable(packetStream.utilisationReport()) << std::flush;
+	}
+
+	outputFile.close();
+
+	std::cerr << qPrintable(packetStream.utilisationReport()) << std::flush;
+
+	return (written && failures == 0) ? BatchExport::ExitSuccess : BatchExport::ExitFileErrors;
+}
+
+static int commandLineOnly(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	setApplicationDetails();
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(QCoreApplication::applicationName());
+	parser.addHelpOption();
+	parser.addVersionOption();
+	parser.addPositionalArgument("file", "The file(s) or directories to export.");
+
+	const QCommandLineOption exportOption("export", "Export the files into <directory> without opening any windows.", "directory");
+	const QCommandLineOption formatOption("format", "Export format: png, gif, tti, tmb, t42, htt or ep1.", "format", "png");
+	const QCommandLineOption borderOption("border", "Image border: 0 none, 1 minimal, 2 full TV.", "border", "0");
+	const QCommandLineOption aspectOption("aspect", "Image aspect ratio: 0 4:3, 1 16:9 pillar box, 2 16:9 stretch, 3 pixel 1:2.", "aspect", "0");
+	const QCommandLineOption scaleOption("scale", "Image scale factor from 1 to 8.", "scale", "1");
+	const QCommandLineOption smoothOption("smooth", "Smooth the horizontal aspect ratio scaling of PNG images.");
+	const QCommandLineOption revealOption("reveal", "Reveal concealed characters.");
+	const QCommandLineOption carouselOption("carousel", "Export all the subpages of each file as one animated GIF, each shown for its cycle time.");
+	const QCommandLineOption jobsOption("jobs", "Number of files to export at once, defaults to the number of processors.", "jobs", "0");
+	const QCommandLineOption videoOption("video", "Stream raw video frames of one file to <output>, which can be a named pipe or - for standard output.", "output");
+	const QCommandLineOption pixelFormatOption("pixel-format", "Video pixel format: rgb24, rgba or yuv420.", "format", "rgb24");
+	const QCommandLineOption fpsOption("fps", "Video frame rate: 25 or 50.", "fps", "25");
+	const QCommandLineOption streamOption("stream", "Stream the pages of all the files as t42 packets to <output>, which can be a named pipe or - for standard output.", "output");
+	const QCommandLineOption linesOption("lines", "Packet stream VBI lines per field.", "lines", "16");
+	const QCommandLineOption serialOption("serial", "Send the packet stream magazines in serial mode instead of parallel.");
+	const QCommandLineOption realTimeOption("realtime", "Send the packet stream at 50 fields per second.");
+	const QCommandLineOption noClockOption("no-clock", "Leave the end of the packet stream header rows as they are instead of putting the time there.");
+	const QCommandLineOption reportOption("report", "Report packet stream line use every <seconds>, as well as at the end.", "seconds", "0");
+	const QCommandLineOption cycleTimeOption("cycle-time", "Milliseconds to show each cycle of subpages timed in cycles rather than seconds, in carousel GIFs and video.", "milliseconds", QString::number(TeletextDocument::DefaultCycleTime));
+	const QCommandLineOption durationOption("duration", "Stream length in seconds, 0 to stream until the output is closed. Video defaults to one cycle through the subpages, packet streams to 0.", "seconds");
+
+	parser.addOptions({ exportOption, formatOption, borderOption, aspectOption, scaleOption, smoothOption, revealOption, carouselOption, jobsOption, videoOption, pixelFormatOption, fpsOption, streamOption, linesOption, serialOption, realTimeOption, noClockOption, reportOption, cycleTimeOption, durationOption });
+	parser.process(app);
+
+	TeletextOffscreenRender::Options options;
+
+	options.border = qBound(0, parser.value(borderOption).toInt(), 2);
+	options.aspectRatio = qBound(0, parser.value(aspectOption).toInt(), 3);
+	options.scale = qBound(1, parser.value(scaleOption).toInt(), 8);
+	options.smooth = parser.isSet(smoothOption);
+	options.reveal = parser.isSet(revealOption);
+
+	if (parser.isSet(videoOption))
+		return videoStream(parser, parser.value(videoOption), options);
+	if (parser.isSet(streamOption))
+		return packetStream(parser, parser.value(streamOption));
+
+	BatchExport batchExport(parser.value(exportOption), parser.value(formatOption));
+
+	batchExport.setRenderOptions(options);
+	batchExport.setCarousel(parser.isSet(carouselOption));
+	batchExport.setCycleTime(qMax(parser.value(cycleTimeOption).toInt(), 1));
+	batchExport.setThreadCount(parser.value(jobsOption).toInt());
+
+	const int result = batchExport.run(parser.positionalArguments());
+
+	if (result == BatchExport::ExitUsageError)
+		std::cerr << qPrintable(batchExport.errorString()) << std::endl;
+
+	return result;
+}
+
+// One window is opened per pass of the event loop, so the first window can be shown and used
+// while the rest are still being loaded
+static void openWindows(const QStringList &files, int index, QPointer<MainWindow> previous)
+{
+	MainWindow *newWin = new MainWindow(files.at(index));
+
+	newWin->tile(previous.data());
+	newWin->show();
+	StartupTiming::phase(index == 0 ? "First window shown" : "Another window shown");
+
+	if (index + 1 < files.size())
+		QTimer::singleShot(0, [=]() { openWindows(files, index + 1, newWin); });
+	else
+		QTimer::singleShot(0, []() { StartupTiming::phase("All windows open"); });
+}
 
 int main(int argc, char *argv[])
 {
+	if (commandLineOnlyRequested(argc, argv))
+		return commandLineOnly(argc, argv);
+
+	StartupTiming::start();
 	Q_INIT_RESOURCE(actionicons);
 	QApplication app(argc, argv);
-	QApplication::setApplicationName("QTeletextMaker");
+	StartupTiming::phase("Application created");
+	setApplicationDetails();
 	QApplication::setApplicationDisplayName(QApplication::applicationName());
-	QApplication::setOrganizationName("gkmac.co.uk");
-	QApplication::setOrganizationDomain("gkmac.co.uk");
-	QApplication::setApplicationVersion("0.8.1-beta");
 	QCommandLineParser parser;
 	parser.setApplicationDescription(QApplication::applicationName());
 	parser.addHelpOption();
@@ -38,17 +363,14 @@ int main(int argc, char *argv[])
 	parser.addPositionalArgument("file", "The file(s) to open.");
 	parser.process(app);
 
-	MainWindow *mainWin = Q_NULLPTR;
-	foreach (const QString &file, parser.positionalArguments()) {
-		MainWindow *newWin = new MainWindow(file);
-		newWin->tile(mainWin);
-		newWin->show();
-		mainWin = newWin;
-	}
+	if (parser.positionalArguments().isEmpty()) {
+		MainWindow *mainWin = new MainWindow;
 
-	if (!mainWin)
-		mainWin = new MainWindow;
-	mainWin->show();
+		mainWin->show();
+		StartupTiming::phase("First window shown");
+		QTimer::singleShot(0, []() { StartupTiming::phase("Event loop running"); });
+	} else
+		openWindows(parser.positionalArguments(), 0, nullptr);
 
 	return app.exec();
 }
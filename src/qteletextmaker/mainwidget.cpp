@@ -32,7 +32,6 @@
 #include <QMimeData>
 #include <QPainter>
 #include <QPair>
-#include <QSet>
 #include <QUndoCommand>
 #include <QWidget>
 #include <vector>
@@ -226,7 +225,9 @@ void TeletextWidget::keyPressEvent(QKeyEvent *event)
 	if (event->key() < 0x01000000) {
 		// A character-typing key was pressed
 		// Try to keymap it, if not keymapped then plain ASCII code (may be) returned
-		char mappedKeyPress = keymapping[m_pageDecode.level1CharSet(m_teletextDocument->cursorRow(), m_teletextDocument->cursorColumn())].value(event->text().at(0), *qPrintable(event->text().at(0)));
+		char mappedKeyPress = keymapToTeletext(m_pageDecode.level1CharSet(m_teletextDocument->cursorRow(), m_teletextDocument->cursorColumn()), event->text().at(0));
+		if (mappedKeyPress == 0)
+			mappedKeyPress = *qPrintable(event->text().at(0));
 		if (mappedKeyPress >= 0x00 && mappedKeyPress <= 0x1f)
 			return;
 		// If outside ASCII map then the character can't be represented by current Level 1 character set
@@ -397,29 +398,29 @@ void TeletextWidget::toggleCharacterBit(unsigned char bitToToggle)
 	if (!m_teletextDocument->selectionActive())
 		m_teletextDocument->undoStack()->push(new ToggleMosaicBitCommand(m_teletextDocument, bitToToggle));
 	else {
-		const QSet<QPair<int, int>> mosaicList = findMosaics();
+		const MosaicBitplane mosaics = findMosaics();
 
-		if (!mosaicList.isEmpty())
+		if (!mosaics.isEmpty())
 			switch (bitToToggle) {
 				case 0x7f:
-					m_teletextDocument->undoStack()->push(new FillMosaicsCommand(m_teletextDocument, mosaicList));
+					m_teletextDocument->undoStack()->push(new FillMosaicsCommand(m_teletextDocument, mosaics));
 					break;
 				case 0x20:
-					m_teletextDocument->undoStack()->push(new ClearMosaicsCommand(m_teletextDocument, mosaicList));
+					m_teletextDocument->undoStack()->push(new ClearMosaicsCommand(m_teletextDocument, mosaics));
 					break;
 				case 0x5f:
-					m_teletextDocument->undoStack()->push(new InvertMosaicsCommand(m_teletextDocument, mosaicList));
+					m_teletextDocument->undoStack()->push(new InvertMosaicsCommand(m_teletextDocument, mosaics));
 					break;
 				case 0x66:
-					m_teletextDocument->undoStack()->push(new DitherMosaicsCommand(m_teletextDocument, mosaicList));
+					m_teletextDocument->undoStack()->push(new DitherMosaicsCommand(m_teletextDocument, mosaics));
 					break;
 			}
 	}
 }
 
-QSet<QPair<int, int>> TeletextWidget::findMosaics()
+MosaicBitplane TeletextWidget::findMosaics()
 {
-	QSet<QPair<int, int>> result;
+	MosaicBitplane result;
 
 	if (!m_teletextDocument->selectionActive())
 		return result;
@@ -427,28 +428,28 @@ QSet<QPair<int, int>> TeletextWidget::findMosaics()
 	for (int r=m_teletextDocument->selectionTopRow(); r<=m_teletextDocument->selectionBottomRow(); r++)
 		for (int c=m_teletextDocument->selectionLeftColumn(); c<=m_teletextDocument->selectionRightColumn(); c++)
 			if (m_pageDecode.level1MosaicChar(r, c))
-				result.insert(qMakePair(r, c));
+				result.addCell(r, c);
 
 	return result;
 }
 
 void TeletextWidget::shiftMosaics(int key)
 {
-	const QSet<QPair<int, int>> mosaicList = findMosaics();
+	const MosaicBitplane mosaics = findMosaics();
 
-	if (!mosaicList.isEmpty())
+	if (!mosaics.isEmpty())
 		switch (key) {
 			case Qt::Key_Up:
-				m_teletextDocument->undoStack()->push(new ShiftMosaicsUpCommand(m_teletextDocument, mosaicList));
+				m_teletextDocument->undoStack()->push(new ShiftMosaicsUpCommand(m_teletextDocument, mosaics));
 				break;
 			case Qt::Key_Down:
-				m_teletextDocument->undoStack()->push(new ShiftMosaicsDownCommand(m_teletextDocument, mosaicList));
+				m_teletextDocument->undoStack()->push(new ShiftMosaicsDownCommand(m_teletextDocument, mosaics));
 				break;
 			case Qt::Key_Left:
-				m_teletextDocument->undoStack()->push(new ShiftMosaicsLeftCommand(m_teletextDocument, mosaicList));
+				m_teletextDocument->undoStack()->push(new ShiftMosaicsLeftCommand(m_teletextDocument, mosaics));
 				break;
 			case Qt::Key_Right:
-				m_teletextDocument->undoStack()->push(new ShiftMosaicsRightCommand(m_teletextDocument, mosaicList));
+				m_teletextDocument->undoStack()->push(new ShiftMosaicsRightCommand(m_teletextDocument, mosaics));
 				break;
 		}
 }
@@ -472,9 +473,11 @@ void TeletextWidget::selectionToClipboard()
 		for (int c=m_teletextDocument->selectionLeftColumn(); c<=m_teletextDocument->selectionRightColumn(); c++) {
 			nativeData[i++] = m_teletextDocument->currentSubPage()->character(r, c);
 
-			if (m_teletextDocument->currentSubPage()->character(r, c) >= 0x20)
-				plainTextData.append(keymapping[m_pageDecode.level1CharSet(r, c)].key(m_teletextDocument->currentSubPage()->character(r, c), QChar(m_teletextDocument->currentSubPage()->character(r, c))));
-			else
+			if (m_teletextDocument->currentSubPage()->character(r, c) >= 0x20) {
+				const QChar mappedChar = keymapToUnicode(m_pageDecode.level1CharSet(r, c), m_teletextDocument->currentSubPage()->character(r, c));
+
+				plainTextData.append(mappedChar.isNull() ? QChar(m_teletextDocument->currentSubPage()->character(r, c)) : mappedChar);
+			} else
 				plainTextData.append(' ');
 
 			if (m_pageDecode.level1MosaicChar(r, c)) {
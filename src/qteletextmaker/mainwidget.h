@@ -32,6 +32,7 @@
 #include "decode.h"
 #include "document.h"
 #include "levelonepage.h"
+#include "mosaicbitplane.h"
 #include "render.h"
 
 class QPaintEvent;
@@ -106,7 +107,7 @@ private:
 	int m_flashTiming, m_flashPhase;
 
 	void timerEvent(QTimerEvent *event) override;
-	QSet<QPair<int, int>> findMosaics();
+	MosaicBitplane findMosaics();
 	void shiftMosaics(int key);
 	void selectionToClipboard();
 
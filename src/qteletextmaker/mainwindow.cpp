@@ -19,11 +19,15 @@
 
 #include <QActionGroup>
 #include <QApplication>
+#include <QByteArray>
+#include <QByteArrayList>
 #include <QClipboard>
 #include <QDesktopServices>
 #include <QFileDialog>
 #include <QFileSystemWatcher>
 #include <QImage>
+#include <QImageReader>
+#include <QInputDialog>
 #include <QList>
 #include <QMenuBar>
 #include <QMessageBox>
@@ -46,19 +50,24 @@
 
 #include "dclutdockwidget.h"
 #include "drcspage.h"
+#include "drcsregistry.h"
+#include "gifwriter.h"
 #include "hashformats.h"
+#include "importimagedialog.h"
 #include "levelonecommands.h"
 #include "loadformats.h"
 #include "mainwidget.h"
+#include "offscreenrender.h"
 #include "pagecomposelinksdockwidget.h"
 #include "pageenhancementsdockwidget.h"
 #include "pageoptionsdockwidget.h"
 #include "palettedockwidget.h"
 #include "saveformats.h"
+#include "servicedockwidget.h"
+#include "startuptiming.h"
+#include "undohistory.h"
 #include "x26dockwidget.h"
 
-#include "gifimage/qgifimage.h"
-
 MainWindow::MainWindow()
 {
 	init();
@@ -96,6 +105,18 @@ void MainWindow::open()
 		openFile(fileName);
 }
 
+void MainWindow::openServiceDirectory()
+{
+	const QString path = QFileDialog::getExistingDirectory(this, tr("Open service directory"));
+	if (path.isEmpty())
+		return;
+
+	ensureDockWidget(ServiceDock);
+	m_serviceDockWidget->show();
+	m_serviceDockWidget->raise();
+	m_serviceDockWidget->openDirectory(path);
+}
+
 void MainWindow::openFile(const QString &fileName)
 {
 	MainWindow *existing = findMainWindow(fileName);
@@ -186,64 +207,31 @@ void MainWindow::reload()
 	m_textWidget->document()->selectSubPageIndex(subPageIndex, true);
 }
 
-void MainWindow::extractImages(QImage sceneImage[], bool smooth, bool flashExtract)
+// Render the page separately from the scene, so the GUI elements don't need to be hidden
+// and the images come out already scaled to the selected aspect ratio
+void MainWindow::prepareOffscreenRender(TeletextOffscreenRender &offscreenRender, TeletextOffscreenRender::Options &options) const
 {
-	// Prepare widget image for extraction
-	m_textScene->hideGUIElements(true);
-
-	if (m_textWidget->pageRender()->renderMode() == TeletextPageRender::RenderMix)
-		m_textScene->setBackgroundBrush(Qt::NoBrush);
-
-	const int flashTiming = flashExtract ? m_textWidget->flashTiming() : 0;
-
-	// Allocate initial image, with additional images for flashing if necessary
-	QImage interImage[6];
+	offscreenRender.setTeletextPage(m_textWidget->document()->currentSubPage());
+	offscreenRender.setDRCSPage(TeletextPageDecode::NormalDRCSPage, m_textWidget->pageDecode()->drcsPage(TeletextPageDecode::NormalDRCSPage));
+	offscreenRender.setDRCSPage(TeletextPageDecode::GlobalDRCSPage, m_textWidget->pageDecode()->drcsPage(TeletextPageDecode::GlobalDRCSPage));
+
+	options.renderMode = m_textWidget->pageRender()->renderMode();
+	options.reveal = m_textWidget->pageRender()->reveal();
+	options.level = m_textWidget->pageDecode()->level();
+	options.border = m_viewBorder;
+	options.aspectRatio = m_viewAspectRatio;
+	options.scale = 1;
+}
 
-	interImage[0] = QImage(m_textScene->sceneRect().size().toSize(), QImage::Format_ARGB32);
-	if (flashTiming != 0) {
-		interImage[3] = QImage(m_textScene->sceneRect().size().toSize(), QImage::Format_ARGB32);
-		if (flashTiming == 2) {
-			interImage[1] = QImage(m_textScene->sceneRect().size().toSize(), QImage::Format_ARGB32);
-			interImage[2] = QImage(m_textScene->sceneRect().size().toSize(), QImage::Format_ARGB32);
-			interImage[4] = QImage(m_textScene->sceneRect().size().toSize(), QImage::Format_ARGB32);
-			interImage[5] = QImage(m_textScene->sceneRect().size().toSize(), QImage::Format_ARGB32);
-		}
-	}
+QImage MainWindow::extractImage(bool smooth)
+{
+	TeletextOffscreenRender offscreenRender;
+	TeletextOffscreenRender::Options options;
 
-	// Now extract the image(s) from the scene
-	for (int p=0; p<6; p++)
-		if (!interImage[p].isNull()) {
-			m_textWidget->pauseFlash(p);
-			// Alpha'd parts of image copied leave uninitialised pixels as uninitialised
-			// so prefill with the transparent "colour" first.
-			// When extracting flashing images, assume we're going to write a GIF
-			// which doesn't have alpha but instead swaps a selected colour for transparency.
-			interImage[p].fill(flashExtract ? QColor(1, 1, 1) : QColor(0, 0, 0, 0));
-			QPainter interPainter(&interImage[p]);
-			m_textScene->render(&interPainter);
-		}
+	prepareOffscreenRender(offscreenRender, options);
+	options.smooth = smooth;
 
-	// Now we've extracted the image we can put the GUI things back
-	if (m_textWidget->pageRender()->renderMode() == TeletextPageRender::RenderMix)
-		m_textScene->setBackgroundBrush(QColor(40, 54, 96));
-
-	m_textScene->hideGUIElements(false);
-	m_textWidget->resumeFlash();
-
-	// Now scale the extracted image(s) to the selected aspect ratio
-	for (int p=0; p<6; p++)
-		if (!interImage[p].isNull()) {
-			if (m_viewAspectRatio == 3)
-				// Aspect ratio is Pixel 1:2 so we only need to double the vertical height
-				sceneImage[p] = interImage[p].scaled(interImage[p].width(), interImage[p].height()*2, Qt::IgnoreAspectRatio, Qt::FastTransformation);
-			else {
-				// Scale the image in two steps so that smoothing only occurs on vertical lines
-				// Double the vertical height first
-				const QImage doubleHeightImage = interImage[p].scaled(interImage[p].width(), interImage[p].height()*2, Qt::IgnoreAspectRatio, Qt::FastTransformation);
-				// then scale it horizontally to the selected aspect ratio
-				sceneImage[p] = doubleHeightImage.scaled((int)((float)doubleHeightImage.width() * aspectRatioHorizontalScaling[m_viewAspectRatio] * 2), doubleHeightImage.height(), Qt::IgnoreAspectRatio, (smooth) ? Qt::SmoothTransformation : Qt::FastTransformation);
-			}
-		}
+	return offscreenRender.image(options);
 }
 
 void MainWindow::exportImage()
@@ -284,78 +272,143 @@ void MainWindow::exportImage()
 		return;
 	}
 
-	QImage scaledImage[6];
-	// Really could simplify the suffix parameter here...
-	extractImages(scaledImage, suffix != "gif", suffix == "gif");
-
 	if (suffix == "png") {
-		if (scaledImage[0].save(exportFileName, "PNG"))
+		if (extractImage(true).save(exportFileName, "PNG"))
 			m_exportImageFileName = exportFileName;
 		else
 			QMessageBox::warning(this, QApplication::applicationDisplayName(), tr("Cannot export image %1.").arg(QDir::toNativeSeparators(exportFileName)));
 	}
 
 	if (suffix == "gif") {
-		QGifImage gif(scaledImage[0].size());
-
-		// Set a colourmap so we don't end up dithering into the default libgif palette
-		QList<QRgb> cTable;
-
-		if (m_textWidget->pageRender()->renderMode() == TeletextPageRender::RenderWhiteOnBlack)
-			gif.setGlobalColorTable(QList<QRgb>{ qRgb(0, 0, 0), qRgb(255, 255, 255) }, QColor(0, 0, 0));
-		else if (m_textWidget->pageRender()->renderMode() == TeletextPageRender::RenderBlackOnWhite)
-			gif.setGlobalColorTable(QList<QRgb>{ qRgb(255, 255, 255), qRgb(0, 0, 0) }, QColor(255, 255, 255));
-		else {
-			for (int i=0; i<32; i++)
-				if (i == 8) {
-					// Transparent colour mandatory for CLUT 1:0 on Level 2.5
-					// and optional on Level 1 for newsflash/subtitle or mix rendering
-					if (m_textWidget->pageDecode()->level() >= 2 ||
-					    m_textWidget->pageRender()->renderMode() == TeletextPageRender::RenderMix ||
-					    m_textWidget->document()->currentSubPage()->controlBit(PageBase::C5Newsflash) ||
-					    m_textWidget->document()->currentSubPage()->controlBit(PageBase::C6Subtitle));
-						cTable.append(qRgb(1, 1, 1));
-					if (m_textWidget->pageDecode()->level() < 2)
-						break;
-				} else
-					cTable.append(m_textWidget->document()->currentSubPage()->CLUTtoQColor(i).rgb());
-
-			gif.setGlobalColorTable(cTable, QColor(0, 0, 0));
-			// QColor(1, 1, 1) won't always be present. Here's hoping that setting transparent
-			// colour to one that isn't in the colour table doesn't have any side effects...
-			gif.setDefaultTransparentColor(QColor(1, 1, 1));
+		// Render straight into the page's CLUT so the GIF writer doesn't have to search for colours
+		TeletextOffscreenRender offscreenRender;
+		TeletextOffscreenRender::Options options;
+
+		prepareOffscreenRender(offscreenRender, options);
+
+		DeltaGifWriter gif(offscreenRender, options);
+
+		if (gif.open(exportFileName)) {
+			gif.addPageFrames(offscreenRender, options);
+			if (gif.close()) {
+				m_exportImageFileName = exportFileName;
+				return;
+			}
 		}
 
-		if (scaledImage[3].isNull())
-			// No flashing
-			gif.addFrame(scaledImage[0], 0);
-		else if (scaledImage[1].isNull()) {
-			// 1Hz flashing
-			gif.addFrame(scaledImage[0], 500);
-			gif.addFrame(scaledImage[3], 500);
-		} else
-			// 2Hz flashing
-			for (int p=0; p<6; p++)
-				gif.addFrame(scaledImage[p], (p % 3 == 0) ? 166 : 167);
+		QMessageBox::warning(this, QApplication::applicationDisplayName(), tr("Cannot export image %1:\n%2.").arg(QDir::toNativeSeparators(exportFileName), gif.errorString()));
+	}
+}
 
-		if (gif.save(exportFileName))
-			m_exportImageFileName = exportFileName;
-		else
-			QMessageBox::warning(this, QApplication::applicationDisplayName(), tr("Cannot export image %1.").arg(QDir::toNativeSeparators(exportFileName)));
+void MainWindow::exportCarouselImage()
+{
+	QString exportFileName;
+
+	if (!m_exportImageFileName.isEmpty())
+		exportFileName = m_exportImageFileName.left(m_exportImageFileName.lastIndexOf('.')) + ".gif";
+	else
+		exportFileName = m_curFile.left(m_curFile.lastIndexOf('.')) + ".gif";
+
+	exportFileName = QFileDialog::getSaveFileName(this, tr("Export carousel as animated GIF"), exportFileName, "Animated GIF image (*.gif)");
+	if (exportFileName.isEmpty())
+		return;
+
+	TeletextOffscreenRender offscreenRender;
+	TeletextOffscreenRender::Options options;
+
+	prepareOffscreenRender(offscreenRender, options);
+
+	// Frames are written as they are rendered, so the whole carousel is never held at once
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+
+	DeltaGifWriter gif(offscreenRender, options);
+	bool exported = false;
+
+	if (gif.open(exportFileName)) {
+		gif.addCarouselFrames(offscreenRender, options, *m_textWidget->document());
+		exported = gif.close();
 	}
+
+	QApplication::restoreOverrideCursor();
+
+	if (exported)
+		m_exportImageFileName = exportFileName;
+	else
+		QMessageBox::warning(this, QApplication::applicationDisplayName(), tr("Cannot export image %1:\n%2.").arg(QDir::toNativeSeparators(exportFileName), gif.errorString()));
 }
 
 #ifndef QT_NO_CLIPBOARD
 void MainWindow::imageToClipboard()
 {
-	QImage scaledImage[1];
 	QClipboard *clipboard = QApplication::clipboard();
 
-	extractImages(scaledImage, true);
-	clipboard->setImage(scaledImage[0]);
+	clipboard->setImage(extractImage(true));
 }
 #endif // !QT_NO_CLIPBOARD
 
+void MainWindow::importImage(bool fromClipboard)
+{
+	QImage image;
+
+#ifndef QT_NO_CLIPBOARD
+	if (fromClipboard) {
+		image = QApplication::clipboard()->image();
+		if (image.isNull()) {
+			QMessageBox::warning(this, QApplication::applicationDisplayName(), tr("There is no image on the clipboard."));
+			return;
+		}
+	} else
+#endif // !QT_NO_CLIPBOARD
+	{
+		QStringList patterns;
+
+		for (const QByteArray &format : QImageReader::supportedImageFormats())
+			patterns.append("*." + QString::fromLatin1(format));
+
+		const QString fileName = QFileDialog::getOpenFileName(this, tr("Import image"), QString(), tr("Images (%1)").arg(patterns.join(' ')));
+
+		if (fileName.isEmpty())
+			return;
+
+		QImageReader reader(fileName);
+
+		reader.setAutoTransform(true);
+		image = reader.read();
+		if (image.isNull()) {
+			QMessageBox::warning(this, QApplication::applicationDisplayName(), tr("Cannot import image %1:\n%2").arg(QDir::toNativeSeparators(fileName), reader.errorString()));
+			return;
+		}
+	}
+
+	TeletextDocument *document = m_textWidget->document();
+	int topRow, leftColumn, bottomRow, rightColumn;
+
+	// Into the selection, or from the cursor to the bottom right of the page if there isn't one
+	if (document->selectionActive()) {
+		topRow = document->selectionTopRow();
+		leftColumn = document->selectionLeftColumn();
+		bottomRow = document->selectionBottomRow();
+		rightColumn = document->selectionRightColumn();
+	} else {
+		topRow = document->cursorRow();
+		leftColumn = document->cursorColumn();
+		bottomRow = 24;
+		rightColumn = 39;
+	}
+
+	QByteArrayList pageRows;
+
+	for (int r=topRow; r<=bottomRow; r++)
+		pageRows.append(document->currentSubPage()->row(r));
+
+	ImportImageDialog dialog(image, pageRows, leftColumn, rightColumn - leftColumn + 1, m_textWidget->pageDecode()->level(), this);
+
+	if (dialog.exec() != QDialog::Accepted)
+		return;
+
+	document->undoStack()->push(new ImportImageCommand(document, topRow, leftColumn, dialog.characters()));
+}
+
 void MainWindow::exportZXNet()
 {
 	QDesktopServices::openUrl(QUrl("http://zxnet.co.uk/teletext/editor/" + exportHashStringPage(m_textWidget->document()->currentSubPage()) + exportHashStringPackets(m_textWidget->document()->currentSubPage())));
@@ -384,24 +437,22 @@ void MainWindow::init()
 	m_reExportWarning = false;
 
 	m_textWidget = new TeletextWidget;
+	StartupTiming::phase("Teletext widget");
 
-	m_pageOptionsDockWidget = new PageOptionsDockWidget(m_textWidget);
-	addDockWidget(Qt::RightDockWidgetArea, m_pageOptionsDockWidget);
-	m_pageEnhancementsDockWidget = new PageEnhancementsDockWidget(m_textWidget);
-	addDockWidget(Qt::RightDockWidgetArea, m_pageEnhancementsDockWidget);
-	m_x26DockWidget = new X26DockWidget(m_textWidget);
-	addDockWidget(Qt::RightDockWidgetArea, m_x26DockWidget);
-	m_paletteDockWidget = new PaletteDockWidget(m_textWidget);
-	addDockWidget(Qt::RightDockWidgetArea, m_paletteDockWidget);
-	m_pageComposeLinksDockWidget = new PageComposeLinksDockWidget(m_textWidget);
-	addDockWidget(Qt::RightDockWidgetArea, m_pageComposeLinksDockWidget);
-	m_dClutDockWidget = new DClutDockWidget(m_textWidget);
-	addDockWidget(Qt::RightDockWidgetArea, m_dClutDockWidget);
+	// Docks are built when they're first shown
+	m_pageOptionsDockWidget = nullptr;
+	m_pageEnhancementsDockWidget = nullptr;
+	m_x26DockWidget = nullptr;
+	m_paletteDockWidget = nullptr;
+	m_pageComposeLinksDockWidget = nullptr;
+	m_dClutDockWidget = nullptr;
+	m_serviceDockWidget = nullptr;
 
 	m_textScene = new LevelOneScene(m_textWidget, this);
 
 	createActions();
 	createStatusBar();
+	StartupTiming::phase("Actions and status bar");
 
 	QSettings settings(QCoreApplication::organizationName(), QCoreApplication::applicationName());
 	const int settingsSchema = settings.value("schema", 1).toInt();
@@ -410,6 +461,9 @@ void MainWindow::init()
 	// page view unusably small and forgetting the layout could be the only way out of it
 	const QByteArray geometry = settingsSchema >= 2 ? settings.value("geometry", QByteArray()).toByteArray() : QByteArray();
 	const QByteArray windowState = settingsSchema >= 2 ? settings.value("windowState", QByteArray()).toByteArray() : QByteArray();
+	// Docks that were open last time are built now so the window state can put them back.
+	// Settings from before docks were built lazily don't say which were open, so build them all
+	const QVariantList visibleDocks = settings.value("visibleDocks", QVariantList { PageOptionsDock, X26Dock, PageEnhancementsDock, PaletteDock, DClutDock, PageComposeLinksDock, ServiceDock }).toList();
 
 	m_viewBorder = settings.value("border", 1).toInt();
 	m_viewBorder = (m_viewBorder < 0 || m_viewBorder > 2) ? 1 : m_viewBorder;
@@ -423,6 +477,9 @@ void MainWindow::init()
 	m_smoothTransformAction->blockSignals(false);
 	int zoomSliderInit = settings.value("zoom", 2).toInt();
 	zoomSliderInit = (zoomSliderInit < 0 || zoomSliderInit > 8) ? 2 : zoomSliderInit;
+	// Undo history limit is stored in MiB
+	const int undoMemoryLimit = settings.value("undoMemoryLimit", UndoHistory::DefaultMemoryLimit / 1048576).toInt();
+	m_textWidget->document()->undoStack()->setMemoryLimit(undoMemoryLimit < 0 ? UndoHistory::DefaultMemoryLimit : qsizetype(undoMemoryLimit) * 1048576);
 
 	m_textView = new QGraphicsView(this);
 	m_textView->setScene(m_textScene);
@@ -447,26 +504,17 @@ void MainWindow::init()
 		move((availableGeometry.width() - width()) / 2, (availableGeometry.height() - height()) / 2);
 	} else
 		restoreGeometry(geometry);
-	if (windowState.isEmpty()) {
-		m_pageOptionsDockWidget->hide();
-		m_pageOptionsDockWidget->setFloating(true);
-		m_pageEnhancementsDockWidget->hide();
-		m_pageEnhancementsDockWidget->setFloating(true);
-		m_x26DockWidget->hide();
-		m_x26DockWidget->setFloating(true);
-		m_paletteDockWidget->hide();
-		m_paletteDockWidget->setFloating(true);
-		m_dClutDockWidget->hide();
-		m_dClutDockWidget->setFloating(true);
-		m_pageComposeLinksDockWidget->hide();
-		m_pageComposeLinksDockWidget->setFloating(true);
-	} else
+	if (!windowState.isEmpty()) {
+		for (const QVariant &dock : visibleDocks)
+			if (dock.toInt() >= 0 && dock.toInt() < DockCount)
+				ensureDockWidget(static_cast<DockType>(dock.toInt()));
 		restoreState(windowState);
+	}
+	StartupTiming::phase("Docks and window state");
 
 	connect(m_textWidget->document(), &TeletextDocument::cursorMoved, this, &MainWindow::updateCursorPosition);
 	connect(m_textWidget->document(), &TeletextDocument::selectionMoved, m_textScene, &LevelOneScene::updateSelection);
-	connect(m_textWidget->document()->undoStack(), &QUndoStack::cleanChanged, this, [=]() { setWindowModified(!m_textWidget->document()->undoStack()->isClean()); } );
-	connect(m_textWidget->document(), &TeletextDocument::aboutToChangeSubPage, m_x26DockWidget, &X26DockWidget::unloadX26List);
+	connect(m_textWidget->document()->undoStack(), &UndoHistory::cleanChanged, this, [=]() { setWindowModified(!m_textWidget->document()->undoStack()->isClean()); } );
 	connect(m_textWidget->document(), &TeletextDocument::subPageSelected, this, &MainWindow::updatePageWidgets);
 	connect(m_textWidget->document(), &TeletextDocument::pageOptionsChanged, this, &MainWindow::updatePageWidgets);
 	connect(m_textWidget, &TeletextWidget::sizeChanged, this, &MainWindow::setSceneDimensions);
@@ -478,6 +526,14 @@ void MainWindow::init()
 	connect(m_textScene, &LevelOneScene::mouseZoomOut, this, &MainWindow::zoomOut);
 
 	connect(&m_fileWatcher, &QFileSystemWatcher::fileChanged, this, &MainWindow::updateWatchedFile);
+	for (int i=0; i<2; i++) {
+		m_drcsReloadTimer[i].setSingleShot(true);
+		m_drcsReloadTimer[i].setInterval(300);
+		connect(&m_drcsReloadTimer[i], &QTimer::timeout, this, [=]() {
+			if (!m_drcsFileName[i].isEmpty())
+				loadDRCSFile(i, m_drcsFileName[i]);
+		});
+	}
 
 	QShortcut *blockShortCut = new QShortcut(QKeySequence(Qt::Key_Escape, Qt::Key_J), m_textView);
 	connect(blockShortCut, &QShortcut::activated, [=]() { m_textWidget->setCharacter(0x7f); });
@@ -487,6 +543,107 @@ void MainWindow::init()
 	updatePageWidgets();
 
 	m_textView->setFocus();
+	StartupTiming::phase("Window constructed");
+}
+
+QDockWidget *MainWindow::dockWidget(DockType dock) const
+{
+	switch (dock) {
+		case PageOptionsDock:
+			return m_pageOptionsDockWidget;
+		case X26Dock:
+			return m_x26DockWidget;
+		case PageEnhancementsDock:
+			return m_pageEnhancementsDockWidget;
+		case PaletteDock:
+			return m_paletteDockWidget;
+		case DClutDock:
+			return m_dClutDockWidget;
+		case PageComposeLinksDock:
+			return m_pageComposeLinksDockWidget;
+		case ServiceDock:
+			return m_serviceDockWidget;
+		default:
+			return nullptr;
+	}
+}
+
+QDockWidget *MainWindow::ensureDockWidget(DockType dock)
+{
+	QDockWidget *result = dockWidget(dock);
+
+	if (result)
+		return result;
+
+	Qt::DockWidgetArea area = Qt::RightDockWidgetArea;
+
+	switch (dock) {
+		case PageOptionsDock:
+			m_pageOptionsDockWidget = new PageOptionsDockWidget(m_textWidget);
+			m_pageOptionsDockWidget->updateWidgets();
+			result = m_pageOptionsDockWidget;
+			break;
+		case X26Dock:
+			m_x26DockWidget = new X26DockWidget(m_textWidget);
+			connect(m_textWidget->document(), &TeletextDocument::aboutToChangeSubPage, m_x26DockWidget, &X26DockWidget::unloadX26List);
+			m_x26DockWidget->loadX26List();
+			result = m_x26DockWidget;
+			break;
+		case PageEnhancementsDock:
+			m_pageEnhancementsDockWidget = new PageEnhancementsDockWidget(m_textWidget);
+			m_pageEnhancementsDockWidget->updateWidgets();
+			result = m_pageEnhancementsDockWidget;
+			break;
+		case PaletteDock:
+			m_paletteDockWidget = new PaletteDockWidget(m_textWidget);
+			m_paletteDockWidget->setLevel3p5Accepted(m_levelRadioButton[3]->isChecked());
+			m_paletteDockWidget->updateAllColourButtons();
+			result = m_paletteDockWidget;
+			break;
+		case DClutDock:
+			m_dClutDockWidget = new DClutDockWidget(m_textWidget);
+			m_dClutDockWidget->updateAllColourButtons();
+			result = m_dClutDockWidget;
+			break;
+		case PageComposeLinksDock:
+			m_pageComposeLinksDockWidget = new PageComposeLinksDockWidget(m_textWidget);
+			m_pageComposeLinksDockWidget->updateWidgets();
+			result = m_pageComposeLinksDockWidget;
+			break;
+		case ServiceDock:
+			m_serviceDockWidget = new ServiceDockWidget(this);
+			connect(m_serviceDockWidget, &ServiceDockWidget::openFileRequested, this, &MainWindow::openFile);
+			result = m_serviceDockWidget;
+			area = Qt::LeftDockWidgetArea;
+			break;
+		default:
+			return nullptr;
+	}
+
+	// Put it back where the restored window state had it, otherwise docks start off hidden
+	// and all but the service dock float
+	if (!restoreDockWidget(result)) {
+		addDockWidget(area, result);
+		result->hide();
+		if (dock != ServiceDock)
+			result->setFloating(true);
+	}
+
+	connect(result->toggleViewAction(), &QAction::toggled, m_dockViewActs[dock], &QAction::setChecked);
+	m_dockViewActs[dock]->setChecked(!result->isHidden());
+
+	return result;
+}
+
+void MainWindow::toggleDockWidget(DockType dock, bool visible)
+{
+	if (visible) {
+		QDockWidget *shownDock = ensureDockWidget(dock);
+
+		shownDock->show();
+		shownDock->raise();
+	} else if (dockWidget(dock))
+		dockWidget(dock)->hide();
 }
 
 void MainWindow::tile(const QMainWindow *previous)
@@ -538,6 +695,10 @@ void MainWindow::createActions()
 	const QIcon clearRecentIcon = QIcon::fromTheme("edit-clear-history");
 	recentMenu->addAction(clearRecentIcon, tr("Clear list"), this, &MainWindow::clearRecentFiles);
 
+	QAction *openServiceAct = fileMenu->addAction(tr("Open service directory..."));
+	openServiceAct->setStatusTip(tr("Load a directory of page files making up a service, listing them by page number"));
+	connect(openServiceAct, &QAction::triggered, this, &MainWindow::openServiceDirectory);
+
 	const QIcon saveIcon = QIcon::fromTheme("document-save", QIcon(":/images/save.png"));
 	QAction *saveAct = new QAction(saveIcon, tr("&Save"), this);
 	saveAct->setShortcuts(QKeySequence::Save);
@@ -583,6 +744,10 @@ void MainWindow::createActions()
 	exportImageAct->setStatusTip("Export an image of this subpage");
 	connect(exportImageAct, &QAction::triggered, this, &MainWindow::exportImage);
 
+	QAction *exportCarouselImageAct = fileMenu->addAction(tr("Export carousel as animated GIF..."));
+	exportCarouselImageAct->setStatusTip("Export an animation of all the subpages, each shown for its cycle time");
+	connect(exportCarouselImageAct, &QAction::triggered, this, &MainWindow::exportCarouselImage);
+
 	QAction *exportM29Act = fileMenu->addAction(tr("Export subpage X/28 as M/29..."));
 	exportM29Act->setStatusTip("Export this subpage's X/28 packets as a tti file with M/29 packets");
 	connect(exportM29Act, &QAction::triggered, this, &MainWindow::exportM29);
@@ -655,9 +820,17 @@ void MainWindow::createActions()
 	copyImageAct->setStatusTip(tr("Copy this subpage as an image to the clipboard"));
 	connect(copyImageAct, &QAction::triggered, this, &MainWindow::imageToClipboard);
 
-	editMenu->addSeparator();
+	QAction *pasteImageAct = editMenu->addAction(tr("Paste image as mosaics..."));
+	pasteImageAct->setStatusTip(tr("Convert the clipboard's image into mosaics in the current selection"));
+	connect(pasteImageAct, &QAction::triggered, [=]() { importImage(true); } );
 #endif // !QT_NO_CLIPBOARD
 
+	QAction *importImageAct = editMenu->addAction(tr("Import image as mosaics..."));
+	importImageAct->setStatusTip(tr("Convert an image file into mosaics in the current selection"));
+	connect(importImageAct, &QAction::triggered, [=]() { importImage(false); } );
+
+	editMenu->addSeparator();
+
 	QAction *insertBlankRowAct = editMenu->addAction(tr("Insert blank row"));
 	insertBlankRowAct->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_I));
 	insertBlankRowAct->setStatusTip(tr("Insert a blank row at the cursor position"));
@@ -698,6 +871,10 @@ void MainWindow::createActions()
 	m_rowZeroAct->setStatusTip(tr("Allow editing of header row"));
 	connect(m_rowZeroAct, &QAction::toggled, m_textScene, &LevelOneScene::toggleRowZeroAllowed);
 
+	QAction *undoLimitAct = editMenu->addAction(tr("Undo history limit..."));
+	undoLimitAct->setStatusTip(tr("Set how much memory the undo history can use"));
+	connect(undoLimitAct, &QAction::triggered, this, &MainWindow::setUndoMemoryLimit);
+
 	QMenu *viewMenu = menuBar()->addMenu(tr("&View"));
 
 	QAction *revealAct = viewMenu->addAction(tr("&Reveal"));
@@ -937,12 +1114,14 @@ void MainWindow::createActions()
 
 	QMenu *toolsMenu = menuBar()->addMenu(tr("&Tools"));
 
-	toolsMenu->addAction(m_pageOptionsDockWidget->toggleViewAction());
-	toolsMenu->addAction(m_x26DockWidget->toggleViewAction());
-	toolsMenu->addAction(m_pageEnhancementsDockWidget->toggleViewAction());
-	toolsMenu->addAction(m_paletteDockWidget->toggleViewAction());
-	toolsMenu->addAction(m_dClutDockWidget->toggleViewAction());
-	toolsMenu->addAction(m_pageComposeLinksDockWidget->toggleViewAction());
+	// Stand in for the docks' own toggle view actions, as the docks aren't built until first shown
+	const QString dockTitles[DockCount] = { tr("Page options"), tr("X/26 triplets"), tr("X/28 page enhancements"), tr("Palette"), tr("Level 3.5 DCLUTs"), tr("Compositional links"), tr("Service") };
+
+	for (int i=0; i<DockCount; i++) {
+		m_dockViewActs[i] = toolsMenu->addAction(dockTitles[i]);
+		m_dockViewActs[i]->setCheckable(true);
+		connect(m_dockViewActs[i], &QAction::triggered, [=](bool checked) { toggleDockWidget(static_cast<DockType>(i), checked); });
+	}
 
 	//FIXME is this main menubar separator to put help menu towards the right?
 	menuBar()->addSeparator();
@@ -1093,20 +1272,18 @@ void MainWindow::loadDRCSFile(int drcsType, QString fileName)
 			return;
 		}
 
-		QList<PageBase> loadedPages;
+		const QSharedPointer<const DRCSPageSet> loadedPageSet = DRCSRegistry::load(&file, loadingFormat);
 
-		if (loadingFormat->load(&file, loadedPages, nullptr)) {
+		if (loadedPageSet) {
 			if (!m_drcsFileName[drcsType].isEmpty())
 				m_fileWatcher.removePath(m_drcsFileName[drcsType]);
 
-			m_textWidget->pageDecode()->clearDRCSPage((TeletextPageDecode::DRCSPageType)drcsType);
-			m_drcsPage[drcsType].clear();
-
-			for (int i=0; i<loadedPages.size(); i++)
-				m_drcsPage[drcsType].append(loadedPages.at(i));
-
-			m_textWidget->pageDecode()->setDRCSPage((TeletextPageDecode::DRCSPageType)drcsType, &m_drcsPage[drcsType]);
-			m_textWidget->refreshPage();
+			// Set the new pages before letting go of the old ones, which may be freed here.
+			// Only the characters that look different are redrawn, none at all if the file
+			// was saved with the same contents.
+			m_textWidget->pageDecode()->setDRCSPage((TeletextPageDecode::DRCSPageType)drcsType, loadedPageSet.data());
+			m_drcsPage[drcsType] = loadedPageSet;
+			m_textWidget->update();
 
 			m_fileWatcher.addPath(fileName);
 			m_drcsFileName[drcsType] = fileName;
@@ -1127,11 +1304,12 @@ void MainWindow::loadDRCSFile(int drcsType, QString fileName)
 void MainWindow::clearDRCSFile(int drcsType)
 {
 	m_fileWatcher.removePath(m_drcsFileName[drcsType]);
+	m_drcsReloadTimer[drcsType].stop();
 
 	m_textWidget->pageDecode()->clearDRCSPage((TeletextPageDecode::DRCSPageType)drcsType);
-	m_drcsPage[drcsType].clear();
+	m_drcsPage[drcsType].reset();
 
-	m_textWidget->refreshPage();
+	m_textWidget->update();
 
 	m_drcsFileName[drcsType].clear();
 	m_drcsSection[drcsType]->setText(drcsType == 1 ? "Global DRCS" : "Normal DRCS");
@@ -1144,21 +1322,29 @@ void MainWindow::swapDRCS()
 	m_drcsPage[0].swap(m_drcsPage[1]);
 	m_drcsFileName[0].swap(m_drcsFileName[1]);
 
+	// A reload waiting to happen follows its file
+	const bool reloadPending[2] = { m_drcsReloadTimer[0].isActive(), m_drcsReloadTimer[1].isActive() };
+
 	for (int i=0; i<2; i++) {
 		const QString drcsTypeName = i == 1 ? "Global DRCS" : "Normal DRCS";
 
-		if (m_drcsPage[i].isEmpty()) {
+		if (m_drcsPage[i].isNull()) {
 			m_textWidget->pageDecode()->clearDRCSPage((TeletextPageDecode::DRCSPageType)i);
 			m_drcsSection[i]->setText(drcsTypeName);
 		} else {
-			m_textWidget->pageDecode()->setDRCSPage((TeletextPageDecode::DRCSPageType)i, &m_drcsPage[i]);
+			m_textWidget->pageDecode()->setDRCSPage((TeletextPageDecode::DRCSPageType)i, m_drcsPage[i].data());
 			m_drcsSection[i]->setText(QString("%1: %2").arg(drcsTypeName).arg(QFileInfo(m_drcsFileName[i]).fileName()));
 		}
 
-		m_drcsClear[i]->setEnabled(!m_drcsPage[i].isEmpty());
+		m_drcsClear[i]->setEnabled(!m_drcsPage[i].isNull());
+
+		if (reloadPending[1-i])
+			m_drcsReloadTimer[i].start();
+		else
+			m_drcsReloadTimer[i].stop();
 	}
 
-	m_textWidget->refreshPage();
+	m_textWidget->update();
 }
 
 void MainWindow::updateWatchedFile(const QString &path)
@@ -1172,7 +1358,7 @@ void MainWindow::updateWatchedFile(const QString &path)
 	else
 		return;
 
-	loadDRCSFile(drcsType, path);
+	m_drcsReloadTimer[drcsType].start();
 }
 
 void MainWindow::toggleInsertMode()
@@ -1219,6 +1405,12 @@ void MainWindow::createStatusBar()
 	statusBar()->insertWidget(4, m_zoomSlider);
 	connect(m_zoomSlider, &QSlider::valueChanged, this, &MainWindow::zoomSet);
 
+	m_undoMemoryLabel = new QLabel;
+	m_undoMemoryLabel->setToolTip(tr("Memory used by the undo history"));
+	statusBar()->addPermanentWidget(m_undoMemoryLabel);
+	connect(m_textWidget->document()->undoStack(), &UndoHistory::memoryUsageChanged, this, &MainWindow::updateUndoMemoryUsage);
+	updateUndoMemoryUsage();
+
 	m_insertModePushButton = new QPushButton("OVERWRITE");
 	m_insertModePushButton->setFlat(true);
 	m_insertModePushButton->setMinimumHeight(m_subPageLabel->height());
@@ -1238,10 +1430,10 @@ void MainWindow::createStatusBar()
 		statusBar()->addPermanentWidget(m_levelRadioButton[i]);
 	}
 	m_levelRadioButton[0]->toggle();
-	connect(m_levelRadioButton[0], &QAbstractButton::clicked, [=]() { m_textWidget->pageDecode()->setLevel(0); m_textWidget->update(); m_paletteDockWidget->setLevel3p5Accepted(false); });
-	connect(m_levelRadioButton[1], &QAbstractButton::clicked, [=]() { m_textWidget->pageDecode()->setLevel(1); m_textWidget->update(); m_paletteDockWidget->setLevel3p5Accepted(false);});
-	connect(m_levelRadioButton[2], &QAbstractButton::clicked, [=]() { m_textWidget->pageDecode()->setLevel(2); m_textWidget->update(); m_paletteDockWidget->setLevel3p5Accepted(false);});
-	connect(m_levelRadioButton[3], &QAbstractButton::clicked, [=]() { m_textWidget->pageDecode()->setLevel(3); m_textWidget->update(); m_paletteDockWidget->setLevel3p5Accepted(true);});
+	connect(m_levelRadioButton[0], &QAbstractButton::clicked, [=]() { m_textWidget->pageDecode()->setLevel(0); m_textWidget->update(); if (m_paletteDockWidget) m_paletteDockWidget->setLevel3p5Accepted(false); });
+	connect(m_levelRadioButton[1], &QAbstractButton::clicked, [=]() { m_textWidget->pageDecode()->setLevel(1); m_textWidget->update(); if (m_paletteDockWidget) m_paletteDockWidget->setLevel3p5Accepted(false);});
+	connect(m_levelRadioButton[2], &QAbstractButton::clicked, [=]() { m_textWidget->pageDecode()->setLevel(2); m_textWidget->update(); if (m_paletteDockWidget) m_paletteDockWidget->setLevel3p5Accepted(false);});
+	connect(m_levelRadioButton[3], &QAbstractButton::clicked, [=]() { m_textWidget->pageDecode()->setLevel(3); m_textWidget->update(); if (m_paletteDockWidget) m_paletteDockWidget->setLevel3p5Accepted(true); });
 }
 
 void MainWindow::writeSettings()
@@ -1250,10 +1442,34 @@ void MainWindow::writeSettings()
 	settings.setValue("schema", 2);
 	settings.setValue("geometry", saveGeometry());
 	settings.setValue("windowState", saveState());
+
+	QVariantList visibleDocks;
+
+	for (int i=0; i<DockCount; i++)
+		if (dockWidget(static_cast<DockType>(i)) && !dockWidget(static_cast<DockType>(i))->isHidden())
+			visibleDocks.append(i);
+	settings.setValue("visibleDocks", visibleDocks);
 	settings.setValue("border", m_viewBorder);
 	settings.setValue("aspectratio", m_viewAspectRatio);
 	settings.setValue("smoothTransform", m_viewSmoothTransform);
 	settings.setValue("zoom", m_zoomSlider->value());
+	settings.setValue("undoMemoryLimit", m_textWidget->document()->undoStack()->memoryLimit() / 1048576);
+}
+
+void MainWindow::updateUndoMemoryUsage()
+{
+	m_undoMemoryLabel->setText(tr("Undo %1").arg(locale().formattedDataSize(m_textWidget->document()->undoStack()->memoryUsage())));
+}
+
+void MainWindow::setUndoMemoryLimit()
+{
+	UndoHistory *undoHistory = m_textWidget->document()->undoStack();
+	bool ok;
+
+	const int newLimit = QInputDialog::getInt(this, tr("Undo history limit"), tr("Memory the undo history can use in MiB,\nor 0 for no limit. The oldest edits are forgotten first."), undoHistory->memoryLimit() / 1048576, 0, 65536, 1, &ok);
+
+	if (ok)
+		undoHistory->setMemoryLimit(qsizetype(newLimit) * 1048576);
 }
 
 bool MainWindow::maybeSave()
@@ -1317,7 +1533,7 @@ void MainWindow::loadFile(const QString &fileName)
 	levelSeen = m_textWidget->document()->levelRequired();
 	m_levelRadioButton[levelSeen]->toggle();
 	m_textWidget->pageDecode()->setLevel(levelSeen);
-	if (levelSeen == 3)
+	if (levelSeen == 3 && m_paletteDockWidget)
 		m_paletteDockWidget->setLevel3p5Accepted(true);
 	updatePageWidgets();
 
@@ -1654,10 +1870,16 @@ void MainWindow::updatePageWidgets()
 	m_nextSubPageButton->setEnabled(!(m_textWidget->document()->currentSubPageIndex() == (m_textWidget->document()->numberOfSubPages()) - 1));
 	updateCursorPosition();
 	m_deleteSubPageAction->setEnabled(m_textWidget->document()->numberOfSubPages() > 1);
-	m_pageOptionsDockWidget->updateWidgets();
-	m_pageEnhancementsDockWidget->updateWidgets();
-	m_x26DockWidget->loadX26List();
-	m_paletteDockWidget->updateAllColourButtons();
-	m_pageComposeLinksDockWidget->updateWidgets();
-	m_dClutDockWidget->updateAllColourButtons();
+	if (m_pageOptionsDockWidget)
+		m_pageOptionsDockWidget->updateWidgets();
+	if (m_pageEnhancementsDockWidget)
+		m_pageEnhancementsDockWidget->updateWidgets();
+	if (m_x26DockWidget)
+		m_x26DockWidget->loadX26List();
+	if (m_paletteDockWidget)
+		m_paletteDockWidget->updateAllColourButtons();
+	if (m_pageComposeLinksDockWidget)
+		m_pageComposeLinksDockWidget->updateWidgets();
+	if (m_dClutDockWidget)
+		m_dClutDockWidget->updateAllColourButtons();
 }
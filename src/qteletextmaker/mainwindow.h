@@ -30,18 +30,22 @@
 #include <QList>
 #include <QMainWindow>
 #include <QPushButton>
+#include <QSharedPointer>
 #include <QSlider>
+#include <QTimer>
 #include <QToolButton>
 
 #include "dclutdockwidget.h"
 #include "drcspage.h"
 #include "loadformats.h"
 #include "mainwidget.h"
+#include "offscreenrender.h"
 #include "pagecomposelinksdockwidget.h"
 #include "pageenhancementsdockwidget.h"
 #include "pageoptionsdockwidget.h"
 #include "palettedockwidget.h"
 #include "saveformats.h"
+#include "servicedockwidget.h"
 #include "x26dockwidget.h"
 
 class QAction;
@@ -64,6 +68,7 @@ protected:
 private slots:
 	void newFile();
 	void open();
+	void openServiceDirectory();
 	bool save();
 	bool saveAs();
 	void reload();
@@ -72,6 +77,7 @@ private slots:
 	void exportZXNet();
 	void exportEditTF();
 	void exportImage();
+	void exportCarouselImage();
 	void exportM29();
 	void updateRecentFileActions();
 	void clearRecentFiles();
@@ -80,10 +86,13 @@ private slots:
 	void about();
 	void updatePageWidgets();
 	void updateCursorPosition();
+	void updateUndoMemoryUsage();
+	void setUndoMemoryLimit();
 
 #ifndef QT_NO_CLIPBOARD
 	void imageToClipboard();
 #endif // !QT_NO_CLIPBOARD
+	void importImage(bool fromClipboard);
 	void insertRow(bool copyRow);
 	void deleteRow();
 	void insertSubPage(bool afterCurrentSubPage, bool copyCurrentSubPage);
@@ -108,16 +117,22 @@ private slots:
 
 private:
 	enum { m_MaxRecentFiles = 10 };
+	// In the order they appear in the Tools menu
+	enum DockType { PageOptionsDock, X26Dock, PageEnhancementsDock, PaletteDock, DClutDock, PageComposeLinksDock, ServiceDock, DockCount };
 	const float aspectRatioHorizontalScaling[4] = { 0.6, 0.6, 0.8, 0.5 };
 
 	void init();
+	QDockWidget *dockWidget(DockType dock) const;
+	QDockWidget *ensureDockWidget(DockType dock);
+	void toggleDockWidget(DockType dock, bool visible);
 	void createActions();
 	void createStatusBar();
 	void writeSettings();
 	bool maybeSave();
 	void openFile(const QString &fileName);
 	void loadFile(const QString &fileName);
-	void extractImages(QImage sceneImage[], bool smooth = false, bool flashExtract = false);
+	void prepareOffscreenRender(TeletextOffscreenRender &offscreenRender, TeletextOffscreenRender::Options &options) const;
+	QImage extractImage(bool smooth = false);
 	void prependToRecentFiles(const QString &fileName);
 	bool saveFile(const QString &fileName);
 	void setCurrentFile(const QString &fileName);
@@ -128,9 +143,12 @@ private:
 	LevelOneScene *m_textScene;
 	QGraphicsView *m_textView;
 
-	QList<DRCSPage> m_drcsPage[2];
+	// Shared through DRCSRegistry with other windows that have the same DRCS file loaded
+	QSharedPointer<const DRCSPageSet> m_drcsPage[2];
 	QString m_drcsFileName[2];
 	QFileSystemWatcher m_fileWatcher;
+	// Saving a file can give a burst of change notifications, so reloading waits for them to stop
+	QTimer m_drcsReloadTimer[2];
 
 	int m_viewBorder, m_viewAspectRatio, m_viewZoom;
 	bool m_viewSmoothTransform;
@@ -140,6 +158,7 @@ private:
 	PaletteDockWidget *m_paletteDockWidget;
 	PageComposeLinksDockWidget *m_pageComposeLinksDockWidget;
 	DClutDockWidget *m_dClutDockWidget;
+	ServiceDockWidget *m_serviceDockWidget;
 
 	QAction *m_recentFileActs[m_MaxRecentFiles];
 	QAction *m_recentFileSubMenuAct;
@@ -150,8 +169,9 @@ private:
 	QAction *m_aspectRatioActs[4];
 	QAction *m_smoothTransformAction;
 	QAction *m_drcsSection[2], *m_drcsClear[2], *m_drcsSwap;
+	QAction *m_dockViewActs[DockCount];
 
-	QLabel *m_subPageLabel, *m_cursorPositionLabel;
+	QLabel *m_subPageLabel, *m_cursorPositionLabel, *m_undoMemoryLabel;
 	QToolButton *m_previousSubPageButton, *m_nextSubPageButton;
 	QSlider *m_zoomSlider;
 	QPushButton *m_insertModePushButton;
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtAlgorithms>
+#include <QByteArrayList>
+
+#include "mosaicbitplane.h"
+
+// Sixels of a mosaic character from the top left, row by row
+static constexpr unsigned char s_leftSixels[3] = { 0x01, 0x04, 0x10 };
+static constexpr unsigned char s_rightSixels[3] = { 0x02, 0x08, 0x40 };
+
+MosaicBitplane::MosaicBitplane()
+{
+	for (int r=0; r<Rows; r++)
+		m_cells[r] = 0;
+	for (int y=0; y<SixelRows; y++)
+		m_left[y] = m_right[y] = 0;
+}
+
+bool MosaicBitplane::isEmpty() const
+{
+	for (int r=0; r<Rows; r++)
+		if (m_cells[r])
+			return false;
+
+	return true;
+}
+
+void MosaicBitplane::readCharacters(const QByteArrayList &characters, int topRow, int leftColumn)
+{
+	for (int lr=0; lr<characters.size(); lr++) {
+		const int r = topRow + lr;
+
+		if (r >= Rows)
+			break;
+
+		const QByteArray &rowCharacters = characters.at(lr);
+
+		for (int k=0; k<3; k++)
+			m_left[r*3+k] = m_right[r*3+k] = 0;
+
+		for (int lc=0; lc<rowCharacters.size() && leftColumn+lc<Columns; lc++) {
+			const int c = leftColumn + lc;
+
+			if (!contains(r, c))
+				continue;
+
+			const unsigned char ch = rowCharacters.at(lc);
+
+			for (int k=0; k<3; k++) {
+				if (ch & s_leftSixels[k])
+					m_left[r*3+k] |= Q_UINT64_C(1) << c;
+				if (ch & s_rightSixels[k])
+					m_right[r*3+k] |= Q_UINT64_C(1) << c;
+			}
+		}
+	}
+}
+
+void MosaicBitplane::writeCharacters(QByteArrayList &characters, int topRow, int leftColumn) const
+{
+	for (int lr=0; lr<characters.size(); lr++) {
+		const int r = topRow + lr;
+
+		if (r >= Rows)
+			break;
+		if (!m_cells[r])
+			continue;
+
+		QByteArray &rowCharacters = characters[lr];
+
+		for (int lc=0; lc<rowCharacters.size() && leftColumn+lc<Columns; lc++) {
+			const int c = leftColumn + lc;
+
+			if (!contains(r, c))
+				continue;
+
+			unsigned char ch = 0x20;
+
+			for (int k=0; k<3; k++) {
+				if ((m_left[r*3+k] >> c) & 1)
+					ch |= s_leftSixels[k];
+				if ((m_right[r*3+k] >> c) & 1)
+					ch |= s_rightSixels[k];
+			}
+			rowCharacters[lc] = ch;
+		}
+	}
+}
+
+// Bit of the next marked cell to the right for each marked cell, or 0 at the last marked cell
+quint64 MosaicBitplane::nextCellBits(quint64 bits, quint64 cells)
+{
+	// Where the next cell along is marked it's a plain shift
+	quint64 result = (bits >> 1) & cells & (cells >> 1);
+	// The ends of each run of marked cells jump over the unmarked cells to the next run
+	quint64 runEnds = cells & ~(cells >> 1);
+
+	while (runEnds) {
+		const int c = qCountTrailingZeroBits(runEnds);
+		const quint64 beyond = cells & ~((Q_UINT64_C(2) << c) - 1);
+
+		if (beyond && ((bits >> qCountTrailingZeroBits(beyond)) & 1))
+			result |= Q_UINT64_C(1) << c;
+		runEnds &= runEnds - 1;
+	}
+
+	return result;
+}
+
+// Bit of the previous marked cell to the left for each marked cell, or 0 at the first marked cell
+quint64 MosaicBitplane::previousCellBits(quint64 bits, quint64 cells)
+{
+	quint64 result = (bits << 1) & cells & (cells << 1);
+	quint64 runStarts = cells & ~(cells << 1);
+
+	while (runStarts) {
+		const int c = qCountTrailingZeroBits(runStarts);
+		const quint64 before = cells & ((Q_UINT64_C(1) << c) - 1);
+
+		if (before && ((bits >> (63 - qCountLeadingZeroBits(before))) & 1))
+			result |= Q_UINT64_C(1) << c;
+		runStarts &= runStarts - 1;
+	}
+
+	return result;
+}
+
+void MosaicBitplane::shiftUp()
+{
+	// Top sixels of the nearest marked cell below, for each column
+	quint64 carryLeft = 0, carryRight = 0;
+
+	for (int r=Rows-1; r>=0; r--) {
+		const quint64 cells = m_cells[r];
+
+		if (!cells)
+			continue;
+
+		const quint64 topLeft = m_left[r*3];
+		const quint64 topRight = m_right[r*3];
+
+		m_left[r*3] = m_left[r*3+1];
+		m_right[r*3] = m_right[r*3+1];
+		m_left[r*3+1] = m_left[r*3+2];
+		m_right[r*3+1] = m_right[r*3+2];
+		m_left[r*3+2] = carryLeft & cells;
+		m_right[r*3+2] = carryRight & cells;
+
+		carryLeft = (carryLeft & ~cells) | topLeft;
+		carryRight = (carryRight & ~cells) | topRight;
+	}
+}
+
+void MosaicBitplane::shiftDown()
+{
+	// Bottom sixels of the nearest marked cell above, for each column
+	quint64 carryLeft = 0, carryRight = 0;
+
+	for (int r=0; r<Rows; r++) {
+		const quint64 cells = m_cells[r];
+
+		if (!cells)
+			continue;
+
+		const quint64 bottomLeft = m_left[r*3+2];
+		const quint64 bottomRight = m_right[r*3+2];
+
+		m_left[r*3+2] = m_left[r*3+1];
+		m_right[r*3+2] = m_right[r*3+1];
+		m_left[r*3+1] = m_left[r*3];
+		m_right[r*3+1] = m_right[r*3];
+		m_left[r*3] = carryLeft & cells;
+		m_right[r*3] = carryRight & cells;
+
+		carryLeft = (carryLeft & ~cells) | bottomLeft;
+		carryRight = (carryRight & ~cells) | bottomRight;
+	}
+}
+
+void MosaicBitplane::shiftLeft()
+{
+	for (int y=0; y<SixelRows; y++) {
+		const quint64 cells = m_cells[y / 3];
+
+		if (!cells)
+			continue;
+
+		const quint64 left = m_left[y];
+
+		m_left[y] = m_right[y];
+		m_right[y] = nextCellBits(left, cells);
+	}
+}
+
+void MosaicBitplane::shiftRight()
+{
+	for (int y=0; y<SixelRows; y++) {
+		const quint64 cells = m_cells[y / 3];
+
+		if (!cells)
+			continue;
+
+		const quint64 right = m_right[y];
+
+		m_right[y] = m_left[y];
+		m_left[y] = previousCellBits(right, cells);
+	}
+}
+
+void MosaicBitplane::fill()
+{
+	for (int y=0; y<SixelRows; y++)
+		m_left[y] = m_right[y] = m_cells[y / 3];
+}
+
+void MosaicBitplane::clear()
+{
+	for (int y=0; y<SixelRows; y++)
+		m_left[y] = m_right[y] = 0;
+}
+
+void MosaicBitplane::invert()
+{
+	for (int y=0; y<SixelRows; y++) {
+		m_left[y] ^= m_cells[y / 3];
+		m_right[y] ^= m_cells[y / 3];
+	}
+}
+
+// Checkerboard of sixels with the top left sixel of the page set
+void MosaicBitplane::dither()
+{
+	for (int y=0; y<SixelRows; y++) {
+		m_left[y] = (y & 1) ? 0 : m_cells[y / 3];
+		m_right[y] = (y & 1) ? m_cells[y / 3] : 0;
+	}
+}
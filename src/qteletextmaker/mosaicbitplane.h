@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MOSAICBITPLANE_H
+#define MOSAICBITPLANE_H
+
+#include <QByteArrayList>
+#include <QtGlobal>
+
+// Mosaic characters of a page held as 80x75 sixels, each sixel row split into two words of the
+// left and right sixels of the 40 character cells, along with a word per row marking which cells
+// are mosaics. Shifting, filling and so on are done a whole row of sixels at a time, and only
+// affect the marked cells.
+// Shifting skips over cells that aren't marked, so sixels carry on past a colour change.
+class MosaicBitplane
+{
+public:
+	static constexpr int Rows = 25;
+	static constexpr int Columns = 40;
+	static constexpr int SixelRows = Rows * 3;
+
+	MosaicBitplane();
+
+	void addCell(int row, int column) { m_cells[row] |= Q_UINT64_C(1) << column; }
+	bool contains(int row, int column) const { return (m_cells[row] >> column) & 1; }
+	bool isEmpty() const;
+	// Sixel x from 0 to 79 and y from 0 to 74, only kept if its cell is marked
+	void setSixel(int x, int y) { (x & 1 ? m_right : m_left)[y] |= m_cells[y / 3] & (Q_UINT64_C(1) << (x >> 1)); }
+
+	// Block of characters with its top left corner at the given row and column.
+	// Only the marked cells are read from or written to.
+	void readCharacters(const QByteArrayList &characters, int topRow, int leftColumn);
+	void writeCharacters(QByteArrayList &characters, int topRow, int leftColumn) const;
+
+	void shiftUp();
+	void shiftDown();
+	void shiftLeft();
+	void shiftRight();
+	void fill();
+	void clear();
+	void invert();
+	void dither();
+
+private:
+	static quint64 nextCellBits(quint64 bits, quint64 cells);
+	static quint64 previousCellBits(quint64 bits, quint64 cells);
+
+	// Bit c of each word is character column c
+	quint64 m_cells[Rows];
+	quint64 m_left[SixelRows], m_right[SixelRows];
+};
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+
+#include "outputbuffer.h"
+
+OutputBuffer::OutputBuffer(int capacity)
+{
+	m_device = nullptr;
+	m_capacity = capacity;
+	m_size = 0;
+}
+
+void OutputBuffer::setDevice(QIODevice *device)
+{
+	m_device = device;
+	m_size = 0;
+	m_error.clear();
+
+	// Formats that never write to a device don't need the block at all
+	if (m_device != nullptr && m_data.size() < m_capacity)
+		m_data.resize(m_capacity);
+}
+
+void OutputBuffer::appendNumber(int value, int base, int width)
+{
+	char digits[16];
+	int count = 0;
+	unsigned int remaining = value < 0 ? -static_cast<unsigned int>(value) : value;
+
+	do {
+		digits[count++] = "0123456789abcdef"[remaining % base];
+		remaining /= base;
+	} while (remaining != 0 && count < 16);
+
+	while (count < width && count < 16)
+		digits[count++] = '0';
+
+	char *out = reserve(count + 1);
+	int length = 0;
+
+	if (value < 0)
+		out[length++] = '-';
+	while (count > 0)
+		out[length++] = digits[--count];
+
+	commit(length);
+}
+
+bool OutputBuffer::flush()
+{
+	if (m_size != 0) {
+		writeToDevice(m_data.constData(), m_size);
+		m_size = 0;
+	}
+
+	return !hasError();
+}
+
+// Flushes the block to make room, only growing it for a single reservation larger than the whole block
+void OutputBuffer::makeRoom(int len)
+{
+	flush();
+
+	if (len > m_data.size())
+		m_data.resize(len);
+}
+
+void OutputBuffer::writeToDevice(const char *s, int len)
+{
+	// After the first failure the rest of the output is dropped, as the file is useless anyway
+	if (m_device == nullptr || hasError())
+		return;
+
+	if (m_device->write(s, len) != len)
+		m_error = m_device->errorString();
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+
+#include <cstring>
+
+// Gathers output into one large contiguous block which is written to the device in one go
+// when it fills up or is flushed.
+// Formats can reserve space at the end of the block and build a packet there in place
+// rather than building it up in a temporary first.
+class OutputBuffer
+{
+public:
+	static constexpr int DefaultCapacity = 256 * 1024;
+
+	explicit OutputBuffer(int capacity = DefaultCapacity);
+
+	// Anything not yet flushed to the previous device is thrown away
+	void setDevice(QIODevice *device);
+	QIODevice *device() const { return m_device; };
+
+	// Pointer to room for at least len bytes, which are kept once commit() is called
+	char *reserve(int len)
+	{
+		if (m_size + len > m_data.size())
+			makeRoom(len);
+		return m_data.data() + m_size;
+	}
+	void commit(int len) { m_size += len; };
+
+	void append(const char *s, int len)
+	{
+		if (len > m_data.size()) {
+			flush();
+			writeToDevice(s, len);
+			return;
+		}
+		std::memcpy(reserve(len), s, len);
+		m_size += len;
+	}
+	void append(const char *s) { append(s, static_cast<int>(std::strlen(s))); };
+	void append(char c) { *reserve(1) = c; m_size++; };
+	// Digits in lower case, padded with zeroes to at least width digits
+	void appendNumber(int value, int base=10, int width=0);
+
+	// Writes out everything held so far, false if the device couldn't take it all
+	bool flush();
+	bool hasError() const { return !m_error.isEmpty(); };
+	QString errorString() const { return m_error; };
+
+private:
+	void makeRoom(int len);
+	void writeToDevice(const char *s, int len);
+
+	QIODevice *m_device;
+	QByteArray m_data;
+	int m_capacity, m_size;
+	QString m_error;
+};
+
+#endif
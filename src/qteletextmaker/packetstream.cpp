@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QTime>
+
+#include <cstring>
+
+#include "packetstream.h"
+
+#include "document.h"
+#include "hamming.h"
+#include "levelonepage.h"
+#include "saveformats.h"
+
+// Collects the packets the t42 format would write for a subpage, instead of writing them to a file
+class T42PacketEncoder : public SaveT42Format
+{
+public:
+	QList<QByteArray> subPagePackets(const TeletextDocument &document, int subPageIndex)
+	{
+		m_document = &document;
+		m_packets.clear();
+		writeSubPage(*document.subPage(subPageIndex), (document.numberOfSubPages() == 1) ? 0 : subPageIndex+1);
+
+		return m_packets;
+	}
+
+protected:
+	int writeRawData(const char *s, int len) override
+	{
+		m_packets.append(QByteArray(s, len));
+		return len;
+	}
+
+private:
+	QList<QByteArray> m_packets;
+};
+
+T42PacketStream::T42PacketStream()
+{
+	m_magazineMode = ParallelMagazines;
+	m_linesPerField = 16;
+	m_headerClock = true;
+	m_clockStart = QTime::currentTime();
+
+	for (streamMagazine &magazine : m_magazines) {
+		magazine.currentPage = 0;
+		magazine.queuePosition = 0;
+		magazine.waitUntilField = 0;
+		magazine.packetsSent = 0;
+	}
+
+	m_nextMagazine = 0;
+	m_serialMagazine = -1;
+	m_fieldCount = 0;
+	m_fillerLines = 0;
+}
+
+void T42PacketStream::addDocument(const TeletextDocument &document)
+{
+	T42PacketEncoder encoder;
+	streamPage page;
+
+	page.pageNumber = document.pageNumber();
+	page.currentSubPage = 0;
+	page.subPageStartField = -1;
+	page.transmissions = 0;
+
+	for (int p=0; p<document.numberOfSubPages(); p++) {
+		const LevelOnePage *subPage = document.subPage(p);
+
+		page.subPages.append({ encoder.subPagePackets(document, p), qMax(subPage->cycleValue(), 1), subPage->cycleType() == LevelOnePage::CTseconds });
+	}
+
+	// Magazine 8 is sent as 0
+	m_magazines[(document.pageNumber() >> 8) & 0x7].pages.append(page);
+}
+
+int T42PacketStream::pageCount() const
+{
+	int result = 0;
+
+	for (const streamMagazine &magazine : m_magazines)
+		result += magazine.pages.size();
+
+	return result;
+}
+
+QByteArray T42PacketStream::nextField()
+{
+	QByteArray result(m_linesPerField * PacketSize, 0);
+
+	for (int l=0; l<m_linesPerField; l++) {
+		const QByteArray packet = nextPacket();
+
+		if (packet.isEmpty())
+			m_fillerLines++;
+		else
+			std::memcpy(result.data() + l * PacketSize, packet.constData(), PacketSize);
+	}
+
+	m_fieldCount++;
+
+	return result;
+}
+
+QByteArray T42PacketStream::nextPacket()
+{
+	if (m_magazineMode == SerialMagazines) {
+		// One page at a time, the next header of any magazine ends the page before
+		if (m_serialMagazine == -1 || pageSent(m_serialMagazine)) {
+			int m;
+
+			for (m=1; m<=8; m++)
+				if (!m_magazines[(m_serialMagazine + m + 8) % 8].pages.isEmpty())
+					break;
+			if (m > 8)
+				return QByteArray();
+
+			m_serialMagazine = (m_serialMagazine + m + 8) % 8;
+		}
+
+		return takePacket(m_serialMagazine);
+	}
+
+	// Parallel magazines take turns a packet at a time
+	for (int i=0; i<8; i++) {
+		const int m = (m_nextMagazine + i) % 8;
+
+		if (m_magazines[m].pages.isEmpty())
+			continue;
+
+		const QByteArray packet = takePacket(m);
+
+		if (!packet.isEmpty()) {
+			m_nextMagazine = (m + 1) % 8;
+			return packet;
+		}
+	}
+
+	return QByteArray();
+}
+
+QByteArray T42PacketStream::takePacket(int magazineNumber)
+{
+	streamMagazine &magazine = m_magazines[magazineNumber];
+
+	if (magazine.waitUntilField > m_fieldCount)
+		return QByteArray();
+
+	if (pageSent(magazineNumber))
+		queueNextPage(magazineNumber);
+
+	if (magazine.queuePosition == 0)
+		magazine.waitUntilField = m_fieldCount + 1;
+
+	magazine.packetsSent++;
+
+	return magazine.queue.at(magazine.queuePosition++);
+}
+
+bool T42PacketStream::pageSent(int magazineNumber) const
+{
+	return m_magazines[magazineNumber].queuePosition >= m_magazines[magazineNumber].queue.size();
+}
+
+void T42PacketStream::queueNextPage(int magazineNumber)
+{
+	streamMagazine &magazine = m_magazines[magazineNumber];
+	streamPage &page = magazine.pages[magazine.currentPage];
+
+	if (page.subPageStartField == -1)
+		page.subPageStartField = m_fieldCount;
+	else if (page.subPages.size() > 1) {
+		// Cycle times are either in seconds or in the number of times the page has been sent
+		const streamSubPage &subPage = page.subPages.at(page.currentSubPage);
+		const bool cycleEnded = subPage.cycleSeconds ? m_fieldCount - page.subPageStartField >= qint64(subPage.cycleValue) * FieldsPerSecond : page.transmissions >= subPage.cycleValue;
+
+		if (cycleEnded) {
+			page.currentSubPage = (page.currentSubPage + 1) % page.subPages.size();
+			page.subPageStartField = m_fieldCount;
+			page.transmissions = 0;
+		}
+	}
+
+	magazine.queue = page.subPages.at(page.currentSubPage).packets;
+	magazine.queue[0] = headerPacket(magazine.queue.at(0));
+	magazine.queuePosition = 0;
+
+	page.transmissions++;
+	magazine.currentPage = (magazine.currentPage + 1) % magazine.pages.size();
+}
+
+QByteArray T42PacketStream::headerPacket(const QByteArray &header) const
+{
+	QByteArray result = header;
+
+	// C11 in the header has to agree with how the magazines are actually sent
+	const unsigned char controlBits = hamming84Decode(result.at(9)) & 0x0e;
+
+	result[9] = hamming84Encode(controlBits | (m_magazineMode == SerialMagazines ? 1 : 0));
+
+	if (m_headerClock) {
+		const QTime clockTime = m_clockStart.addMSecs(static_cast<int>(m_fieldCount * 1000 / FieldsPerSecond % 86400000));
+		const QByteArray clock = clockTime.toString("hh:mm:ss").toLatin1();
+
+		for (int c=0; c<8; c++)
+			result[PacketSize-8+c] = oddParity(clock.at(c));
+	}
+
+	return result;
+}
+
+QString T42PacketStream::utilisationReport() const
+{
+	const qint64 totalLines = m_fieldCount * m_linesPerField;
+	auto percentOfLines = [totalLines](qint64 lines) { return QString::number(totalLines == 0 ? 0.0 : lines * 100.0 / totalLines, 'f', 1); };
+
+	QString result = QString("%1 fields, %2 seconds at %3 lines per field, %4 mode\n").arg(m_fieldCount).arg(m_fieldCount / FieldsPerSecond).arg(m_linesPerField).arg(m_magazineMode == SerialMagazines ? "serial" : "parallel");
+
+	for (int m=1; m<=8; m++) {
+		const streamMagazine &magazine = m_magazines[m & 0x7];
+
+		if (magazine.pages.isEmpty())
+			continue;
+
+		result.append(QString("Magazine %1: %2 pages, %3 packets, %4% of lines\n").arg(m).arg(magazine.pages.size()).arg(magazine.packetsSent).arg(percentOfLines(magazine.packetsSent)));
+	}
+
+	result.append(QString("Unused: %1 lines, %2% of lines\n").arg(m_fillerLines).arg(percentOfLines(m_fillerLines)));
+
+	return result;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKETSTREAM_H
+#define PACKETSTREAM_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QTime>
+
+#include "document.h"
+
+// Schedules the pages of many documents into a continuous t42 packet stream, as a teletext
+// inserter would, a field at a time within a budget of VBI lines per field.
+// Each magazine cycles through its pages and each page through its subpages by their cycle times.
+// Subpages are encoded once when added, only the header clock is written in as they are sent.
+class T42PacketStream
+{
+public:
+	enum MagazineMode { ParallelMagazines, SerialMagazines };
+
+	static constexpr int FieldsPerSecond = 50;
+	static constexpr int PacketSize = 42;
+
+	T42PacketStream();
+
+	void addDocument(const TeletextDocument &document);
+	int pageCount() const;
+
+	void setMagazineMode(MagazineMode magazineMode) { m_magazineMode = magazineMode; };
+	void setLinesPerField(int linesPerField) { m_linesPerField = linesPerField; };
+	int linesPerField() const { return m_linesPerField; };
+	// Puts the time into the last eight characters of each header row
+	void setHeaderClock(bool headerClock) { m_headerClock = headerClock; };
+	void setClockStart(const QTime &clockStart) { m_clockStart = clockStart; };
+
+	// The next field's worth of packets, lines with nothing to send are all zeroes
+	QByteArray nextField();
+	qint64 fieldCount() const { return m_fieldCount; };
+	QString utilisationReport() const;
+
+private:
+	struct streamSubPage {
+		QList<QByteArray> packets;
+		int cycleValue;
+		bool cycleSeconds;
+	};
+
+	struct streamPage {
+		int pageNumber;
+		QList<streamSubPage> subPages;
+		int currentSubPage;
+		qint64 subPageStartField;
+		int transmissions;
+	};
+
+	struct streamMagazine {
+		QList<streamPage> pages;
+		int currentPage;
+		// Packets of the page being sent
+		QList<QByteArray> queue;
+		int queuePosition;
+		// Rows are held back until the field after the header so decoders have time to erase the page
+		qint64 waitUntilField;
+		qint64 packetsSent;
+	};
+
+	QByteArray nextPacket();
+	QByteArray takePacket(int magazineNumber);
+	bool pageSent(int magazineNumber) const;
+	void queueNextPage(int magazineNumber);
+	QByteArray headerPacket(const QByteArray &header) const;
+
+	streamMagazine m_magazines[8];
+	MagazineMode m_magazineMode;
+	int m_linesPerField;
+	bool m_headerClock;
+	QTime m_clockStart;
+
+	int m_nextMagazine;
+	int m_serialMagazine;
+	qint64 m_fieldCount;
+	qint64 m_fillerLines;
+};
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROJECTFORMAT_H
+#define PROJECTFORMAT_H
+
+// Layout of the binary project format, shared by LoadProjectFormat and SaveProjectFormat.
+// All values are little endian.
+//
+// Header
+//   0  8 bytes  magic "QTMPROJ" followed by 0x1a
+//   8  uint16   format version
+//  10  uint16   header size, description follows this many bytes from the start of the file
+//  12  uint16   page number
+//  14  uint16   subpage record size, records may grow in later versions
+//  16  uint32   description length in bytes of UTF-8
+//  20  12 bytes reserved, written as zeroes
+//
+// Each subpage follows the description in turn up to the end of the file, as a record
+//   0  uint16   control bits C4 to C14 in bits 0 to 10
+//   2  uint8    region, 0xff if not a Level One Page
+//   3  uint8    cycle value
+//   4  uint8    cycle type 'C' or 'T', 0 if not a Level One Page
+//   5  uint8    reserved
+//   6  uint16   subpage number as saved
+//   8  uint32   X/0 to X/25 present, one bit per packet number
+//  12  uint16   X/26/0 to X/26/15 present, one bit per designation code
+//  14  uint16   X/27/0 to X/27/15 present
+//  16  uint16   X/28/0 to X/28/15 present
+//  18  uint16   reserved
+//  20  uint32   number of packets, which must match the bits set above
+// followed by each present packet as 40 bytes exactly as PageBase holds it, in the order
+// X/0 to X/25 then X/26, X/27 and X/28 each by designation code.
+
+namespace ProjectFormat {
+
+inline constexpr char Magic[8] = { 'Q', 'T', 'M', 'P', 'R', 'O', 'J', 0x1a };
+inline constexpr int Version = 1;
+inline constexpr int HeaderSize = 32;
+inline constexpr int SubPageRecordSize = 24;
+inline constexpr int PacketSize = 40;
+
+}
+
+#endif
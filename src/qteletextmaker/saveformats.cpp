@@ -20,39 +20,53 @@
 #include "saveformats.h"
 
 #include <QByteArray>
-#include <QDataStream>
 #include <QSaveFile>
 #include <QString>
+#include <QtEndian>
+
+#include <cstring>
 
 #include "document.h"
 #include "hamming.h"
 #include "levelonepage.h"
+#include "outputbuffer.h"
 #include "pagebase.h"
+#include "projectformat.h"
 
 void SaveFormat::saveAllPages(QSaveFile &outFile, const TeletextDocument &document)
 {
 	m_document = &document;
 	m_outFile = &outFile;
-	m_outStream.setDevice(m_outFile);
+	m_outBuffer.setDevice(m_outFile);
 	m_warnings.clear();
 	m_error.clear();
 
 	writeDocumentStart();
 	writeAllPages();
 	writeDocumentEnd();
+	finishOutput();
 }
 
 void SaveFormat::saveCurrentSubPage(QSaveFile &outFile, const TeletextDocument &document)
 {
 	m_document = &document;
 	m_outFile = &outFile;
-	m_outStream.setDevice(m_outFile);
+	m_outBuffer.setDevice(m_outFile);
 	m_warnings.clear();
 	m_error.clear();
 
 	writeDocumentStart();
 	writeSubPage(*m_document->currentSubPage());
 	writeDocumentEnd();
+	finishOutput();
+}
+
+void SaveFormat::finishOutput()
+{
+	if (!m_outBuffer.flush() && m_error.isEmpty())
+		m_error = QString("Cannot write file: %1").arg(m_outBuffer.errorString());
+
+	m_outBuffer.setDevice(nullptr);
 }
 
 void SaveFormat::writeAllPages()
@@ -121,15 +135,29 @@ int SaveFormat::writePacket(QByteArray packet, int packetNumber, int designation
 
 int SaveFormat::writeRawData(const char *s, int len)
 {
-	return m_outStream.writeRawData(s, len);
+	m_outBuffer.append(s, len);
+
+	return len;
 }
 
 
 inline void SaveTTIFormat::writeString(const QString &command)
 {
-	QByteArray result = command.toUtf8() + "\r\n";
+	const QByteArray result = command.toUtf8();
+
+	m_outBuffer.append(result.constData(), result.size());
+	endCommand();
+}
+
+inline void SaveTTIFormat::startCommand(const char *command)
+{
+	m_outBuffer.append(command, 2);
+	m_outBuffer.append(',');
+}
 
-	writeRawData(result, result.size());
+inline void SaveTTIFormat::endCommand()
+{
+	m_outBuffer.append("\r\n", 2);
 }
 
 void SaveTTIFormat::writeDocumentStart()
@@ -142,15 +170,27 @@ void SaveTTIFormat::writeDocumentStart()
 
 QByteArray SaveTTIFormat::format7BitPacket(QByteArray packet)
 {
+	int controlCodes = 0;
+
+	for (int i=0; i<packet.size(); i++)
+		if (packet.at(i) < 0x20)
+			controlCodes++;
+
+	if (controlCodes == 0)
+		return packet;
+
+	// TTI files are plain text, so put in escape followed by control code with bit 6 set
+	QByteArray result(packet.size() + controlCodes, Qt::Uninitialized);
+	char *out = result.data();
+
 	for (int i=0; i<packet.size(); i++)
 		if (packet.at(i) < 0x20) {
-			// TTI files are plain text, so put in escape followed by control code with bit 6 set
-			packet[i] = packet.at(i) | 0x40;
-			packet.insert(i, 0x1b);
-			i++;
-		}
+			*out++ = 0x1b;
+			*out++ = packet.at(i) | 0x40;
+		} else
+			*out++ = packet.at(i);
 
-	return packet;
+	return result;
 }
 
 // format4BitPacket in this class calls this method as the encoding is the same
@@ -184,12 +224,18 @@ QByteArray SaveTTIFormat::format18BitPacket(QByteArray packet)
 void SaveTTIFormat::writeSubPageStart(const PageBase &subPage, int subPageNumber)
 {
 	// Page number
-	writeString(QString("PN,%1%2").arg(m_document->pageNumber(), 3, 16, QChar('0')).arg(subPageNumber & 0xff, 2, 10, QChar('0')));
+	startCommand("PN");
+	m_outBuffer.appendNumber(m_document->pageNumber(), 16, 3);
+	m_outBuffer.appendNumber(subPageNumber & 0xff, 10, 2);
+	endCommand();
 
 	// Subpage
 	// Magazine Organisation Table and Magazine Inventory Page don't have subpages
-	if (subPage.pageFunction() != PageBase::PFMOT && subPage.pageFunction() != PageBase::PFMIP)
-		writeString(QString("SC,%1").arg(subPageNumber, 4, 10, QChar('0')));
+	if (subPage.pageFunction() != PageBase::PFMOT && subPage.pageFunction() != PageBase::PFMIP) {
+		startCommand("SC");
+		m_outBuffer.appendNumber(subPageNumber, 10, 4);
+		endCommand();
+	}
 
 	// Status bits
 	// We assume that bit 15 "transmit page" is always wanted
@@ -203,16 +249,29 @@ void SaveTTIFormat::writeSubPageStart(const PageBase &subPage, int subPageNumber
 	statusBits |= subPage.controlBit(PageBase::C13NOS) << 8;
 	statusBits |= subPage.controlBit(PageBase::C14NOS) << 7;
 
-	writeString(QString("PS,%1").arg(0x8000 | statusBits, 4, 16, QChar('0')));
+	startCommand("PS");
+	m_outBuffer.appendNumber(0x8000 | statusBits, 16, 4);
+	endCommand();
 
 	if (subPage.pageFunction() == PageBase::PFLevelOnePage) {
 		// Level One Page: page region and cycle
-		writeString(QString("RE,%1").arg(static_cast<const LevelOnePage *>(&subPage)->defaultCharSet()));
-		writeString(QString("CT,%1,%2").arg(static_cast<const LevelOnePage *>(&subPage)->cycleValue()).arg(static_cast<const LevelOnePage *>(&subPage)->cycleType()==LevelOnePage::CTcycles ? 'C' : 'T'));
-	} else
+		startCommand("RE");
+		m_outBuffer.appendNumber(static_cast<const LevelOnePage *>(&subPage)->defaultCharSet());
+		endCommand();
+		startCommand("CT");
+		m_outBuffer.appendNumber(static_cast<const LevelOnePage *>(&subPage)->cycleValue());
+		m_outBuffer.append(',');
+		m_outBuffer.append(static_cast<const LevelOnePage *>(&subPage)->cycleType()==LevelOnePage::CTcycles ? 'C' : 'T');
+		endCommand();
+	} else {
 		// Not a Level One Page: X/28/0 specifies page function and coding but the PF command
 		// should make it obvious to a human that this is not a Level One Page
-		writeString(QString("PF,%1,%2").arg(subPage.pageFunction()).arg(subPage.packetCoding()));
+		startCommand("PF");
+		m_outBuffer.appendNumber(subPage.pageFunction());
+		m_outBuffer.append(',');
+		m_outBuffer.appendNumber(subPage.packetCoding());
+		endCommand();
+	}
 }
 
 void SaveTTIFormat::writeSubPageBody(const PageBase &subPage)
@@ -256,9 +315,7 @@ void SaveTTIFormat::writeSubPageBody(const PageBase &subPage)
 	}
 
 	if (writeFLCommand) {
-		QString flofLine;
-		flofLine.reserve(26);
-		flofLine="FL,";
+		startCommand("FL");
 
 		for (int i=0; i<6; i++) {
 			// Stored as page link with relative magazine number, convert to absolute page number for display
@@ -267,24 +324,30 @@ void SaveTTIFormat::writeSubPageBody(const PageBase &subPage)
 			if ((absoluteLinkPageNumber & 0x700) == 0x000)
 				absoluteLinkPageNumber |= 0x800;
 
-			flofLine.append(QString("%1").arg(absoluteLinkPageNumber, 3, 16, QChar('0')));
+			m_outBuffer.appendNumber(absoluteLinkPageNumber, 16, 3);
 			if (i < 5)
-				flofLine.append(',');
+				m_outBuffer.append(',');
 		}
 
-		writeString(flofLine);
+		endCommand();
 	}
 }
 
 int SaveTTIFormat::writePacket(QByteArray packet, int packetNumber, int designationCode)
 {
-	if (designationCode != -1)
-		packet[0] = designationCode | 0x40;
+	startCommand("OL");
+	m_outBuffer.appendNumber(packetNumber);
+	m_outBuffer.append(',');
+
+	if (designationCode != -1 && !packet.isEmpty()) {
+		m_outBuffer.append(static_cast<char>(designationCode | 0x40));
+		m_outBuffer.append(packet.constData() + 1, packet.size() - 1);
+	} else
+		m_outBuffer.append(packet.constData(), packet.size());
 
-	packet.prepend("OL," + QByteArray::number(packetNumber) + ",");
-	packet.append("\r\n");
+	endCommand();
 
-	return(writeRawData(packet, packet.size()));
+	return packet.size();
 }
 
 
@@ -293,9 +356,14 @@ void SaveM29Format::writeSubPageStart(const PageBase &subPage, int subPageNumber
 	Q_UNUSED(subPageNumber);
 
 	// Force page number to 0xFF and subpage to 0
-	writeString(QString("PN,%1ff00").arg(m_document->pageNumber() >> 8, 1, 16));
+	startCommand("PN");
+	m_outBuffer.appendNumber(m_document->pageNumber() >> 8, 16);
+	m_outBuffer.append("ff00");
+	endCommand();
 	// Not sure if this PS forcing is necessary
-	writeString("PS,8000");
+	startCommand("PS");
+	m_outBuffer.append("8000");
+	endCommand();
 }
 
 void SaveM29Format::writeSubPageBody(const PageBase &subPage)
@@ -309,79 +377,136 @@ void SaveM29Format::writeSubPageBody(const PageBase &subPage)
 }
 
 
-QByteArray SaveT42Format::format7BitPacket(QByteArray packet)
+void SaveProjectFormat::writeDocumentStart()
 {
-	// Odd parity encoding
-	for (int c=0; c<packet.size(); c++) {
-		char p = packet.at(c);
-
-		// Recursively divide integer into two equal halves and take their XOR until only 1 bit is left
-		p ^= p >> 4;
-		p ^= p >> 2;
-		p ^= p >> 1;
-		// If last bit left is 0 then it started with an even number of bits, so do the odd parity
-		if (!(p & 1))
-			packet[c] = packet.at(c) | 0x80;
-	}
+	const QByteArray description = m_document->description().toUtf8();
+	uchar *header = reinterpret_cast<uchar *>(m_outBuffer.reserve(ProjectFormat::HeaderSize));
 
-	return packet;
+	std::memset(header, 0, ProjectFormat::HeaderSize);
+	std::memcpy(header, ProjectFormat::Magic, sizeof(ProjectFormat::Magic));
+	qToLittleEndian<quint16>(ProjectFormat::Version, header + 8);
+	qToLittleEndian<quint16>(ProjectFormat::HeaderSize, header + 10);
+	qToLittleEndian<quint16>(m_document->pageNumber(), header + 12);
+	qToLittleEndian<quint16>(ProjectFormat::SubPageRecordSize, header + 14);
+	qToLittleEndian<quint32>(description.size(), header + 16);
+	m_outBuffer.commit(ProjectFormat::HeaderSize);
+
+	m_outBuffer.append(description.constData(), description.size());
 }
 
-QByteArray SaveT42Format::format4BitPacket(QByteArray packet)
+void SaveProjectFormat::writeSubPageStart(const PageBase &subPage, int subPageNumber)
 {
-	for (int c=0; c<packet.size(); c++)
-		packet[c] = hamming_8_4_encode[(int)packet.at(c)];
+	int controlBits = 0;
+	quint32 displayPackets = 0;
+	int designationPackets[3] = { 0, 0, 0 };
+	int packetCount = 0;
 
-	return packet;
+	for (int i=PageBase::C4ErasePage; i<=PageBase::C14NOS; i++)
+		controlBits |= subPage.controlBit(i) << i;
+
+	for (int y=0; y<26; y++)
+		if (subPage.packetExists(y)) {
+			displayPackets |= 1 << y;
+			packetCount++;
+		}
+
+	for (int y=26; y<29; y++)
+		for (int d=0; d<16; d++)
+			if (subPage.packetExists(y, d)) {
+				designationPackets[y-26] |= 1 << d;
+				packetCount++;
+			}
+
+	uchar *record = reinterpret_cast<uchar *>(m_outBuffer.reserve(ProjectFormat::SubPageRecordSize));
+
+	std::memset(record, 0, ProjectFormat::SubPageRecordSize);
+	qToLittleEndian<quint16>(controlBits, record);
+	if (subPage.pageFunction() == PageBase::PFLevelOnePage) {
+		record[2] = static_cast<const LevelOnePage *>(&subPage)->defaultCharSet();
+		record[3] = static_cast<const LevelOnePage *>(&subPage)->cycleValue();
+		record[4] = static_cast<const LevelOnePage *>(&subPage)->cycleType() == LevelOnePage::CTcycles ? 'C' : 'T';
+	} else
+		record[2] = 0xff;
+	qToLittleEndian<quint16>(subPageNumber, record + 6);
+	qToLittleEndian<quint32>(displayPackets, record + 8);
+	for (int i=0; i<3; i++)
+		qToLittleEndian<quint16>(designationPackets[i], record + 12 + i*2);
+	qToLittleEndian<quint32>(packetCount, record + 20);
+	m_outBuffer.commit(ProjectFormat::SubPageRecordSize);
 }
 
-QByteArray SaveT42Format::format18BitPacket(QByteArray packet)
+// Packets go in the same order as the presence bits were set in writeSubPageStart
+void SaveProjectFormat::writeSubPageBody(const PageBase &subPage)
 {
-	for (int c=1; c<packet.size(); c+=3)
-		// For invalid packets, save as all zeroes which will fail Hamming 24/18 decoding
-		if ((packet.at(c) & 0xff) == 0xff)
-			packet[c] = packet[c+1] = packet[c+2] = 0;
-		else {
-			unsigned int D5_D11;
-			unsigned int D12_D18;
-			unsigned int P5, P6;
-			unsigned int Byte_0;
+	for (int y=0; y<26; y++)
+		if (subPage.packetExists(y))
+			writePacket(subPage.packet(y), y);
 
-			const unsigned int toEncode = packet[c] | (packet[c+1] << 6) | (packet[c+2] << 12);
+	for (int y=26; y<29; y++)
+		for (int d=0; d<16; d++)
+			if (subPage.packetExists(y, d))
+				writePacket(subPage.packet(y, d), y, d);
+}
 
-			Byte_0 = (hamming_24_18_forward[0][(toEncode >> 0) & 0xff] ^ hamming_24_18_forward[1][(toEncode >> 8) & 0xff] ^ hamming_24_18_forward_2[(toEncode >> 16) & 0x03]);
-			packet[c] = Byte_0;
+int SaveProjectFormat::writePacket(QByteArray packet, int packetNumber, int designationCode)
+{
+	Q_UNUSED(packetNumber);
+	Q_UNUSED(designationCode);
 
-			D5_D11 = (toEncode >> 4) & 0x7f;
-			D12_D18 = (toEncode >> 11) & 0x7f;
+	char *slot = m_outBuffer.reserve(ProjectFormat::PacketSize);
+	const int size = qMin(static_cast<int>(packet.size()), ProjectFormat::PacketSize);
 
-			P5 = 0x80 & ~(hamming_24_18_parities[0][D12_D18] << 2);
-			packet[c+1] = D5_D11 | P5;
+	std::memcpy(slot, packet.constData(), size);
+	std::memset(slot + size, 0, ProjectFormat::PacketSize - size);
+	m_outBuffer.commit(ProjectFormat::PacketSize);
 
-			P6 = 0x80 & ((hamming_24_18_parities[0][Byte_0] ^ hamming_24_18_parities[0][D5_D11]) << 2);
-			packet[c+2] = D12_D18 | P6;
-		}
+	return ProjectFormat::PacketSize;
+}
+
+
+QByteArray SaveT42Format::format7BitPacket(QByteArray packet)
+{
+	encodeOddParity(reinterpret_cast<unsigned char *>(packet.data()), packet.size());
+
+	return packet;
+}
+
+QByteArray SaveT42Format::format4BitPacket(QByteArray packet)
+{
+	encodeHamming84(reinterpret_cast<unsigned char *>(packet.data()), packet.size());
+
+	return packet;
+}
+
+QByteArray SaveT42Format::format18BitPacket(QByteArray packet)
+{
+	// The first byte is left for the designation code
+	// Invalid triplets are saved as all zeroes which will fail Hamming 24/18 decoding
+	encodeHamming2418(reinterpret_cast<unsigned char *>(packet.data()) + 1, (packet.size() - 1) / 3);
 
 	return packet;
 }
 
 int SaveT42Format::writePacket(QByteArray packet, int packetNumber, int designationCode)
 {
-	// Byte 2 - designation code
-	if (designationCode != - 1)
-		packet[0] = hamming_8_4_encode[designationCode];
+	// Put together on the stack instead of prepending the MRAG to the packet
+	char t42Packet[42];
 
-	// Byte 1 of MRAG
-	packet.prepend(hamming_8_4_encode[packetNumber >> 1]);
 	// Byte 0 of MRAG
-	packet.prepend(hamming_8_4_encode[m_magazineNumber | ((packetNumber & 0x01) << 3)]);
+	t42Packet[0] = hamming84Encode(m_magazineNumber | ((packetNumber & 0x01) << 3));
+	// Byte 1 of MRAG
+	t42Packet[1] = hamming84Encode(packetNumber >> 1);
+	std::memcpy(t42Packet + 2, packet.constData(), qMin(packet.size(), 40));
+	// Byte 2 - designation code
+	if (designationCode != - 1)
+		t42Packet[2] = hamming84Encode(designationCode);
 
-	return(writeRawData(packet, packet.size()));
+	return(writeRawData(t42Packet, 2 + qMin(packet.size(), 40)));
 }
 
 void SaveT42Format::writeSubPageStart(const PageBase &subPage, int subPageNumber)
 {
-	QByteArray packet;
+	char packet[42];
 
 	// Convert integer to Binary Coded Decimal
 	subPageNumber = QString::number(subPageNumber).toInt(nullptr, 16);
@@ -393,14 +518,14 @@ void SaveT42Format::writeSubPageStart(const PageBase &subPage, int subPageNumber
 	// Retrieve and apply odd parity to header row if there's text there,
 	// otherwise create an initial packet of (odd parity valid) spaces
 	if (subPage.packetExists(0))
-		packet = format7BitPacket(subPage.packet(0));
+		std::memcpy(packet + 2, format7BitPacket(subPage.packet(0)).constData(), 40);
 	else
-		packet.fill(0x20, 40);
+		std::memset(packet + 2, 0x20, 40);
 
-	// Byte 1 of MRAG - packet number 0
-	packet.prepend((char)0);
 	// Byte 0 of MRAG - magazine number, and packet number 0
-	packet.prepend(m_magazineNumber & 0x07);
+	packet[0] = m_magazineNumber & 0x07;
+	// Byte 1 of MRAG - packet number 0
+	packet[1] = 0;
 
 	packet[2] = m_document->pageNumber() & 0x00f;
 	packet[3] = (m_document->pageNumber() & 0x0f0) >> 4;
@@ -411,16 +536,16 @@ void SaveT42Format::writeSubPageStart(const PageBase &subPage, int subPageNumber
 	packet[8] = subPage.controlBit(PageBase::C7SuppressHeader) | (subPage.controlBit(PageBase::C8Update) << 1) | (subPage.controlBit(PageBase::C9InterruptedSequence) << 2) | (subPage.controlBit(PageBase::C10InhibitDisplay) << 3);
 	packet[9] = subPage.controlBit(PageBase::C11SerialMagazine) | (subPage.controlBit(PageBase::C14NOS) << 1) | (subPage.controlBit(PageBase::C13NOS) << 2) | (subPage.controlBit(PageBase::C12NOS) << 3);
 
-	for (int i=0; i<10; i++)
-		packet[i] = hamming_8_4_encode[(int)packet.at(i)];
+	encodeHamming84(reinterpret_cast<unsigned char *>(packet), 10);
 
-	writeRawData(packet.constData(), 42);
+	writeRawData(packet, 42);
 }
 
 
 int SaveHTTFormat::writeRawData(const char *s, int len)
 {
-	char httLine[45];
+	// Bit reversed straight into the output buffer
+	char *httLine = m_outBuffer.reserve(45);
 
 	httLine[0] = 0xaa;
 	httLine[1] = 0xaa;
@@ -434,7 +559,9 @@ int SaveHTTFormat::writeRawData(const char *s, int len)
 		httLine[i+3] = b;
 	}
 
-	return m_outStream.writeRawData(httLine, len+3);
+	m_outBuffer.commit(len+3);
+
+	return len+3;
 }
 
 
@@ -563,9 +690,10 @@ SaveFormats::SaveFormats()
 {
 	if (s_instances == 0) {
 		s_fileFormat[0] = new SaveTTIFormat;
-		s_fileFormat[1] = new SaveT42Format;
-		s_fileFormat[2] = new SaveEP1Format;
-		s_fileFormat[3] = new SaveHTTFormat;
+		s_fileFormat[1] = new SaveProjectFormat;
+		s_fileFormat[2] = new SaveT42Format;
+		s_fileFormat[3] = new SaveEP1Format;
+		s_fileFormat[4] = new SaveHTTFormat;
 
 		for (int i=0; i<s_size; i++) {
 			if (i != 0)
@@ -593,13 +721,10 @@ SaveFormats::~SaveFormats()
 
 SaveFormat *SaveFormats::findFormat(const QString &suffix) const
 {
-	// TTI is the only official save format at the moment...
-//	for (int i=0; i<s_nativeSize; i++)
-//		if (s_fileFormat[i]->extensions().contains(suffix, Qt::CaseInsensitive))
-//			return s_fileFormat[i];
-
-	if (s_fileFormat[0]->extensions().contains(suffix, Qt::CaseInsensitive))
-		return s_fileFormat[0];
+	// TTI and the binary project are the formats that hold everything in a document
+	for (int i=0; i<s_nativeSize; i++)
+		if (s_fileFormat[i]->extensions().contains(suffix, Qt::CaseInsensitive))
+			return s_fileFormat[i];
 
 	return nullptr;
 }
@@ -612,3 +737,10 @@ SaveFormat *SaveFormats::findExportFormat(const QString &suffix) const
 
 	return nullptr;
 }
+
+SaveFormat *SaveFormats::createExportFormat(const QString &suffix) const
+{
+	const SaveFormat *format = findExportFormat(suffix);
+
+	return (format != nullptr) ? format->create() : nullptr;
+}
@@ -21,12 +21,12 @@
 #define SAVEFORMATS_H
 
 #include <QByteArray>
-#include <QDataStream>
 #include <QSaveFile>
 #include <QString>
 
 #include "document.h"
 #include "levelonepage.h"
+#include "outputbuffer.h"
 #include "pagebase.h"
 
 class SaveFormat
@@ -36,6 +36,8 @@ public:
 
 	virtual void saveAllPages(QSaveFile &outFile, const TeletextDocument &document);
 	virtual void saveCurrentSubPage(QSaveFile &outFile, const TeletextDocument &document);
+	// New instance of the same format, for saving on another thread
+	virtual SaveFormat *create() const =0;
 
 	virtual QString description() const =0;
 	virtual QStringList extensions() const =0;
@@ -64,10 +66,12 @@ protected:
 
 	virtual int writePacket(QByteArray packet, int packetNumber, int designationCode = -1);
 	virtual int writeRawData(const char *s, int len);
+	void finishOutput();
 
 	TeletextDocument const *m_document;
 	QSaveFile *m_outFile;
-	QDataStream m_outStream;
+	// Everything is written through this and reaches the file in large blocks
+	OutputBuffer m_outBuffer;
 	QStringList m_warnings;
 	QString m_error;
 };
@@ -75,6 +79,7 @@ protected:
 class SaveTTIFormat : public SaveFormat
 {
 public:
+	SaveFormat *create() const override { return new SaveTTIFormat; };
 	QString description() const override { return QString("MRG Systems TTI"); };
 	QStringList extensions() const override { return QStringList { "tti", "ttix" }; };
 
@@ -85,6 +90,9 @@ protected:
 
 	virtual int writePacket(QByteArray packet, int packetNumber, int designationCode = -1);
 	void writeString(const QString &command);
+	// Writes the two letter command and its comma, the arguments are then appended to m_outBuffer
+	void startCommand(const char *command);
+	void endCommand();
 
 	QByteArray format7BitPacket(QByteArray packet);
 	QByteArray format4BitPacket(QByteArray packet) { return format18BitPacket(packet); };
@@ -93,14 +101,34 @@ protected:
 
 class SaveM29Format : public SaveTTIFormat
 {
+public:
+	SaveFormat *create() const override { return new SaveM29Format; };
+
 protected:
 	void writeSubPageStart(const PageBase &subPage, int subPageNumber=0);
 	void writeSubPageBody(const PageBase &subPage);
 };
 
+// Binary container of the whole document with packets stored as they are held,
+// so it can be loaded back without any parsing or decoding. See projectformat.h for the layout.
+class SaveProjectFormat : public SaveFormat
+{
+public:
+	SaveFormat *create() const override { return new SaveProjectFormat; };
+	QString description() const override { return QString("QTeletextMaker project"); };
+	QStringList extensions() const override { return QStringList { "tmb" }; };
+
+protected:
+	void writeDocumentStart() override;
+	void writeSubPageStart(const PageBase &subPage, int subPageNumber=0) override;
+	void writeSubPageBody(const PageBase &subPage) override;
+	int writePacket(QByteArray packet, int packetNumber, int designationCode = -1) override;
+};
+
 class SaveT42Format : public SaveFormat
 {
 public:
+	SaveFormat *create() const override { return new SaveT42Format; };
 	QString description() const override { return QString("t42 packet stream"); };
 	QStringList extensions() const override { return QStringList { "t42" }; };
 
@@ -118,6 +146,7 @@ protected:
 class SaveHTTFormat : public SaveT42Format
 {
 public:
+	SaveFormat *create() const override { return new SaveHTTFormat; };
 	QString description() const override { return QString("HMS SD-Teletext HTT"); };
 	QStringList extensions() const override { return QStringList { "htt" }; };
 
@@ -128,6 +157,7 @@ protected:
 class SaveEP1Format : public SaveFormat
 {
 public:
+	SaveFormat *create() const override { return new SaveEP1Format; };
 	QString description() const override { return QString("Softel EP1"); };
 	QStringList extensions() const override { return QStringList { "ep1" }; };
 	virtual bool getWarnings(const PageBase &subPage);
@@ -163,13 +193,14 @@ public:
 
 	SaveFormat *findFormat(const QString &suffix) const;
 	SaveFormat *findExportFormat(const QString &suffix) const;
+	SaveFormat *createExportFormat(const QString &suffix) const;
 	QString filters() const { return s_filters; };
 	QString exportFilters() const { return s_exportFilters; };
 	bool isExportOnly(const QString &suffix) const { return findFormat(suffix) == nullptr; };
 
 private:
-	static const inline int s_size = 4;
-	static const inline int s_nativeSize = 1;
+	static const inline int s_size = 5;
+	static const inline int s_nativeSize = 2;
 	static int s_instances;
 	inline static SaveFormat *s_fileFormat[s_size];
 	inline static QString s_filters, s_exportFilters;
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QMetaObject>
+#include <QString>
+#include <QVariant>
+
+#include <memory>
+
+#include "servicedirectory.h"
+
+#include "document.h"
+#include "loadformats.h"
+
+ServiceDirectory::ServiceDirectory(QObject *parent): QObject(parent)
+{
+	m_fileCount = m_loadedCount = m_failedCount = 0;
+}
+
+ServiceDirectory::~ServiceDirectory()
+{
+	cancel();
+	m_threadPool.waitForDone();
+}
+
+bool ServiceDirectory::load(const QString &path)
+{
+	cancel();
+
+	m_path = path;
+	m_index.clear();
+	m_failures.clear();
+	m_fileCount = m_loadedCount = m_failedCount = 0;
+	m_error.clear();
+
+	const QDir directory(path);
+
+	if (!directory.exists()) {
+		m_error = QString("Directory %1 does not exist").arg(QDir::toNativeSeparators(path));
+		return false;
+	}
+
+	QStringList files;
+
+	for (const QFileInfo &entry : directory.entryInfoList(QDir::Files, QDir::Name))
+		if (m_loadFormats.findFormat(entry.suffix()) != nullptr)
+			files.append(entry.filePath());
+
+	m_fileCount = files.size();
+
+	if (files.isEmpty()) {
+		emit finished();
+		return true;
+	}
+
+	// Results are handed back through the event loop so the index is only touched on this thread
+	const int generation = m_generation.loadAcquire();
+
+	for (const QString &fileName : files)
+		m_threadPool.start([this, generation, fileName]() {
+			if (m_generation.loadAcquire() != generation)
+				return;
+
+			const loadResult result = loadFile(fileName);
+
+			QMetaObject::invokeMethod(this, [this, generation, result]() { addResult(generation, result); }, Qt::QueuedConnection);
+		});
+
+	return true;
+}
+
+void ServiceDirectory::cancel()
+{
+	m_generation.fetchAndAddOrdered(1);
+	m_threadPool.clear();
+	m_fileCount = m_loadedCount + m_failedCount;
+}
+
+ServiceDirectory::loadResult ServiceDirectory::loadFile(const QString &fileName) const
+{
+	loadResult result;
+
+	result.page.fileName = fileName;
+
+	// The formats held by LoadFormats are shared, so this thread needs one of its own
+	std::unique_ptr<LoadFormat> loadingFormat(m_loadFormats.createFormat(QFileInfo(fileName).suffix()));
+
+	if (loadingFormat == nullptr) {
+		result.error = QString("Unknown file format or extension");
+		return result;
+	}
+
+	QFile file(fileName);
+
+	if (!file.open(QFile::ReadOnly)) {
+		result.error = file.errorString();
+		return result;
+	}
+
+	QList<PageBase> subPages;
+	QVariantHash metadata;
+
+	if (!loadingFormat->load(&file, subPages, &metadata)) {
+		result.error = loadingFormat->errorString();
+		return result;
+	}
+
+	// Load into a document so the level takes the region and cycle metadata into account
+	// just as it would when the file is opened
+	TeletextDocument document;
+
+	document.loadFromList(subPages);
+	document.loadMetaData(metadata);
+
+	result.page.pageNumber = metadata.contains("pageNumber") ? document.pageNumber() : -1;
+	result.page.description = document.description();
+	result.page.subPageCount = document.numberOfSubPages();
+	result.page.levelRequired = document.levelRequired();
+
+	return result;
+}
+
+void ServiceDirectory::addResult(int generation, const loadResult &result)
+{
+	if (generation != m_generation.loadAcquire())
+		return;
+
+	if (result.error.isEmpty()) {
+		m_index.insert(result.page.pageNumber, result.page);
+		m_loadedCount++;
+		emit pageLoaded(result.page);
+	} else {
+		m_failures.append(QString("%1: %2").arg(QDir::toNativeSeparators(result.page.fileName), result.error));
+		m_failedCount++;
+	}
+
+	emit progress(m_loadedCount + m_failedCount, m_fileCount);
+
+	if (!isLoading())
+		emit finished();
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVICEDIRECTORY_H
+#define SERVICEDIRECTORY_H
+
+#include <QAtomicInt>
+#include <QMultiMap>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "loadformats.h"
+
+// Loads every page file in a directory making up a teletext service, parsing the files
+// concurrently on a pool of threads, and indexes them by page number.
+// Pages are added to the index and announced one by one as they finish loading,
+// so a view of the service can fill in while the rest are still being parsed.
+class ServiceDirectory : public QObject
+{
+	Q_OBJECT
+
+public:
+	struct PageInfo {
+		QString fileName;
+		// -1 if the file doesn't say which page it is
+		int pageNumber;
+		QString description;
+		int subPageCount;
+		int levelRequired;
+	};
+
+	explicit ServiceDirectory(QObject *parent = nullptr);
+	~ServiceDirectory();
+
+	// Any directory still loading is abandoned
+	bool load(const QString &path);
+	void cancel();
+	bool isLoading() const { return m_loadedCount + m_failedCount < m_fileCount; };
+
+	QString path() const { return m_path; };
+	// More than one file may be found with the same page number
+	const QMultiMap<int, PageInfo> &index() const { return m_index; };
+	int fileCount() const { return m_fileCount; };
+	int loadedCount() const { return m_loadedCount; };
+	// Each entry is the file name followed by why it couldn't be loaded
+	QStringList failures() const { return m_failures; };
+	QString errorString() const { return m_error; };
+
+signals:
+	void pageLoaded(const ServiceDirectory::PageInfo &page);
+	void progress(int done, int total);
+	void finished();
+
+private:
+	struct loadResult {
+		PageInfo page;
+		QString error;
+	};
+
+	loadResult loadFile(const QString &fileName) const;
+	void addResult(int generation, const loadResult &result);
+
+	LoadFormats m_loadFormats;
+	QThreadPool m_threadPool;
+	// Bumped on each load so results from an abandoned directory are thrown away
+	QAtomicInt m_generation;
+
+	QString m_path;
+	QMultiMap<int, PageInfo> m_index;
+	QStringList m_failures;
+	int m_fileCount, m_loadedCount, m_failedCount;
+	QString m_error;
+};
+
+#endif
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "servicedockwidget.h"
+
+#include "servicedirectory.h"
+
+ServiceDockWidget::ServiceDockWidget(QWidget *parent): QDockWidget(parent)
+{
+	QVBoxLayout *serviceLayout = new QVBoxLayout;
+	QWidget *serviceWidget = new QWidget;
+
+	this->setObjectName("ServiceDockWidget");
+	this->setWindowTitle("Service");
+
+	m_statusLabel = new QLabel(tr("No service directory open"));
+	m_statusLabel->setWordWrap(true);
+	serviceLayout->addWidget(m_statusLabel);
+
+	m_pageTree = new QTreeWidget;
+	m_pageTree->setColumnCount(4);
+	m_pageTree->setHeaderLabels(QStringList { tr("Page"), tr("Subpages"), tr("Level"), tr("Description") });
+	m_pageTree->setRootIsDecorated(true);
+	m_pageTree->setUniformRowHeights(true);
+	m_pageTree->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+	m_pageTree->header()->setSectionResizeMode(1, QHeaderView::ResizeToContents);
+	m_pageTree->header()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
+	serviceLayout->addWidget(m_pageTree);
+
+	for (int i=0; i<9; i++)
+		m_magazineItems[i] = nullptr;
+
+	connect(m_pageTree, &QTreeWidget::itemActivated, this, [=](QTreeWidgetItem *item) {
+		const QString fileName = item->data(0, Qt::UserRole + 1).toString();
+
+		if (!fileName.isEmpty())
+			emit openFileRequested(fileName);
+	});
+
+	connect(&m_serviceDirectory, &ServiceDirectory::pageLoaded, this, &ServiceDockWidget::addPage);
+	connect(&m_serviceDirectory, &ServiceDirectory::progress, this, &ServiceDockWidget::updateProgress);
+	connect(&m_serviceDirectory, &ServiceDirectory::finished, this, &ServiceDockWidget::loadingFinished);
+
+	serviceWidget->setLayout(serviceLayout);
+	this->setWidget(serviceWidget);
+}
+
+void ServiceDockWidget::openDirectory(const QString &path)
+{
+	m_pageTree->clear();
+	for (int i=0; i<9; i++)
+		m_magazineItems[i] = nullptr;
+
+	setWindowTitle(QString("Service - %1").arg(QFileInfo(path).fileName()));
+	m_statusLabel->setText(tr("Loading..."));
+
+	if (!m_serviceDirectory.load(path))
+		m_statusLabel->setText(m_serviceDirectory.errorString());
+}
+
+QTreeWidgetItem *ServiceDockWidget::magazineItem(int magazine)
+{
+	if (m_magazineItems[magazine] != nullptr)
+		return m_magazineItems[magazine];
+
+	QTreeWidgetItem *item = new QTreeWidgetItem(QStringList { magazine == 0 ? tr("No page number") : tr("Magazine %1").arg(magazine) });
+
+	item->setData(0, Qt::UserRole, magazine);
+	item->setFlags(Qt::ItemIsEnabled);
+
+	// Keep the magazines in order, with unnumbered pages at the end
+	const int sortKey = magazine == 0 ? 9 : magazine;
+	int position = 0;
+
+	while (position < m_pageTree->topLevelItemCount()) {
+		const int otherMagazine = m_pageTree->topLevelItem(position)->data(0, Qt::UserRole).toInt();
+
+		if ((otherMagazine == 0 ? 9 : otherMagazine) > sortKey)
+			break;
+		position++;
+	}
+
+	m_pageTree->insertTopLevelItem(position, item);
+	item->setExpanded(true);
+	m_magazineItems[magazine] = item;
+
+	return item;
+}
+
+void ServiceDockWidget::addPage(const ServiceDirectory::PageInfo &page)
+{
+	const char *levelLabel[] = { "1", "1.5", "2.5", "3.5" };
+	const int magazine = page.pageNumber == -1 ? 0 : page.pageNumber >> 8;
+	QTreeWidgetItem *parentItem = magazineItem(magazine);
+
+	QTreeWidgetItem *item = new QTreeWidgetItem;
+
+	item->setText(0, page.pageNumber == -1 ? QFileInfo(page.fileName).fileName() : QString("P%1").arg(page.pageNumber, 3, 16).toUpper());
+	item->setText(1, QString::number(page.subPageCount));
+	item->setText(2, levelLabel[page.levelRequired]);
+	item->setText(3, page.description);
+	item->setToolTip(0, QDir::toNativeSeparators(page.fileName));
+	item->setData(0, Qt::UserRole, page.pageNumber);
+	item->setData(0, Qt::UserRole + 1, page.fileName);
+
+	// Results arrive in whatever order the threads finish, so find where this page goes
+	int low = 0;
+	int high = parentItem->childCount();
+
+	while (low < high) {
+		const int middle = (low + high) / 2;
+		const QTreeWidgetItem *other = parentItem->child(middle);
+
+		if (other->data(0, Qt::UserRole).toInt() < page.pageNumber || (other->data(0, Qt::UserRole).toInt() == page.pageNumber && other->data(0, Qt::UserRole + 1).toString() < page.fileName))
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	parentItem->insertChild(low, item);
+}
+
+void ServiceDockWidget::updateProgress(int done, int total)
+{
+	m_statusLabel->setText(tr("Loading %1 of %2 files...").arg(done).arg(total));
+}
+
+void ServiceDockWidget::loadingFinished()
+{
+	QString status = tr("%1 pages in %2").arg(m_serviceDirectory.loadedCount()).arg(QDir::toNativeSeparators(m_serviceDirectory.path()));
+
+	if (!m_serviceDirectory.failures().isEmpty()) {
+		status.append(tr(", %1 files could not be loaded").arg(m_serviceDirectory.failures().size()));
+		m_statusLabel->setToolTip(m_serviceDirectory.failures().join('\n'));
+	} else
+		m_statusLabel->setToolTip(QString());
+
+	m_statusLabel->setText(status);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVICEDOCKWIDGET_H
+#define SERVICEDOCKWIDGET_H
+
+#include <QDockWidget>
+#include <QLabel>
+#include <QTreeWidget>
+
+#include "servicedirectory.h"
+
+// Tree of the pages in a service directory by magazine, filled in as the pages are loaded
+class ServiceDockWidget : public QDockWidget
+{
+	Q_OBJECT
+
+public:
+	ServiceDockWidget(QWidget *parent);
+
+	void openDirectory(const QString &path);
+
+signals:
+	void openFileRequested(const QString &fileName);
+
+private slots:
+	void addPage(const ServiceDirectory::PageInfo &page);
+	void updateProgress(int done, int total);
+	void loadingFinished();
+
+private:
+	QTreeWidgetItem *magazineItem(int magazine);
+
+	ServiceDirectory m_serviceDirectory;
+	QLabel *m_statusLabel;
+	QTreeWidget *m_pageTree;
+	// Top level items for magazines 1 to 8 and pages without a number, created as they're needed
+	QTreeWidgetItem *m_magazineItems[9];
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+#include "startuptiming.h"
+
+Q_LOGGING_CATEGORY(lcStartup, "qteletextmaker.startup", QtInfoMsg)
+
+static QElapsedTimer s_startTimer;
+static qint64 s_lastPhase = 0;
+
+void StartupTiming::start()
+{
+	s_startTimer.start();
+	s_lastPhase = 0;
+}
+
+void StartupTiming::phase(const char *name)
+{
+	if (!lcStartup().isDebugEnabled() || !s_startTimer.isValid())
+		return;
+
+	const qint64 now = s_startTimer.nsecsElapsed();
+
+	qCDebug(lcStartup, "%-32s %8.2f ms %8.2f ms total", name, (now - s_lastPhase) / 1e6, now / 1e6);
+	s_lastPhase = now;
+}
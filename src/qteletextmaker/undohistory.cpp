@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QAction>
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QUndoCommand>
+
+#include "undohistory.h"
+
+XorDelta::XorDelta(const QByteArray &before, const QByteArray &after)
+{
+	Q_ASSERT(before.size() == after.size() && before.size() <= 0x10000);
+
+	m_size = before.size();
+
+	int i = 0;
+
+	while (i < m_size) {
+		if (before.at(i) == after.at(i)) {
+			i++;
+			continue;
+		}
+
+		// Carry the run on over gaps of unchanged bytes no bigger than the header of a new run
+		int lastChanged = i;
+
+		for (int j=i+1; j<m_size && j-i < 255 && j-lastChanged <= 3; j++)
+			if (before.at(j) != after.at(j))
+				lastChanged = j;
+
+		const int length = lastChanged - i + 1;
+
+		m_runs.append(static_cast<char>(i & 0xff));
+		m_runs.append(static_cast<char>(i >> 8));
+		m_runs.append(static_cast<char>(length));
+		for (int j=i; j<=lastChanged; j++)
+			m_runs.append(static_cast<char>(before.at(j) ^ after.at(j)));
+
+		i = lastChanged + 1;
+	}
+
+	m_runs.squeeze();
+}
+
+void XorDelta::apply(QByteArray &data) const
+{
+	if (m_runs.isEmpty() || data.size() != m_size)
+		return;
+
+	const char *run = m_runs.constData();
+	const char *runsEnd = run + m_runs.size();
+	char *dataPointer = data.data();
+
+	while (run < runsEnd) {
+		const int offset = static_cast<unsigned char>(run[0]) | (static_cast<unsigned char>(run[1]) << 8);
+		const int length = static_cast<unsigned char>(run[2]);
+
+		run += 3;
+		for (int j=0; j<length; j++)
+			dataPointer[offset+j] ^= run[j];
+		run += length;
+	}
+}
+
+void XorDelta::merge(const XorDelta &newer)
+{
+	if (newer.isNull())
+		return;
+	if (isNull()) {
+		*this = newer;
+		return;
+	}
+
+	// Both deltas applied to a block of zeroes leaves the combined difference
+	const QByteArray zeroes(m_size, 0);
+	QByteArray combined = zeroes;
+
+	apply(combined);
+	newer.apply(combined);
+	*this = XorDelta(zeroes, combined);
+}
+
+void XorDelta::clear()
+{
+	m_runs = QByteArray();
+}
+
+
+// Rough size of a command object along with QUndoCommand's private data and its text
+static qsizetype commandOverhead(const QUndoCommand *command)
+{
+	return 256 + command->text().size() * sizeof(QChar);
+}
+
+qsizetype HistoryCommand::memoryUsage() const
+{
+	return commandOverhead(this);
+}
+
+
+UndoHistory::UndoHistory(QObject *parent) : QObject(parent)
+{
+	m_index = m_cleanIndex = 0;
+	m_memoryLimit = DefaultMemoryLimit;
+	m_memoryUsage = m_reportedMemoryUsage = 0;
+}
+
+UndoHistory::~UndoHistory()
+{
+	qDeleteAll(m_commands);
+}
+
+void UndoHistory::push(QUndoCommand *command)
+{
+	if (!command->isObsolete())
+		command->redo();
+
+	QUndoCommand *currentCommand = m_index > 0 ? m_commands.at(m_index-1) : nullptr;
+
+	// Anything that could have been redone is lost
+	while (m_index < m_commands.size())
+		takeCommand(m_commands.size()-1);
+	if (m_cleanIndex > m_index)
+		m_cleanIndex = -1;
+
+	const bool tryMerge = currentCommand != nullptr && currentCommand->id() != -1 && currentCommand->id() == command->id() && m_index != m_cleanIndex;
+
+	if (tryMerge && currentCommand->mergeWith(command)) {
+		delete command;
+
+		if (currentCommand->isObsolete()) {
+			takeCommand(m_index-1);
+			setIndex(m_index-1, false);
+		} else {
+			updateCommandMemory(m_index-1);
+			emit indexChanged(m_index);
+			emit canUndoChanged(canUndo());
+			emit undoTextChanged(undoText());
+			emit canRedoChanged(canRedo());
+			emit redoTextChanged(redoText());
+		}
+	} else if (command->isObsolete())
+		delete command;
+	else {
+		m_commands.append(command);
+		m_commandMemory.append(0);
+		updateCommandMemory(m_commands.size()-1);
+		setIndex(m_index+1, false);
+	}
+
+	limitMemoryUsage();
+}
+
+void UndoHistory::clear()
+{
+	const bool wasClean = isClean();
+
+	qDeleteAll(m_commands);
+	m_commands.clear();
+	m_commandMemory.clear();
+	m_memoryUsage = 0;
+	m_index = m_cleanIndex = 0;
+
+	emit indexChanged(0);
+	emit canUndoChanged(false);
+	emit undoTextChanged(QString());
+	emit canRedoChanged(false);
+	emit redoTextChanged(QString());
+	if (!wasClean)
+		emit cleanChanged(true);
+
+	limitMemoryUsage();
+}
+
+QString UndoHistory::undoText() const
+{
+	return m_index > 0 ? m_commands.at(m_index-1)->actionText() : QString();
+}
+
+QString UndoHistory::redoText() const
+{
+	return m_index < m_commands.size() ? m_commands.at(m_index)->actionText() : QString();
+}
+
+void UndoHistory::undo()
+{
+	if (m_index == 0)
+		return;
+
+	const int i = m_index-1;
+	QUndoCommand *command = m_commands.at(i);
+
+	if (!command->isObsolete())
+		command->undo();
+	// Commands can make themselves obsolete as they're undone
+	if (command->isObsolete()) {
+		takeCommand(i);
+		if (m_cleanIndex > i)
+			resetClean();
+	} else
+		updateCommandMemory(i);
+
+	setIndex(i, false);
+	limitMemoryUsage();
+}
+
+void UndoHistory::redo()
+{
+	if (m_index == m_commands.size())
+		return;
+
+	const int i = m_index;
+	QUndoCommand *command = m_commands.at(i);
+
+	if (!command->isObsolete())
+		command->redo();
+	if (command->isObsolete()) {
+		takeCommand(i);
+		if (m_cleanIndex > i)
+			resetClean();
+		setIndex(i, false);
+	} else {
+		updateCommandMemory(i);
+		setIndex(i+1, false);
+	}
+
+	limitMemoryUsage();
+}
+
+void UndoHistory::setClean()
+{
+	setIndex(m_index, true);
+}
+
+void UndoHistory::resetClean()
+{
+	const bool wasClean = isClean();
+
+	m_cleanIndex = -1;
+	if (wasClean)
+		emit cleanChanged(false);
+}
+
+void UndoHistory::setPrefixedText(QAction *action, const QString &prefix, const QString &text)
+{
+	action->setText(text.isEmpty() ? prefix : prefix + ' ' + text);
+}
+
+QAction *UndoHistory::createUndoAction(QObject *parent, const QString &prefix) const
+{
+	QAction *action = new QAction(parent);
+
+	action->setEnabled(canUndo());
+	setPrefixedText(action, prefix, undoText());
+	connect(this, &UndoHistory::canUndoChanged, action, &QAction::setEnabled);
+	connect(this, &UndoHistory::undoTextChanged, action, [=](const QString &text) { setPrefixedText(action, prefix, text); });
+	connect(action, &QAction::triggered, this, &UndoHistory::undo);
+
+	return action;
+}
+
+QAction *UndoHistory::createRedoAction(QObject *parent, const QString &prefix) const
+{
+	QAction *action = new QAction(parent);
+
+	action->setEnabled(canRedo());
+	setPrefixedText(action, prefix, redoText());
+	connect(this, &UndoHistory::canRedoChanged, action, &QAction::setEnabled);
+	connect(this, &UndoHistory::redoTextChanged, action, [=](const QString &text) { setPrefixedText(action, prefix, text); });
+	connect(action, &QAction::triggered, this, &UndoHistory::redo);
+
+	return action;
+}
+
+void UndoHistory::setMemoryLimit(qsizetype memoryLimit)
+{
+	m_memoryLimit = memoryLimit;
+	limitMemoryUsage();
+}
+
+qsizetype UndoHistory::commandMemoryUsage(const QUndoCommand *command)
+{
+	const HistoryCommand *historyCommand = dynamic_cast<const HistoryCommand *>(command);
+	qsizetype result = historyCommand ? historyCommand->memoryUsage() : commandOverhead(command);
+
+	for (int i=0; i<command->childCount(); i++)
+		result += commandMemoryUsage(command->child(i));
+
+	return result;
+}
+
+void UndoHistory::evictCommand(QUndoCommand *command)
+{
+	HistoryCommand *historyCommand = dynamic_cast<HistoryCommand *>(command);
+
+	if (historyCommand)
+		historyCommand->evict();
+	// QUndoCommand only hands out const pointers to its children, but they belong to it
+	for (int i=0; i<command->childCount(); i++)
+		evictCommand(const_cast<QUndoCommand *>(command->child(i)));
+}
+
+void UndoHistory::setIndex(int index, bool clean)
+{
+	const bool wasClean = isClean();
+
+	if (index != m_index) {
+		m_index = index;
+		emit indexChanged(m_index);
+		emit canUndoChanged(canUndo());
+		emit undoTextChanged(undoText());
+		emit canRedoChanged(canRedo());
+		emit redoTextChanged(redoText());
+	}
+
+	if (clean)
+		m_cleanIndex = m_index;
+
+	if (isClean() != wasClean)
+		emit cleanChanged(isClean());
+}
+
+void UndoHistory::takeCommand(int i)
+{
+	m_memoryUsage -= m_commandMemory.takeAt(i);
+	delete m_commands.takeAt(i);
+}
+
+void UndoHistory::updateCommandMemory(int i)
+{
+	const qsizetype usage = commandMemoryUsage(m_commands.at(i));
+
+	m_memoryUsage += usage - m_commandMemory.at(i);
+	m_commandMemory[i] = usage;
+}
+
+void UndoHistory::limitMemoryUsage()
+{
+	// Evict the oldest commands until back under the limit.
+	// The most recent command is always kept, as are commands that can be redone.
+	while (m_memoryLimit > 0 && m_memoryUsage > m_memoryLimit && m_index > 1) {
+		evictCommand(m_commands.first());
+		takeCommand(0);
+		m_index--;
+
+		// The clean state was at or before the evicted command so it can't be got back to,
+		// without this undoing down to the bottom of the stack would look unmodified
+		if (m_cleanIndex <= 0)
+			resetClean();
+		else
+			m_cleanIndex--;
+
+		emit indexChanged(m_index);
+	}
+
+	if (m_memoryUsage != m_reportedMemoryUsage) {
+		m_reportedMemoryUsage = m_memoryUsage;
+		emit memoryUsageChanged(m_memoryUsage);
+	}
+}
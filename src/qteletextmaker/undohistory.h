@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+#include <QAction>
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QUndoCommand>
+
+// Difference between two blocks of bytes of the same size, held as runs of the changed bytes
+// exclusive-ored together. Applying it to either block gives the other, so the same delta
+// serves both undo and redo.
+class XorDelta
+{
+public:
+	XorDelta() : m_size(0) { }
+	XorDelta(const QByteArray &before, const QByteArray &after);
+
+	void apply(QByteArray &data) const;
+	// Combines with a delta taken after this one was applied, as when undo commands merge
+	void merge(const XorDelta &newer);
+	void clear();
+	bool isNull() const { return m_runs.isEmpty(); }
+	qsizetype memoryUsage() const { return sizeof(*this) + m_runs.capacity(); }
+
+private:
+	// Each run is a two byte offset, a one byte length then that many exclusive-ored bytes
+	QByteArray m_runs;
+	int m_size;
+};
+
+// Undo command that knows how much memory it holds, and can give it up when the history is full
+class HistoryCommand : public QUndoCommand
+{
+public:
+	explicit HistoryCommand(QUndoCommand *parent = 0) : QUndoCommand(parent) { }
+
+	virtual qsizetype memoryUsage() const;
+	// Frees what is needed to undo the command, after which it can only be dropped from the history
+	virtual void evict() { }
+};
+
+// Undo stack that keeps the memory held by its commands under a limit, by evicting
+// the oldest commands once the limit is reached.
+// It works like QUndoStack without macros, but QUndoStack can't take commands off the bottom
+// of the stack so this keeps its own list of commands.
+class UndoHistory : public QObject
+{
+	Q_OBJECT
+
+public:
+	static constexpr qsizetype DefaultMemoryLimit = 64 * 1024 * 1024;
+
+	explicit UndoHistory(QObject *parent = nullptr);
+	~UndoHistory();
+
+	void push(QUndoCommand *command);
+	void clear();
+
+	bool canUndo() const { return m_index > 0; }
+	bool canRedo() const { return m_index < m_commands.size(); }
+	QString undoText() const;
+	QString redoText() const;
+	int count() const { return m_commands.size(); }
+	int index() const { return m_index; }
+
+	bool isClean() const { return m_cleanIndex == m_index; }
+	// -1 if the clean state can't be reached, such as when its commands have been evicted
+	int cleanIndex() const { return m_cleanIndex; }
+	void resetClean();
+
+	QAction *createUndoAction(QObject *parent, const QString &prefix) const;
+	QAction *createRedoAction(QObject *parent, const QString &prefix) const;
+
+	qsizetype memoryLimit() const { return m_memoryLimit; }
+	// 0 for no limit
+	void setMemoryLimit(qsizetype memoryLimit);
+	qsizetype memoryUsage() const { return m_memoryUsage; }
+
+public slots:
+	void undo();
+	void redo();
+	void setClean();
+
+signals:
+	void indexChanged(int index);
+	void cleanChanged(bool clean);
+	void canUndoChanged(bool canUndo);
+	void canRedoChanged(bool canRedo);
+	void undoTextChanged(const QString &undoText);
+	void redoTextChanged(const QString &redoText);
+	void memoryUsageChanged(qsizetype memoryUsage);
+
+private:
+	static qsizetype commandMemoryUsage(const QUndoCommand *command);
+	static void evictCommand(QUndoCommand *command);
+	static void setPrefixedText(QAction *action, const QString &prefix, const QString &text);
+
+	void setIndex(int index, bool clean);
+	void takeCommand(int i);
+	// Counts again the memory of one command, which can change as it's undone, redone or merged
+	void updateCommandMemory(int i);
+	void limitMemoryUsage();
+
+	QList<QUndoCommand *> m_commands;
+	// Memory held by each command, so the total can be kept without going through them all
+	QList<qsizetype> m_commandMemory;
+	int m_index, m_cleanIndex;
+	qsizetype m_memoryLimit, m_memoryUsage, m_reportedMemoryUsage;
+};
+
+#endif
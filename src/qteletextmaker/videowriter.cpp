@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QImage>
+#include <QList>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QString>
+
+#include <cstring>
+
+#include "videowriter.h"
+
+#include "document.h"
+#include "offscreenrender.h"
+
+RawVideoWriter::RawVideoWriter(const TeletextDocument &document) : m_document(document)
+{
+	m_pixelFormat = PixelRGB24;
+	m_frameRate = 25;
+	m_cycleTime = TeletextDocument::DefaultCycleTime;
+	m_flashHz = QList<int>(m_document.numberOfSubPages(), -1);
+	m_renderCount = 0;
+}
+
+void RawVideoWriter::setRenderOptions(const TeletextOffscreenRender::Options &options)
+{
+	m_options = options;
+	m_frameSize = QSize();
+	m_frames.clear();
+	m_flashHz.fill(-1);
+}
+
+// Side panels are set for each subpage and change its width, but every frame of a raw stream
+// has to be the same number of bytes
+QSize RawVideoWriter::frameSize()
+{
+	if (m_frameSize.isEmpty()) {
+		for (int p=0; p<m_document.numberOfSubPages(); p++) {
+			m_offscreenRender.setTeletextPage(m_document.subPage(p));
+			m_frameSize = m_frameSize.expandedTo(m_offscreenRender.size(m_options));
+		}
+	}
+
+	return m_frameSize;
+}
+
+// A single subpage just has its flashing cycled, which repeats every second
+int RawVideoWriter::carouselDuration() const
+{
+	if (m_document.numberOfSubPages() == 1)
+		return 1000;
+
+	int result = 0;
+
+	for (int p=0; p<m_document.numberOfSubPages(); p++)
+		result += m_document.cycleDuration(p, m_cycleTime);
+
+	return result;
+}
+
+int RawVideoWriter::subPageAt(int time) const
+{
+	if (m_document.numberOfSubPages() == 1)
+		return 0;
+
+	for (int p=0; p<m_document.numberOfSubPages(); p++) {
+		time -= m_document.cycleDuration(p, m_cycleTime);
+		if (time < 0)
+			return p;
+	}
+
+	return m_document.numberOfSubPages() - 1;
+}
+
+QByteArray RawVideoWriter::frameData(int subPageIndex, int flashPhase)
+{
+	if (m_offscreenRender.teletextPage() != m_document.subPage(subPageIndex))
+		m_offscreenRender.setTeletextPage(m_document.subPage(subPageIndex));
+
+	if (m_flashHz.at(subPageIndex) == -1)
+		m_flashHz[subPageIndex] = m_offscreenRender.flashHz(m_options);
+
+	// Phases share a frame if the page flashes slower, or not at all
+	if (m_flashHz.at(subPageIndex) == 0)
+		flashPhase = 0;
+	else if (m_flashHz.at(subPageIndex) == 1)
+		flashPhase = (flashPhase < 3) ? 0 : 3;
+
+	const int key = subPageIndex * 6 + flashPhase;
+	const auto cached = m_frames.constFind(key);
+
+	if (cached != m_frames.constEnd())
+		return cached.value();
+
+	TeletextOffscreenRender::Options options = m_options;
+
+	options.flashPhase = flashPhase;
+
+	QByteArray result = convertFrame(m_offscreenRender.image(options, QImage::Format_Indexed8));
+
+	m_renderCount++;
+
+	// Flash phases that come out the same, such as when only concealed text flashes,
+	// share one copy of the frame
+	for (int p=0; p<6; p++) {
+		const auto other = m_frames.constFind(subPageIndex * 6 + p);
+
+		if (other != m_frames.constEnd() && other.value() == result) {
+			result = other.value();
+			break;
+		}
+	}
+
+	m_frames.insert(key, result);
+	return result;
+}
+
+// Centres a narrower subpage within the frame size, surrounded by transparent
+QImage RawVideoWriter::paddedFrame(const QImage &frame) const
+{
+	if (frame.size() == m_frameSize)
+		return frame;
+
+	QImage result(m_frameSize, QImage::Format_Indexed8);
+
+	result.setColorTable(frame.colorTable());
+	result.fill(TeletextOffscreenRender::TransparentIndex);
+
+	const int left = (m_frameSize.width() - frame.width()) / 2;
+	const int top = (m_frameSize.height() - frame.height()) / 2;
+	const QRect copyRect = QRect(QPoint(left, top), frame.size()) & result.rect();
+
+	for (int y=copyRect.top(); y<=copyRect.bottom(); y++)
+		std::memcpy(result.scanLine(y) + copyRect.left(), frame.constScanLine(y - top) + copyRect.left() - left, copyRect.width());
+
+	return result;
+}
+
+// The render is indexed into the page's CLUT, so each output pixel is a table lookup
+QByteArray RawVideoWriter::convertFrame(const QImage &renderedFrame) const
+{
+	const QImage frame = paddedFrame(renderedFrame);
+	const int width = frame.width();
+	const int height = frame.height();
+	const QList<QRgb> colourTable = frame.colorTable();
+	QByteArray result;
+
+	if (m_pixelFormat == PixelYUV420) {
+		uchar lumaTable[256], blueTable[256], redTable[256];
+
+		for (int i=0; i<256; i++) {
+			const QRgb colour = (i < colourTable.size()) ? colourTable.at(i) : 0;
+			const int r = qRed(colour);
+			const int g = qGreen(colour);
+			const int b = qBlue(colour);
+
+			lumaTable[i] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+			blueTable[i] = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+			redTable[i] = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+		}
+
+		const int chromaWidth = (width + 1) / 2;
+		const int chromaHeight = (height + 1) / 2;
+
+		result.resize(width * height + 2 * chromaWidth * chromaHeight);
+
+		uchar *luma = reinterpret_cast<uchar *>(result.data());
+		uchar *blue = luma + width * height;
+		uchar *red = blue + chromaWidth * chromaHeight;
+
+		for (int y=0; y<height; y++) {
+			const uchar *line = frame.constScanLine(y);
+
+			for (int x=0; x<width; x++)
+				*luma++ = lumaTable[line[x]];
+		}
+
+		// Chroma is the average of each 2x2 block, odd edges repeat the last pixel
+		for (int y=0; y<chromaHeight; y++) {
+			const uchar *line0 = frame.constScanLine(y * 2);
+			const uchar *line1 = frame.constScanLine(qMin(y * 2 + 1, height - 1));
+
+			for (int x=0; x<chromaWidth; x++) {
+				const int x0 = x * 2;
+				const int x1 = qMin(x0 + 1, width - 1);
+
+				*blue++ = (blueTable[line0[x0]] + blueTable[line0[x1]] + blueTable[line1[x0]] + blueTable[line1[x1]] + 2) / 4;
+				*red++ = (redTable[line0[x0]] + redTable[line0[x1]] + redTable[line1[x0]] + redTable[line1[x1]] + 2) / 4;
+			}
+		}
+
+		return result;
+	}
+
+	const int bytesPerPixel = (m_pixelFormat == PixelRGBA) ? 4 : 3;
+	uchar pixelTable[256][4];
+
+	for (int i=0; i<256; i++) {
+		// Transparent comes out black, or with zero alpha in RGBA
+		const QRgb colour = (i < colourTable.size()) ? colourTable.at(i) : 0;
+
+		pixelTable[i][0] = qRed(colour);
+		pixelTable[i][1] = qGreen(colour);
+		pixelTable[i][2] = qBlue(colour);
+		pixelTable[i][3] = qAlpha(colour);
+	}
+
+	result.resize(width * height * bytesPerPixel);
+
+	uchar *pixel = reinterpret_cast<uchar *>(result.data());
+
+	for (int y=0; y<height; y++) {
+		const uchar *line = frame.constScanLine(y);
+
+		for (int x=0; x<width; x++) {
+			const uchar *entry = pixelTable[line[x]];
+
+			for (int c=0; c<bytesPerPixel; c++)
+				*pixel++ = entry[c];
+		}
+	}
+
+	return result;
+}
+
+bool RawVideoWriter::write(QIODevice *device, int duration)
+{
+	m_error.clear();
+
+	if (m_frameRate <= 0) {
+		m_error = QString("Invalid frame rate");
+		return false;
+	}
+
+	if (frameSize().isEmpty()) {
+		m_error = QString("Cannot render page");
+		return false;
+	}
+
+	const int cycle = carouselDuration();
+	const qint64 frameCount = (duration == -1 ? cycle : duration) * qint64(m_frameRate) / 1000;
+
+	for (qint64 f=0; duration == 0 || f<frameCount; f++) {
+		// Flashing runs off the same clock whichever subpage is showing
+		const qint64 time = f * 1000 / m_frameRate;
+		const int subPageIndex = subPageAt(static_cast<int>(time % cycle));
+		const int flashPhase = static_cast<int>(time * 6 / 1000 % 6);
+		const QByteArray data = frameData(subPageIndex, flashPhase);
+
+		if (data.isEmpty()) {
+			m_error = QString("Cannot render subpage %1").arg(subPageIndex + 1);
+			return false;
+		}
+		if (device->write(data) != data.size()) {
+			m_error = device->errorString();
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIDEOWRITER_H
+#define VIDEOWRITER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QList>
+#include <QSize>
+#include <QString>
+
+#include "document.h"
+#include "offscreenrender.h"
+
+// Writes a continuous stream of raw video frames of a page for piping into an external encoder,
+// flashing and cycling through the subpages in real time.
+// Each distinct subpage and flash phase is rendered and converted once, then the same
+// frame data is written again for as long as that state lasts.
+class RawVideoWriter
+{
+public:
+	// YUV420 is planar I420 with BT.601 limited range
+	enum PixelFormat { PixelRGB24, PixelRGBA, PixelYUV420 };
+
+	explicit RawVideoWriter(const TeletextDocument &document);
+
+	void setRenderOptions(const TeletextOffscreenRender::Options &options);
+	void setPixelFormat(PixelFormat pixelFormat) { m_pixelFormat = pixelFormat; };
+	void setFrameRate(int frameRate) { m_frameRate = frameRate; };
+	// Milliseconds for each cycle of subpages timed in cycles
+	void setCycleTime(int cycleTime) { m_cycleTime = cycleTime; };
+
+	// Size of the largest subpage, every frame is centred within it
+	QSize frameSize();
+	// Duration in milliseconds, 0 to carry on until the device can't be written to
+	// or -1 for one cycle through the subpages
+	bool write(QIODevice *device, int duration);
+	int renderCount() const { return m_renderCount; };
+	QString errorString() const { return m_error; };
+
+private:
+	QByteArray frameData(int subPageIndex, int flashPhase);
+	QImage paddedFrame(const QImage &frame) const;
+	QByteArray convertFrame(const QImage &frame) const;
+	int carouselDuration() const;
+	int subPageAt(int time) const;
+
+	const TeletextDocument &m_document;
+	TeletextOffscreenRender m_offscreenRender;
+	TeletextOffscreenRender::Options m_options;
+	PixelFormat m_pixelFormat;
+	int m_frameRate;
+	int m_cycleTime;
+	QSize m_frameSize;
+
+	// Converted frames keyed by subpage and flash phase
+	QHash<int, QByteArray> m_frames;
+	// Flash rate of each subpage, -1 until it has been rendered
+	QList<int> m_flashHz;
+	int m_renderCount;
+	QString m_error;
+};
+
+#endif
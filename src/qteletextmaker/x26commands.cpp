@@ -19,12 +19,34 @@
 
 #include "x26commands.h"
 
+#include <QPair>
 #include <QUndoCommand>
 
 #include "document.h"
 #include "x26model.h"
 #include "x26triplets.h"
 
+// Local object invocations pointing at or after row follow the object definitions that moved by offset.
+// Returns the first and last triplets changed, or -1 if none were, so the model can be told in one go.
+static QPair<int, int> moveLocalObjectPointers(X26TripletList *enhancements, int row, int offset)
+{
+	QPair<int, int> result(-1, -1);
+
+	for (int i=0; i<enhancements->size(); i++) {
+		X26Triplet triplet = enhancements->at(i);
+
+		if (triplet.modeExt() >= 0x11 && triplet.modeExt() <= 0x13 && ((triplet.address() & 0x18) == 0x08) && triplet.objectLocalIndex() >= row) {
+			triplet.setObjectLocalIndex(triplet.objectLocalIndex() + offset);
+			enhancements->replace(i, triplet);
+			if (result.first == -1)
+				result.first = i;
+			result.second = i;
+		}
+	}
+
+	return result;
+}
+
 InsertTripletCommand::InsertTripletCommand(TeletextDocument *teletextDocument, X26Model *x26Model, int row, int count, X26Triplet newTriplet, QUndoCommand *parent) : QUndoCommand(parent)
 {
 	m_teletextDocument = teletextDocument;
@@ -54,16 +76,10 @@ void InsertTripletCommand::redo()
 		m_x26Model->endInsertRows();
 
 	// Preserve pointers to local object definitions that have moved
-	for (int i=0; i<m_teletextDocument->currentSubPage()->enhancements()->size(); i++) {
-		X26Triplet triplet = m_teletextDocument->currentSubPage()->enhancements()->at(i);
-
-		if (triplet.modeExt() >= 0x11 && triplet.modeExt() <= 0x13 && ((triplet.address() & 0x18) == 0x08) && triplet.objectLocalIndex() >= m_row) {
-			triplet.setObjectLocalIndex(triplet.objectLocalIndex() + m_count);
-			m_teletextDocument->currentSubPage()->enhancements()->replace(i, triplet);
-			if (!changingSubPage)
-				m_x26Model->emit dataChanged(m_x26Model->createIndex(i, 0), m_x26Model->createIndex(i, 3));
-		}
-	}
+	const QPair<int, int> moved = moveLocalObjectPointers(m_teletextDocument->currentSubPage()->enhancements(), m_row, m_count);
+
+	if (!changingSubPage && moved.first != -1)
+		m_x26Model->emit dataChanged(m_x26Model->createIndex(moved.first, 0), m_x26Model->createIndex(moved.second, 3));
 
 	if (changingSubPage)
 		m_teletextDocument->emit subPageSelected();
@@ -93,16 +109,10 @@ void InsertTripletCommand::undo()
 		m_x26Model->endRemoveRows();
 
 	// Preserve pointers to local object definitions that have moved
-	for (int i=0; i<m_teletextDocument->currentSubPage()->enhancements()->size(); i++) {
-		X26Triplet triplet = m_teletextDocument->currentSubPage()->enhancements()->at(i);
-
-		if (triplet.modeExt() >= 0x11 && triplet.modeExt() <= 0x13 && ((triplet.address() & 0x18) == 0x08) && triplet.objectLocalIndex() >= m_row) {
-			triplet.setObjectLocalIndex(triplet.objectLocalIndex() - m_count);
-			m_teletextDocument->currentSubPage()->enhancements()->replace(i, triplet);
-			if (!changingSubPage)
-				m_x26Model->emit dataChanged(m_x26Model->createIndex(i, 0), m_x26Model->createIndex(i, 3));
-		}
-	}
+	const QPair<int, int> moved = moveLocalObjectPointers(m_teletextDocument->currentSubPage()->enhancements(), m_row, -m_count);
+
+	if (!changingSubPage && moved.first != -1)
+		m_x26Model->emit dataChanged(m_x26Model->createIndex(moved.first, 0), m_x26Model->createIndex(moved.second, 3));
 
 	if (changingSubPage)
 		m_teletextDocument->emit subPageSelected();
@@ -142,15 +152,10 @@ void DeleteTripletCommand::redo()
 		m_x26Model->endRemoveRows();
 
 	// Preserve pointers to local object definitions that have moved
-	for (int i=0; i<m_teletextDocument->currentSubPage()->enhancements()->size(); i++) {
-		X26Triplet triplet = m_teletextDocument->currentSubPage()->enhancements()->at(i);
+	const QPair<int, int> moved = moveLocalObjectPointers(m_teletextDocument->currentSubPage()->enhancements(), m_row, -m_count);
 
-		if (triplet.modeExt() >= 0x11 && triplet.modeExt() <= 0x13 && ((triplet.address() & 0x18) == 0x08) && triplet.objectLocalIndex() >= m_row) {
-			triplet.setObjectLocalIndex(triplet.objectLocalIndex() - m_count);
-			m_teletextDocument->currentSubPage()->enhancements()->replace(i, triplet);
-			m_x26Model->emit dataChanged(m_x26Model->createIndex(i, 0), m_x26Model->createIndex(i, 3));
-		}
-	}
+	if (!changingSubPage && moved.first != -1)
+		m_x26Model->emit dataChanged(m_x26Model->createIndex(moved.first, 0), m_x26Model->createIndex(moved.second, 3));
 
 	if (changingSubPage)
 		m_teletextDocument->emit subPageSelected();
@@ -175,16 +180,10 @@ void DeleteTripletCommand::undo()
 		m_x26Model->endInsertRows();
 
 	// Preserve pointers to local object definitions that have moved
-	for (int i=0; i<m_teletextDocument->currentSubPage()->enhancements()->size(); i++) {
-		X26Triplet triplet = m_teletextDocument->currentSubPage()->enhancements()->at(i);
-
-		if (triplet.modeExt() >= 0x11 && triplet.modeExt() <= 0x13 && ((triplet.address() & 0x18) == 0x08) && triplet.objectLocalIndex() >= m_row) {
-			triplet.setObjectLocalIndex(triplet.objectLocalIndex() + m_count);
-			m_teletextDocument->currentSubPage()->enhancements()->replace(i, triplet);
-			if (!changingSubPage)
-				m_x26Model->emit dataChanged(m_x26Model->createIndex(i, 0), m_x26Model->createIndex(i, 3));
-		}
-	}
+	const QPair<int, int> moved = moveLocalObjectPointers(m_teletextDocument->currentSubPage()->enhancements(), m_row, m_count);
+
+	if (!changingSubPage && moved.first != -1)
+		m_x26Model->emit dataChanged(m_x26Model->createIndex(moved.first, 0), m_x26Model->createIndex(moved.second, 3));
 
 	if (changingSubPage)
 		m_teletextDocument->emit subPageSelected();
@@ -29,12 +29,16 @@ X26Model::X26Model(TeletextWidget *parent): QAbstractListModel(parent)
 {
 	m_parentMainWidget = parent;
 	m_listLoaded = true;
+	m_cachedList = nullptr;
+	m_cachedGeneration = 0;
 }
 
 void X26Model::setX26ListLoaded(bool newListLoaded)
 {
 	beginResetModel();
 	m_listLoaded = newListLoaded;
+	m_rowCache.clear();
+	m_cachedList = nullptr;
 	endResetModel();
 }
 
@@ -50,7 +54,7 @@ int X26Model::columnCount(const QModelIndex & /*parent*/) const
 
 QVariant X26Model::data(const QModelIndex &index, int role) const
 {
-	const X26Triplet triplet = m_parentMainWidget->document()->currentSubPage()->enhancements()->at(index.row());
+	const X26Triplet &triplet = m_parentMainWidget->document()->currentSubPage()->enhancements()->at(index.row());
 
 	// Qt::UserRole will always return the raw values
 	if (role == Qt::UserRole)
@@ -65,313 +69,19 @@ QVariant X26Model::data(const QModelIndex &index, int role) const
 				return QVariant();
 		}
 
-	// Error colours from KDE Plasma Breeze (light) theme
-	if (role == Qt::ForegroundRole) {
-		if (triplet.error() != X26Triplet::NoError && index.column() == m_tripletErrors[triplet.error()].columnHighlight)
-			return QColor(252, 252, 252);
-		if ((index.column() == 2 && triplet.reservedMode()) || (index.column() == 3 && triplet.reservedData()))
-			return QColor(35, 38, 39);
-		if (index.column() <= 1 && triplet.activePosition1p5Differs())
-			return QColor(35, 38, 39);
-	}
-
-	if (role == Qt::BackgroundRole) {
-		if (triplet.error() != X26Triplet::NoError && index.column() == m_tripletErrors[triplet.error()].columnHighlight)
-			return QColor(218, 68, 63);
-		if ((index.column() == 2 && triplet.reservedMode()) || (index.column() == 3 && triplet.reservedData()))
-			return QColor(246, 116, 0);
-		if (index.column() <= 1 && triplet.activePosition1p5Differs())
-			return QColor(246, 116, 0);
-	}
-
-	if (role == Qt::ToolTipRole) {
-		if (triplet.error() != X26Triplet::NoError)
-			return m_tripletErrors[triplet.error()].message;
-		if (triplet.activePosition1p5Differs())
-			return "Active Position differs between Level 1.5 and higher levels";
-	}
-
-	if (role == Qt::DisplayRole || role == Qt::EditRole)
-		switch (index.column()) {
-			case 0:
-				// Show row number only if address part of triplet actually represents a row:
-				// Full row colour, Set Active Position and Origin Modifier
-				// For Origin Modifier address of 40 refers to same row, so show it as 0
-				if (triplet.modeExt() == 0x10) {
-					if (triplet.address() == 40)
-						return "+0";
-					else
-						return QString("+%1").arg(triplet.addressRow());
-				}
-				if (triplet.modeExt() == 0x01 || triplet.modeExt() == 0x04)
-					return triplet.addressRow();
-				else
-					return QVariant();
-			case 1:
-				if (triplet.isValid() && !triplet.isRowTriplet())
-					return triplet.addressColumn();
-				// For Set Active Position and Origin Modifier, data is the column
-				else if (triplet.modeExt() == 0x04)
-					return triplet.data();
-				else if (triplet.modeExt() == 0x10)
-					return QString("+%1").arg(triplet.data());
-				else
-					return QVariant();
-		}
-
-	QString result;
-
-	if (role == Qt::DisplayRole) {
-		if (index.column() == 2) {
-			if (!triplet.isValid())
-				return "Error decoding triplet";
-			return (m_modeTripletNames.modeName(triplet.modeExt()));
-		}
-		// Column 3 - describe effects of data/address triplet parameters in plain English
-		if (!triplet.isValid())
-			return QVariant();
-		switch (triplet.modeExt()) {
-			case 0x01: // Full row colour
-			case 0x07: // Address row 0
-				if ((triplet.data() & 0x60) == 0x60)
-					result = ", down to bottom";
-				else if ((triplet.data() & 0x60) == 0x00)
-					result = ", this row only";
-				// fall-through
-			case 0x00: // Full screen colour
-				if (!(result.isEmpty()) || (triplet.data() & 0x60) == 0x00) {
-					result.prepend(QString("CLUT %1:%2").arg((triplet.data() & 0x18) >> 3).arg(triplet.data() & 0x07));
-					return result;
-				}
-				break;
-			case 0x04: // Set Active Position
-			case 0x10: // Origin Modifier
-				// For Set Active Position and Origin Modifier, data is the column, so return blank
-				return QVariant();
-			case 0x11: // Invoke Active Object
-			case 0x12: // Invoke Adaptive Object
-			case 0x13: // Invoke Passive Object
-				switch (triplet.address() & 0x18) {
-					case 0x08:
-						return QString("Local: d%1 t%2").arg((triplet.data() >> 4) | ((triplet.address() & 0x01) << 3)).arg(triplet.data() & 0x0f);
-					case 0x10:
-						result = "POP";
-						break;
-					case 0x18:
-						result = "GPOP";
-						break;
-					// case 0x00: shouldn't happen since that would make a column triplet, not a row triplet
-				}
-				result.append(QString(": subpage %1 pkt %2 trplt %3 bits ").arg(triplet.data() & 0x0f).arg((triplet.address() & 0x03) + 1).arg(((triplet.data() & 0x60) >> 5) * 3 + (triplet.modeExt() & 0x03)));
-				if (triplet.data() & 0x10)
-					result.append("10-18");
-				else
-					result.append("1-9");
-				return result;
-			case 0x15: // Define Active Object
-			case 0x16: // Define Adaptive Object
-			case 0x17: // Define Passive Object
-				switch (triplet.address() & 0x18) {
-					case 0x08:
-						return "Local: L2.5 only";
-						break;
-					case 0x10:
-						return "Local: L3.5 only";
-						break;
-					case 0x18:
-						return "Local: L2.5 and 3.5";
-						break;
-					// case 0x00: shouldn't happen since that would make a column triplet, not a row triplet
-				}
-				break;
-			case 0x18: // DRCS mode
-				result = (triplet.data() & 0x40) == 0x40 ? "Normal" : "Global";
-				result.append(QString(": subtable %1, ").arg(triplet.data() & 0x0f));
-				switch (triplet.data() & 0x30) {
-					case 0x10:
-						result.append("L2.5 only");
-						break;
-					case 0x20:
-						result.append("L3.5 only");
-						break;
-					case 0x30:
-						result.append("L2.5 and 3.5");
-						break;
-					case 0x00:
-						result.append("Reserved");
-						break;
-				}
-				return result;
-			case 0x1f: // Termination
-				switch (triplet.data() & 0x07) {
-					case 0x00:
-						return "Intermed (G)POP subpage. End of object, more follows";
-						break;
-					case 0x01:
-						return "Intermed (G)POP subpage. End of last object on page";
-						break;
-					case 0x02:
-						return "Last (G)POP subpage. End of object, more follows";
-						break;
-					case 0x03:
-						return "Last (G)POP subpage. End of last object on page";
-						break;
-					case 0x04:
-						return "Local object definitions. End of object, more follows";
-						break;
-					case 0x05:
-						return "Local object definitions. End of last object on page";
-						break;
-					case 0x06:
-						return "End of local enhance data. Local objects follow";
-						break;
-					case 0x07:
-						return "End of local enhance data. No local objects";
-						break;
-				}
-				break;
-			case 0x08: // PDC country of origin & programme source
-			case 0x09: // PDC month & day
-			case 0x0a: // PDC cursor row & announced start hour
-			case 0x0b: // PDC cursor row & announced finish hour
-			case 0x0c: // PDC cursor row & local time offset
-			case 0x0d: // PDC series ID & series code
-				return QString("0x%1").arg(triplet.data(), 2, 16, QChar('0'));
-			case 0x20: // Foreground colour
-			case 0x23: // Background colour
-				if (!(triplet.data() & 0x60))
-					return QString("CLUT %1:%2").arg((triplet.data() & 0x18) >> 3).arg(triplet.data() & 0x07);
-				break;
-			case 0x21: // G1 mosaic character
-			case 0x22: // G3 mosaic character at level 1.5
-			case 0x29: // G0 character
-			case 0x2b: // G3 mosaic character at level >=2.5
-			case 0x2f: // G2 character
-				if (triplet.data() >= 0x20)
-					return QString("0x%1").arg(triplet.data(), 2, 16);
-				break;
-			case 0x27: // Flash functions
-				if (triplet.data() < 0x18) {
-					switch (triplet.data() & 0x03) {
-						case 0x00:
-							result = "Steady";
-							break;
-						case 0x01:
-							result = "Normal";
-							break;
-						case 0x02:
-							result = "Invert";
-							break;
-						case 0x03:
-							result = "Adj CLUT";
-							break;
-					}
-					switch (triplet.data() & 0x1c) {
-						case 0x00:
-							result.append(", 1Hz");
-							break;
-						case 0x04:
-							result.append(", 2Hz ph 1");
-							break;
-						case 0x08:
-							result.append(", 2Hz ph 2");
-							break;
-						case 0x0c:
-							result.append(", 2Hz ph 3");
-							break;
-						case 0x10:
-							result.append(", 2Hz inc");
-							break;
-						case 0x14:
-							result.append(", 2Hz dec");
-							break;
-					}
-					return result;
-				}
-				break;
-			case 0x28: // Modified G0 and G2 character set
-				switch (triplet.data()) {
-					case 0x20:
-						return QString("0x20 Cyrillic 1 Serbian/Croatian");
-					case 0x24:
-						return QString("0x24 Cyrillic 2 Russian/Bulgarian");
-					case 0x25:
-						return QString("0x25 Cyrillic 3 Ukranian");
-					case 0x36:
-						return QString("0x36 Latin");
-					case 0x37:
-						return QString("0x37 Greek");
-					case 0x40:
-					case 0x44:
-						return QString("0x%1 G0 Latin, G2 Arabic").arg(triplet.data(), 2, 16);
-					case 0x47:
-					case 0x57:
-						return QString("0x%1 Arabic").arg(triplet.data(), 2, 16);
-					case 0x55:
-						return QString("0x55 G0 Hebrew, G2 Arabic");
-				}
-				if (triplet.data() < 0x27)
-					return QString("0x%1 Latin").arg(triplet.data(), 2, 16, QChar('0'));
-				break;
-			case 0x2c: // Display attributes
-				if (triplet.data() & 0x02)
-					result.append("Boxing ");
-				if (triplet.data() & 0x04)
-					result.append("Conceal ");
-				if (triplet.data() & 0x10)
-					result.append("Invert ");
-				if (triplet.data() & 0x20)
-					result.append("Underline ");
-				if (result.isEmpty())
-					result = "None";
-				else
-					// Chop off the last space
-					result.chop(1);
-				switch (triplet.data() & 0x41) {
-					case 0x00:
-						result.append(", normal size");
-						break;
-					case 0x01:
-						result.append(", double height");
-						break;
-					case 0x40:
-						result.append(", double width");
-						break;
-					case 0x41:
-						result.append(", double size");
-						break;
-				}
-				return result;
-			case 0x2d: // DRCS character
-				result = (triplet.data() & 0x40) == 0x40 ? "Normal" : "Global";
-				result.append(QString(": %1").arg(triplet.data() & 0x3f));
-				return result;
-			case 0x2e: // Font style
-				if (triplet.data() & 0x01)
-					result.append("Proportional ");
-				if (triplet.data() & 0x02)
-					result.append("Bold ");
-				if (triplet.data() & 0x04)
-					result.append("Italic ");
-				if (result.isEmpty())
-					result = "None";
-				else
-					// Chop off the last space
-					result.chop(1);
-				result.append(QString(", %1 row(s)").arg(triplet.data() >> 4));
-				return result;
-			case 0x26: // PDC
-				return QString("0x%1").arg(triplet.data(), 2, 16, QChar('0'));
-			default:
-				if (triplet.modeExt() >= 0x30 && triplet.modeExt() <= 0x3f && triplet.data() >= 0x20)
-					// G0 with diacritical
-					return QString("0x%1").arg(triplet.data(), 2, 16);
-				else
-					// Reserved
-					return QString("Reserved 0x%1").arg(triplet.data(), 2, 16, QChar('0'));
-		}
-		// Reserved mode or data
-		return QString("Reserved 0x%1").arg(triplet.data(), 2, 16, QChar('0'));
+	switch (role) {
+		case Qt::DisplayRole:
+			return cachedRow(index.row()).display[index.column()];
+		case Qt::EditRole:
+			if (index.column() <= 1)
+				return cachedRow(index.row()).display[index.column()];
+			break;
+		case Qt::ForegroundRole:
+			return cachedRow(index.row()).foreground[index.column()];
+		case Qt::BackgroundRole:
+			return cachedRow(index.row()).background[index.column()];
+		case Qt::ToolTipRole:
+			return cachedRow(index.row()).toolTip;
 	}
 
 	if (role == Qt::DecorationRole && index.column() == 3)
@@ -561,6 +271,331 @@ QVariant X26Model::data(const QModelIndex &index, int role) const
 	return QVariant();
 }
 
+const X26Model::rowCache &X26Model::cachedRow(int row) const
+{
+	const X26TripletList *enhancements = m_parentMainWidget->document()->currentSubPage()->enhancements();
+
+	// Any change to the list can change the errors shown on other triplets,
+	// so the whole cache goes when the list changes
+	if (enhancements != m_cachedList || enhancements->generation() != m_cachedGeneration) {
+		m_rowCache.clear();
+		m_rowCache.resize(enhancements->size());
+		m_cachedList = enhancements;
+		m_cachedGeneration = enhancements->generation();
+	}
+
+	rowCache &cache = m_rowCache[row];
+
+	if (cache.cached)
+		return cache;
+
+	const X26Triplet &triplet = enhancements->at(row);
+
+	// Error colours from KDE Plasma Breeze (light) theme
+	for (int column=0; column<4; column++) {
+		if (triplet.error() != X26Triplet::NoError && column == m_tripletErrors[triplet.error()].columnHighlight) {
+			cache.foreground[column] = QColor(252, 252, 252);
+			cache.background[column] = QColor(218, 68, 63);
+		} else if ((column == 2 && triplet.reservedMode()) || (column == 3 && triplet.reservedData()) || (column <= 1 && triplet.activePosition1p5Differs())) {
+			cache.foreground[column] = QColor(35, 38, 39);
+			cache.background[column] = QColor(246, 116, 0);
+		}
+
+		cache.display[column] = displayData(triplet, column);
+	}
+
+	if (triplet.error() != X26Triplet::NoError)
+		cache.toolTip = m_tripletErrors[triplet.error()].message;
+	else if (triplet.activePosition1p5Differs())
+		cache.toolTip = "Active Position differs between Level 1.5 and higher levels";
+
+	cache.cached = true;
+	return cache;
+}
+
+QVariant X26Model::displayData(const X26Triplet &triplet, int column) const
+{
+	switch (column) {
+		case 0:
+			// Show row number only if address part of triplet actually represents a row:
+			// Full row colour, Set Active Position and Origin Modifier
+			// For Origin Modifier address of 40 refers to same row, so show it as 0
+			if (triplet.modeExt() == 0x10) {
+				if (triplet.address() == 40)
+					return "+0";
+				else
+					return QString("+%1").arg(triplet.addressRow());
+			}
+			if (triplet.modeExt() == 0x01 || triplet.modeExt() == 0x04)
+				return triplet.addressRow();
+			else
+				return QVariant();
+		case 1:
+			if (triplet.isValid() && !triplet.isRowTriplet())
+				return triplet.addressColumn();
+			// For Set Active Position and Origin Modifier, data is the column
+			else if (triplet.modeExt() == 0x04)
+				return triplet.data();
+			else if (triplet.modeExt() == 0x10)
+				return QString("+%1").arg(triplet.data());
+			else
+				return QVariant();
+	}
+
+	QString result;
+
+	if (column == 2) {
+		if (!triplet.isValid())
+			return "Error decoding triplet";
+		return (m_modeTripletNames.modeName(triplet.modeExt()));
+	}
+	// Column 3 - describe effects of data/address triplet parameters in plain English
+	if (!triplet.isValid())
+		return QVariant();
+	switch (triplet.modeExt()) {
+		case 0x01: // Full row colour
+		case 0x07: // Address row 0
+			if ((triplet.data() & 0x60) == 0x60)
+				result = ", down to bottom";
+			else if ((triplet.data() & 0x60) == 0x00)
+				result = ", this row only";
+			// fall-through
+		case 0x00: // Full screen colour
+			if (!(result.isEmpty()) || (triplet.data() & 0x60) == 0x00) {
+				result.prepend(QString("CLUT %1:%2").arg((triplet.data() & 0x18) >> 3).arg(triplet.data() & 0x07));
+				return result;
+			}
+			break;
+		case 0x04: // Set Active Position
+		case 0x10: // Origin Modifier
+			// For Set Active Position and Origin Modifier, data is the column, so return blank
+			return QVariant();
+		case 0x11: // Invoke Active Object
+		case 0x12: // Invoke Adaptive Object
+		case 0x13: // Invoke Passive Object
+			switch (triplet.address() & 0x18) {
+				case 0x08:
+					return QString("Local: d%1 t%2").arg((triplet.data() >> 4) | ((triplet.address() & 0x01) << 3)).arg(triplet.data() & 0x0f);
+				case 0x10:
+					result = "POP";
+					break;
+				case 0x18:
+					result = "GPOP";
+					break;
+				// case 0x00: shouldn't happen since that would make a column triplet, not a row triplet
+			}
+			result.append(QString(": subpage %1 pkt %2 trplt %3 bits ").arg(triplet.data() & 0x0f).arg((triplet.address() & 0x03) + 1).arg(((triplet.data() & 0x60) >> 5) * 3 + (triplet.modeExt() & 0x03)));
+			if (triplet.data() & 0x10)
+				result.append("10-18");
+			else
+				result.append("1-9");
+			return result;
+		case 0x15: // Define Active Object
+		case 0x16: // Define Adaptive Object
+		case 0x17: // Define Passive Object
+			switch (triplet.address() & 0x18) {
+				case 0x08:
+					return "Local: L2.5 only";
+					break;
+				case 0x10:
+					return "Local: L3.5 only";
+					break;
+				case 0x18:
+					return "Local: L2.5 and 3.5";
+					break;
+				// case 0x00: shouldn't happen since that would make a column triplet, not a row triplet
+			}
+			break;
+		case 0x18: // DRCS mode
+			result = (triplet.data() & 0x40) == 0x40 ? "Normal" : "Global";
+			result.append(QString(": subtable %1, ").arg(triplet.data() & 0x0f));
+			switch (triplet.data() & 0x30) {
+				case 0x10:
+					result.append("L2.5 only");
+					break;
+				case 0x20:
+					result.append("L3.5 only");
+					break;
+				case 0x30:
+					result.append("L2.5 and 3.5");
+					break;
+				case 0x00:
+					result.append("Reserved");
+					break;
+			}
+			return result;
+		case 0x1f: // Termination
+			switch (triplet.data() & 0x07) {
+				case 0x00:
+					return "Intermed (G)POP subpage. End of object, more follows";
+					break;
+				case 0x01:
+					return "Intermed (G)POP subpage. End of last object on page";
+					break;
+				case 0x02:
+					return "Last (G)POP subpage. End of object, more follows";
+					break;
+				case 0x03:
+					return "Last (G)POP subpage. End of last object on page";
+					break;
+				case 0x04:
+					return "Local object definitions. End of object, more follows";
+					break;
+				case 0x05:
+					return "Local object definitions. End of last object on page";
+					break;
+				case 0x06:
+					return "End of local enhance data. Local objects follow";
+					break;
+				case 0x07:
+					return "End of local enhance data. No local objects";
+					break;
+			}
+			break;
+		case 0x08: // PDC country of origin & programme source
+		case 0x09: // PDC month & day
+		case 0x0a: // PDC cursor row & announced start hour
+		case 0x0b: // PDC cursor row & announced finish hour
+		case 0x0c: // PDC cursor row & local time offset
+		case 0x0d: // PDC series ID & series code
+			return QString("0x%1").arg(triplet.data(), 2, 16, QChar('0'));
+		case 0x20: // Foreground colour
+		case 0x23: // Background colour
+			if (!(triplet.data() & 0x60))
+				return QString("CLUT %1:%2").arg((triplet.data() & 0x18) >> 3).arg(triplet.data() & 0x07);
+			break;
+		case 0x21: // G1 mosaic character
+		case 0x22: // G3 mosaic character at level 1.5
+		case 0x29: // G0 character
+		case 0x2b: // G3 mosaic character at level >=2.5
+		case 0x2f: // G2 character
+			if (triplet.data() >= 0x20)
+				return QString("0x%1").arg(triplet.data(), 2, 16);
+			break;
+		case 0x27: // Flash functions
+			if (triplet.data() < 0x18) {
+				switch (triplet.data() & 0x03) {
+					case 0x00:
+						result = "Steady";
+						break;
+					case 0x01:
+						result = "Normal";
+						break;
+					case 0x02:
+						result = "Invert";
+						break;
+					case 0x03:
+						result = "Adj CLUT";
+						break;
+				}
+				switch (triplet.data() & 0x1c) {
+					case 0x00:
+						result.append(", 1Hz");
+						break;
+					case 0x04:
+						result.append(", 2Hz ph 1");
+						break;
+					case 0x08:
+						result.append(", 2Hz ph 2");
+						break;
+					case 0x0c:
+						result.append(", 2Hz ph 3");
+						break;
+					case 0x10:
+						result.append(", 2Hz inc");
+						break;
+					case 0x14:
+						result.append(", 2Hz dec");
+						break;
+				}
+				return result;
+			}
+			break;
+		case 0x28: // Modified G0 and G2 character set
+			switch (triplet.data()) {
+				case 0x20:
+					return QString("0x20 Cyrillic 1 Serbian/Croatian");
+				case 0x24:
+					return QString("0x24 Cyrillic 2 Russian/Bulgarian");
+				case 0x25:
+					return QString("0x25 Cyrillic 3 Ukranian");
+				case 0x36:
+					return QString("0x36 Latin");
+				case 0x37:
+					return QString("0x37 Greek");
+				case 0x40:
+				case 0x44:
+					return QString("0x%1 G0 Latin, G2 Arabic").arg(triplet.data(), 2, 16);
+				case 0x47:
+				case 0x57:
+					return QString("0x%1 Arabic").arg(triplet.data(), 2, 16);
+				case 0x55:
+					return QString("0x55 G0 Hebrew, G2 Arabic");
+			}
+			if (triplet.data() < 0x27)
+				return QString("0x%1 Latin").arg(triplet.data(), 2, 16, QChar('0'));
+			break;
+		case 0x2c: // Display attributes
+			if (triplet.data() & 0x02)
+				result.append("Boxing ");
+			if (triplet.data() & 0x04)
+				result.append("Conceal ");
+			if (triplet.data() & 0x10)
+				result.append("Invert ");
+			if (triplet.data() & 0x20)
+				result.append("Underline ");
+			if (result.isEmpty())
+				result = "None";
+			else
+				// Chop off the last space
+				result.chop(1);
+			switch (triplet.data() & 0x41) {
+				case 0x00:
+					result.append(", normal size");
+					break;
+				case 0x01:
+					result.append(", double height");
+					break;
+				case 0x40:
+					result.append(", double width");
+					break;
+				case 0x41:
+					result.append(", double size");
+					break;
+			}
+			return result;
+		case 0x2d: // DRCS character
+			result = (triplet.data() & 0x40) == 0x40 ? "Normal" : "Global";
+			result.append(QString(": %1").arg(triplet.data() & 0x3f));
+			return result;
+		case 0x2e: // Font style
+			if (triplet.data() & 0x01)
+				result.append("Proportional ");
+			if (triplet.data() & 0x02)
+				result.append("Bold ");
+			if (triplet.data() & 0x04)
+				result.append("Italic ");
+			if (result.isEmpty())
+				result = "None";
+			else
+				// Chop off the last space
+				result.chop(1);
+			result.append(QString(", %1 row(s)").arg(triplet.data() >> 4));
+			return result;
+		case 0x26: // PDC
+			return QString("0x%1").arg(triplet.data(), 2, 16, QChar('0'));
+		default:
+			if (triplet.modeExt() >= 0x30 && triplet.modeExt() <= 0x3f && triplet.data() >= 0x20)
+				// G0 with diacritical
+				return QString("0x%1").arg(triplet.data(), 2, 16);
+			else
+				// Reserved
+				return QString("Reserved 0x%1").arg(triplet.data(), 2, 16, QChar('0'));
+	}
+	// Reserved mode or data
+	return QString("Reserved 0x%1").arg(triplet.data(), 2, 16, QChar('0'));
+}
+
 bool X26Model::setData(const QModelIndex &index, const QVariant &value, int role)
 {
 	if (!index.isValid())
@@ -21,6 +21,8 @@
 #define X26MODEL_H
 
 #include <QAbstractListModel>
+#include <QList>
+#include <QVariant>
 
 #include "mainwidget.h"
 #include "x26menus.h"
@@ -49,11 +51,27 @@ public:
 	friend class EditTripletCommand;
 
 private:
+	// What the view asks for over and over as it repaints, worked out once for each triplet
+	struct rowCache {
+		bool cached = false;
+		QVariant display[4];
+		QVariant foreground[4], background[4];
+		QVariant toolTip;
+	};
+
+	const rowCache &cachedRow(int row) const;
+	QVariant displayData(const X26Triplet &triplet, int column) const;
+
 	TeletextWidget *m_parentMainWidget;
 	bool m_listLoaded;
 	TeletextFontBitmap m_fontBitmap;
 	ModeTripletNames m_modeTripletNames;
 
+	mutable QList<rowCache> m_rowCache;
+	// The cache is thrown away when the subpage's triplet list changes
+	mutable const X26TripletList *m_cachedList;
+	mutable quint64 m_cachedGeneration;
+
 	struct tripletErrorShow {
 		QString message;
 		int columnHighlight;
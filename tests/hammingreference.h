@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HAMMINGREFERENCE_H
+#define HAMMINGREFERENCE_H
+
+// The hand written tables that the Hamming and parity codecs were built on before they were
+// generated at compile time, kept here so the generated ones can be checked against them.
+
+namespace HammingReference {
+
+// Hamming 8/4 encoding table
+// encoded_value = hamming_8_4_encode[value_to_encode]
+const unsigned char hamming_8_4_encode[16] = {
+	0x15, 0x02, 0x49, 0x5e, 0x64, 0x73, 0x38, 0x2f,
+	0xd0, 0xc7, 0x8c, 0x9b, 0xa1, 0xb6, 0xfd, 0xea
+};
+
+// Hamming 8/4 decoding table
+// decoded_value = hamming_8_4_decode[encoded_value]
+// 0xff - double bit error that can't be corrected
+const unsigned char hamming_8_4_decode[256] = {
+	0x01, 0xff, 0x01, 0x01, 0xff, 0x00, 0x01, 0xff,
+	0xff, 0x02, 0x01, 0xff, 0x0a, 0xff, 0xff, 0x07,
+	0xff, 0x00, 0x01, 0xff, 0x00, 0x00, 0xff, 0x00,
+	0x06, 0xff, 0xff, 0x0b, 0xff, 0x00, 0x03, 0xff,
+	0xff, 0x0c, 0x01, 0xff, 0x04, 0xff, 0xff, 0x07,
+	0x06, 0xff, 0xff, 0x07, 0xff, 0x07, 0x07, 0x07,
+	0x06, 0xff, 0xff, 0x05, 0xff, 0x00, 0x0d, 0xff,
+	0x06, 0x06, 0x06, 0xff, 0x06, 0xff, 0xff, 0x07,
+	0xff, 0x02, 0x01, 0xff, 0x04, 0xff, 0xff, 0x09,
+	0x02, 0x02, 0xff, 0x02, 0xff, 0x02, 0x03, 0xff,
+	0x08, 0xff, 0xff, 0x05, 0xff, 0x00, 0x03, 0xff,
+	0xff, 0x02, 0x03, 0xff, 0x03, 0xff, 0x03, 0x03,
+	0x04, 0xff, 0xff, 0x05, 0x04, 0x04, 0x04, 0xff,
+	0xff, 0x02, 0x0f, 0xff, 0x04, 0xff, 0xff, 0x07,
+	0xff, 0x05, 0x05, 0x05, 0x04, 0xff, 0xff, 0x05,
+	0x06, 0xff, 0xff, 0x05, 0xff, 0x0e, 0x03, 0xff,
+	0xff, 0x0c, 0x01, 0xff, 0x0a, 0xff, 0xff, 0x09,
+	0x0a, 0xff, 0xff, 0x0b, 0x0a, 0x0a, 0x0a, 0xff,
+	0x08, 0xff, 0xff, 0x0b, 0xff, 0x00, 0x0d, 0xff,
+	0xff, 0x0b, 0x0b, 0x0b, 0x0a, 0xff, 0xff, 0x0b,
+	0x0c, 0x0c, 0xff, 0x0c, 0xff, 0x0c, 0x0d, 0xff,
+	0xff, 0x0c, 0x0f, 0xff, 0x0a, 0xff, 0xff, 0x07,
+	0xff, 0x0c, 0x0d, 0xff, 0x0d, 0xff, 0x0d, 0x0d,
+	0x06, 0xff, 0xff, 0x0b, 0xff, 0x0e, 0x0d, 0xff,
+	0x08, 0xff, 0xff, 0x09, 0xff, 0x09, 0x09, 0x09,
+	0xff, 0x02, 0x0f, 0xff, 0x0a, 0xff, 0xff, 0x09,
+	0x08, 0x08, 0x08, 0xff, 0x08, 0xff, 0xff, 0x09,
+	0x08, 0xff, 0xff, 0x0b, 0xff, 0x0e, 0x03, 0xff,
+	0xff, 0x0c, 0x0f, 0xff, 0x04, 0xff, 0xff, 0x09,
+	0x0f, 0xff, 0x0f, 0x0f, 0xff, 0x0e, 0x0f, 0xff,
+	0x08, 0xff, 0xff, 0x05, 0xff, 0x0e, 0x0d, 0xff,
+	0xff, 0x0e, 0x0f, 0xff, 0x0e, 0x0e, 0xff, 0x0e
+};
+
+const unsigned char hamming_24_18_forward[2][256] = {
+	{
+		0x8b, 0x8c, 0x92, 0x95, 0xa1, 0xa6, 0xb8, 0xbf,
+		0xc0, 0xc7, 0xd9, 0xde, 0xea, 0xed, 0xf3, 0xf4,
+		0x0a, 0x0d, 0x13, 0x14, 0x20, 0x27, 0x39, 0x3e,
+		0x41, 0x46, 0x58, 0x5f, 0x6b, 0x6c, 0x72, 0x75,
+		0x09, 0x0e, 0x10, 0x17, 0x23, 0x24, 0x3a, 0x3d,
+		0x42, 0x45, 0x5b, 0x5c, 0x68, 0x6f, 0x71, 0x76,
+		0x88, 0x8f, 0x91, 0x96, 0xa2, 0xa5, 0xbb, 0xbc,
+		0xc3, 0xc4, 0xda, 0xdd, 0xe9, 0xee, 0xf0, 0xf7,
+		0x08, 0x0f, 0x11, 0x16, 0x22, 0x25, 0x3b, 0x3c,
+		0x43, 0x44, 0x5a, 0x5d, 0x69, 0x6e, 0x70, 0x77,
+		0x89, 0x8e, 0x90, 0x97, 0xa3, 0xa4, 0xba, 0xbd,
+		0xc2, 0xc5, 0xdb, 0xdc, 0xe8, 0xef, 0xf1, 0xf6,
+		0x8a, 0x8d, 0x93, 0x94, 0xa0, 0xa7, 0xb9, 0xbe,
+		0xc1, 0xc6, 0xd8, 0xdf, 0xeb, 0xec, 0xf2, 0xf5,
+		0x0b, 0x0c, 0x12, 0x15, 0x21, 0x26, 0x38, 0x3f,
+		0x40, 0x47, 0x59, 0x5e, 0x6a, 0x6d, 0x73, 0x74,
+		0x03, 0x04, 0x1a, 0x1d, 0x29, 0x2e, 0x30, 0x37,
+		0x48, 0x4f, 0x51, 0x56, 0x62, 0x65, 0x7b, 0x7c,
+		0x82, 0x85, 0x9b, 0x9c, 0xa8, 0xaf, 0xb1, 0xb6,
+		0xc9, 0xce, 0xd0, 0xd7, 0xe3, 0xe4, 0xfa, 0xfd,
+		0x81, 0x86, 0x98, 0x9f, 0xab, 0xac, 0xb2, 0xb5,
+		0xca, 0xcd, 0xd3, 0xd4, 0xe0, 0xe7, 0xf9, 0xfe,
+		0x00, 0x07, 0x19, 0x1e, 0x2a, 0x2d, 0x33, 0x34,
+		0x4b, 0x4c, 0x52, 0x55, 0x61, 0x66, 0x78, 0x7f,
+		0x80, 0x87, 0x99, 0x9e, 0xaa, 0xad, 0xb3, 0xb4,
+		0xcb, 0xcc, 0xd2, 0xd5, 0xe1, 0xe6, 0xf8, 0xff,
+		0x01, 0x06, 0x18, 0x1f, 0x2b, 0x2c, 0x32, 0x35,
+		0x4a, 0x4d, 0x53, 0x54, 0x60, 0x67, 0x79, 0x7e,
+		0x02, 0x05, 0x1b, 0x1c, 0x28, 0x2f, 0x31, 0x36,
+		0x49, 0x4e, 0x50, 0x57, 0x63, 0x64, 0x7a, 0x7d,
+		0x83, 0x84, 0x9a, 0x9d, 0xa9, 0xae, 0xb0, 0xb7,
+		0xc8, 0xcf, 0xd1, 0xd6, 0xe2, 0xe5, 0xfb, 0xfc
+	},
+	{
+		0x00, 0x89, 0x8a, 0x03, 0x8b, 0x02, 0x01, 0x88,
+		0x01, 0x88, 0x8b, 0x02, 0x8a, 0x03, 0x00, 0x89,
+		0x02, 0x8b, 0x88, 0x01, 0x89, 0x00, 0x03, 0x8a,
+		0x03, 0x8a, 0x89, 0x00, 0x88, 0x01, 0x02, 0x8b,
+		0x03, 0x8a, 0x89, 0x00, 0x88, 0x01, 0x02, 0x8b,
+		0x02, 0x8b, 0x88, 0x01, 0x89, 0x00, 0x03, 0x8a,
+		0x01, 0x88, 0x8b, 0x02, 0x8a, 0x03, 0x00, 0x89,
+		0x00, 0x89, 0x8a, 0x03, 0x8b, 0x02, 0x01, 0x88,
+		0x08, 0x81, 0x82, 0x0b, 0x83, 0x0a, 0x09, 0x80,
+		0x09, 0x80, 0x83, 0x0a, 0x82, 0x0b, 0x08, 0x81,
+		0x0a, 0x83, 0x80, 0x09, 0x81, 0x08, 0x0b, 0x82,
+		0x0b, 0x82, 0x81, 0x08, 0x80, 0x09, 0x0a, 0x83,
+		0x0b, 0x82, 0x81, 0x08, 0x80, 0x09, 0x0a, 0x83,
+		0x0a, 0x83, 0x80, 0x09, 0x81, 0x08, 0x0b, 0x82,
+		0x09, 0x80, 0x83, 0x0a, 0x82, 0x0b, 0x08, 0x81,
+		0x08, 0x81, 0x82, 0x0b, 0x83, 0x0a, 0x09, 0x80,
+		0x09, 0x80, 0x83, 0x0a, 0x82, 0x0b, 0x08, 0x81,
+		0x08, 0x81, 0x82, 0x0b, 0x83, 0x0a, 0x09, 0x80,
+		0x0b, 0x82, 0x81, 0x08, 0x80, 0x09, 0x0a, 0x83,
+		0x0a, 0x83, 0x80, 0x09, 0x81, 0x08, 0x0b, 0x82,
+		0x0a, 0x83, 0x80, 0x09, 0x81, 0x08, 0x0b, 0x82,
+		0x0b, 0x82, 0x81, 0x08, 0x80, 0x09, 0x0a, 0x83,
+		0x08, 0x81, 0x82, 0x0b, 0x83, 0x0a, 0x09, 0x80,
+		0x09, 0x80, 0x83, 0x0a, 0x82, 0x0b, 0x08, 0x81,
+		0x01, 0x88, 0x8b, 0x02, 0x8a, 0x03, 0x00, 0x89,
+		0x00, 0x89, 0x8a, 0x03, 0x8b, 0x02, 0x01, 0x88,
+		0x03, 0x8a, 0x89, 0x00, 0x88, 0x01, 0x02, 0x8b,
+		0x02, 0x8b, 0x88, 0x01, 0x89, 0x00, 0x03, 0x8a,
+		0x02, 0x8b, 0x88, 0x01, 0x89, 0x00, 0x03, 0x8a,
+		0x03, 0x8a, 0x89, 0x00, 0x88, 0x01, 0x02, 0x8b,
+		0x00, 0x89, 0x8a, 0x03, 0x8b, 0x02, 0x01, 0x88,
+		0x01, 0x88, 0x8b, 0x02, 0x8a, 0x03, 0x00, 0x89
+	}
+};
+
+const unsigned char hamming_24_18_forward_2[4] = {
+	0x00, 0x0a, 0x0b, 0x01
+};
+
+
+const unsigned char hamming_24_18_parities[3][256] = {
+	{ // Parities of first byte
+		0x00, 0x21, 0x22, 0x03, 0x23, 0x02, 0x01, 0x20, 
+		0x24, 0x05, 0x06, 0x27, 0x07, 0x26, 0x25, 0x04, 
+		0x25, 0x04, 0x07, 0x26, 0x06, 0x27, 0x24, 0x05, 
+		0x01, 0x20, 0x23, 0x02, 0x22, 0x03, 0x00, 0x21, 
+		0x26, 0x07, 0x04, 0x25, 0x05, 0x24, 0x27, 0x06, 
+		0x02, 0x23, 0x20, 0x01, 0x21, 0x00, 0x03, 0x22, 
+		0x03, 0x22, 0x21, 0x00, 0x20, 0x01, 0x02, 0x23, 
+		0x27, 0x06, 0x05, 0x24, 0x04, 0x25, 0x26, 0x07, 
+		0x27, 0x06, 0x05, 0x24, 0x04, 0x25, 0x26, 0x07, 
+		0x03, 0x22, 0x21, 0x00, 0x20, 0x01, 0x02, 0x23, 
+		0x02, 0x23, 0x20, 0x01, 0x21, 0x00, 0x03, 0x22, 
+		0x26, 0x07, 0x04, 0x25, 0x05, 0x24, 0x27, 0x06, 
+		0x01, 0x20, 0x23, 0x02, 0x22, 0x03, 0x00, 0x21, 
+		0x25, 0x04, 0x07, 0x26, 0x06, 0x27, 0x24, 0x05, 
+		0x24, 0x05, 0x06, 0x27, 0x07, 0x26, 0x25, 0x04, 
+		0x00, 0x21, 0x22, 0x03, 0x23, 0x02, 0x01, 0x20, 
+		0x28, 0x09, 0x0a, 0x2b, 0x0b, 0x2a, 0x29, 0x08, 
+		0x0c, 0x2d, 0x2e, 0x0f, 0x2f, 0x0e, 0x0d, 0x2c, 
+		0x0d, 0x2c, 0x2f, 0x0e, 0x2e, 0x0f, 0x0c, 0x2d, 
+		0x29, 0x08, 0x0b, 0x2a, 0x0a, 0x2b, 0x28, 0x09, 
+		0x0e, 0x2f, 0x2c, 0x0d, 0x2d, 0x0c, 0x0f, 0x2e, 
+		0x2a, 0x0b, 0x08, 0x29, 0x09, 0x28, 0x2b, 0x0a, 
+		0x2b, 0x0a, 0x09, 0x28, 0x08, 0x29, 0x2a, 0x0b, 
+		0x0f, 0x2e, 0x2d, 0x0c, 0x2c, 0x0d, 0x0e, 0x2f, 
+		0x0f, 0x2e, 0x2d, 0x0c, 0x2c, 0x0d, 0x0e, 0x2f, 
+		0x2b, 0x0a, 0x09, 0x28, 0x08, 0x29, 0x2a, 0x0b, 
+		0x2a, 0x0b, 0x08, 0x29, 0x09, 0x28, 0x2b, 0x0a, 
+		0x0e, 0x2f, 0x2c, 0x0d, 0x2d, 0x0c, 0x0f, 0x2e, 
+		0x29, 0x08, 0x0b, 0x2a, 0x0a, 0x2b, 0x28, 0x09, 
+		0x0d, 0x2c, 0x2f, 0x0e, 0x2e, 0x0f, 0x0c, 0x2d, 
+		0x0c, 0x2d, 0x2e, 0x0f, 0x2f, 0x0e, 0x0d, 0x2c, 
+		0x28, 0x09, 0x0a, 0x2b, 0x0b, 0x2a, 0x29, 0x08
+	},
+	{ // Parities of second byte
+		0x00, 0x29, 0x2a, 0x03, 0x2b, 0x02, 0x01, 0x28, 
+		0x2c, 0x05, 0x06, 0x2f, 0x07, 0x2e, 0x2d, 0x04, 
+		0x2d, 0x04, 0x07, 0x2e, 0x06, 0x2f, 0x2c, 0x05, 
+		0x01, 0x28, 0x2b, 0x02, 0x2a, 0x03, 0x00, 0x29, 
+		0x2e, 0x07, 0x04, 0x2d, 0x05, 0x2c, 0x2f, 0x06, 
+		0x02, 0x2b, 0x28, 0x01, 0x29, 0x00, 0x03, 0x2a, 
+		0x03, 0x2a, 0x29, 0x00, 0x28, 0x01, 0x02, 0x2b, 
+		0x2f, 0x06, 0x05, 0x2c, 0x04, 0x2d, 0x2e, 0x07, 
+		0x2f, 0x06, 0x05, 0x2c, 0x04, 0x2d, 0x2e, 0x07, 
+		0x03, 0x2a, 0x29, 0x00, 0x28, 0x01, 0x02, 0x2b, 
+		0x02, 0x2b, 0x28, 0x01, 0x29, 0x00, 0x03, 0x2a, 
+		0x2e, 0x07, 0x04, 0x2d, 0x05, 0x2c, 0x2f, 0x06, 
+		0x01, 0x28, 0x2b, 0x02, 0x2a, 0x03, 0x00, 0x29, 
+		0x2d, 0x04, 0x07, 0x2e, 0x06, 0x2f, 0x2c, 0x05, 
+		0x2c, 0x05, 0x06, 0x2f, 0x07, 0x2e, 0x2d, 0x04, 
+		0x00, 0x29, 0x2a, 0x03, 0x2b, 0x02, 0x01, 0x28, 
+		0x30, 0x19, 0x1a, 0x33, 0x1b, 0x32, 0x31, 0x18, 
+		0x1c, 0x35, 0x36, 0x1f, 0x37, 0x1e, 0x1d, 0x34, 
+		0x1d, 0x34, 0x37, 0x1e, 0x36, 0x1f, 0x1c, 0x35, 
+		0x31, 0x18, 0x1b, 0x32, 0x1a, 0x33, 0x30, 0x19, 
+		0x1e, 0x37, 0x34, 0x1d, 0x35, 0x1c, 0x1f, 0x36, 
+		0x32, 0x1b, 0x18, 0x31, 0x19, 0x30, 0x33, 0x1a, 
+		0x33, 0x1a, 0x19, 0x30, 0x18, 0x31, 0x32, 0x1b, 
+		0x1f, 0x36, 0x35, 0x1c, 0x34, 0x1d, 0x1e, 0x37, 
+		0x1f, 0x36, 0x35, 0x1c, 0x34, 0x1d, 0x1e, 0x37, 
+		0x33, 0x1a, 0x19, 0x30, 0x18, 0x31, 0x32, 0x1b, 
+		0x32, 0x1b, 0x18, 0x31, 0x19, 0x30, 0x33, 0x1a, 
+		0x1e, 0x37, 0x34, 0x1d, 0x35, 0x1c, 0x1f, 0x36, 
+		0x31, 0x18, 0x1b, 0x32, 0x1a, 0x33, 0x30, 0x19, 
+		0x1d, 0x34, 0x37, 0x1e, 0x36, 0x1f, 0x1c, 0x35, 
+		0x1c, 0x35, 0x36, 0x1f, 0x37, 0x1e, 0x1d, 0x34, 
+		0x30, 0x19, 0x1a, 0x33, 0x1b, 0x32, 0x31, 0x18
+	},
+	{ // Parities of third byte
+		0x3f, 0x0e, 0x0d, 0x3c, 0x0c, 0x3d, 0x3e, 0x0f, 
+		0x0b, 0x3a, 0x39, 0x08, 0x38, 0x09, 0x0a, 0x3b, 
+		0x0a, 0x3b, 0x38, 0x09, 0x39, 0x08, 0x0b, 0x3a, 
+		0x3e, 0x0f, 0x0c, 0x3d, 0x0d, 0x3c, 0x3f, 0x0e, 
+		0x09, 0x38, 0x3b, 0x0a, 0x3a, 0x0b, 0x08, 0x39, 
+		0x3d, 0x0c, 0x0f, 0x3e, 0x0e, 0x3f, 0x3c, 0x0d, 
+		0x3c, 0x0d, 0x0e, 0x3f, 0x0f, 0x3e, 0x3d, 0x0c, 
+		0x08, 0x39, 0x3a, 0x0b, 0x3b, 0x0a, 0x09, 0x38, 
+		0x08, 0x39, 0x3a, 0x0b, 0x3b, 0x0a, 0x09, 0x38, 
+		0x3c, 0x0d, 0x0e, 0x3f, 0x0f, 0x3e, 0x3d, 0x0c, 
+		0x3d, 0x0c, 0x0f, 0x3e, 0x0e, 0x3f, 0x3c, 0x0d, 
+		0x09, 0x38, 0x3b, 0x0a, 0x3a, 0x0b, 0x08, 0x39, 
+		0x3e, 0x0f, 0x0c, 0x3d, 0x0d, 0x3c, 0x3f, 0x0e, 
+		0x0a, 0x3b, 0x38, 0x09, 0x39, 0x08, 0x0b, 0x3a, 
+		0x0b, 0x3a, 0x39, 0x08, 0x38, 0x09, 0x0a, 0x3b, 
+		0x3f, 0x0e, 0x0d, 0x3c, 0x0c, 0x3d, 0x3e, 0x0f, 
+		0x1f, 0x2e, 0x2d, 0x1c, 0x2c, 0x1d, 0x1e, 0x2f, 
+		0x2b, 0x1a, 0x19, 0x28, 0x18, 0x29, 0x2a, 0x1b, 
+		0x2a, 0x1b, 0x18, 0x29, 0x19, 0x28, 0x2b, 0x1a, 
+		0x1e, 0x2f, 0x2c, 0x1d, 0x2d, 0x1c, 0x1f, 0x2e, 
+		0x29, 0x18, 0x1b, 0x2a, 0x1a, 0x2b, 0x28, 0x19, 
+		0x1d, 0x2c, 0x2f, 0x1e, 0x2e, 0x1f, 0x1c, 0x2d, 
+		0x1c, 0x2d, 0x2e, 0x1f, 0x2f, 0x1e, 0x1d, 0x2c, 
+		0x28, 0x19, 0x1a, 0x2b, 0x1b, 0x2a, 0x29, 0x18, 
+		0x28, 0x19, 0x1a, 0x2b, 0x1b, 0x2a, 0x29, 0x18, 
+		0x1c, 0x2d, 0x2e, 0x1f, 0x2f, 0x1e, 0x1d, 0x2c, 
+		0x1d, 0x2c, 0x2f, 0x1e, 0x2e, 0x1f, 0x1c, 0x2d, 
+		0x29, 0x18, 0x1b, 0x2a, 0x1a, 0x2b, 0x28, 0x19, 
+		0x1e, 0x2f, 0x2c, 0x1d, 0x2d, 0x1c, 0x1f, 0x2e, 
+		0x2a, 0x1b, 0x18, 0x29, 0x19, 0x28, 0x2b, 0x1a, 
+		0x2b, 0x1a, 0x19, 0x28, 0x18, 0x29, 0x2a, 0x1b, 
+		0x1f, 0x2e, 0x2d, 0x1c, 0x2c, 0x1d, 0x1e, 0x2f
+	}
+};
+
+static const unsigned char hamming_24_18_decode_d1_d4[64] = {
+	0x00, 0x01, 0x00, 0x01, 0x02, 0x03, 0x02, 0x03, 
+	0x04, 0x05, 0x04, 0x05, 0x06, 0x07, 0x06, 0x07, 
+	0x08, 0x09, 0x08, 0x09, 0x0a, 0x0b, 0x0a, 0x0b, 
+	0x0c, 0x0d, 0x0c, 0x0d, 0x0e, 0x0f, 0x0e, 0x0f, 
+	0x00, 0x01, 0x00, 0x01, 0x02, 0x03, 0x02, 0x03, 
+	0x04, 0x05, 0x04, 0x05, 0x06, 0x07, 0x06, 0x07, 
+	0x08, 0x09, 0x08, 0x09, 0x0a, 0x0b, 0x0a, 0x0b, 
+	0x0c, 0x0d, 0x0c, 0x0d, 0x0e, 0x0f, 0x0e, 0x0f
+};
+
+// Mapping from parity checks in hamming_24_18_parities to incorrect bit
+// 0x80000000 - double bit error that can't be corrected
+static const unsigned int hamming_24_18_decode_correct[64] = {
+	0x00000000, 0x80000000, 0x80000000, 0x80000000, 
+	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
+	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
+	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
+	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
+	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
+	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
+	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
+	0x00000000, 0x00000000, 0x00000000, 0x00000001, 
+	0x00000000, 0x00000002, 0x00000004, 0x00000008, 
+	0x00000000, 0x00000010, 0x00000020, 0x00000040, 
+	0x00000080, 0x00000100, 0x00000200, 0x00000400, 
+	0x00000000, 0x00000800, 0x00001000, 0x00002000, 
+	0x00004000, 0x00008000, 0x00010000, 0x00020000, 
+	0x80000000, 0x80000000, 0x80000000, 0x80000000, 
+	0x80000000, 0x80000000, 0x80000000, 0x80000000
+};
+
+inline unsigned int hamming2418Encode(unsigned int toEncode)
+{
+	const unsigned int byte0 = hamming_24_18_forward[0][toEncode & 0xff] ^ hamming_24_18_forward[1][(toEncode >> 8) & 0xff] ^ hamming_24_18_forward_2[(toEncode >> 16) & 0x03];
+	const unsigned int d5_d11 = (toEncode >> 4) & 0x7f;
+	const unsigned int d12_d18 = (toEncode >> 11) & 0x7f;
+	const unsigned int p5 = 0x80 & ~(hamming_24_18_parities[0][d12_d18] << 2);
+	const unsigned int p6 = 0x80 & ((hamming_24_18_parities[0][byte0] ^ hamming_24_18_parities[0][d5_d11]) << 2);
+
+	return byte0 | (d5_d11 | p5) << 8 | (d12_d18 | p6) << 16;
+}
+
+inline int hamming2418Decode(unsigned int codeword)
+{
+	const unsigned int byte0 = codeword & 0xff;
+	const unsigned int byte1 = (codeword >> 8) & 0xff;
+	const unsigned int byte2 = (codeword >> 16) & 0xff;
+	const unsigned int abcdef = hamming_24_18_parities[0][byte0] ^ hamming_24_18_parities[1][byte1] ^ hamming_24_18_parities[2][byte2];
+	const unsigned int result = (hamming_24_18_decode_d1_d4[byte0 >> 2] | (byte1 & 0x7f) << 4 | (byte2 & 0x7f) << 11) ^ hamming_24_18_decode_correct[abcdef];
+
+	return (result & 0x80000000) ? -1 : static_cast<int>(result & 0x3ffff);
+}
+
+}
+
+#endif
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Checks the generated Hamming and parity tables and the batch codecs exhaustively
+// against the hand written tables they replaced
+
+#include <cstdio>
+#include <vector>
+
+#include "hamming.h"
+#include "hammingreference.h"
+
+static int s_failures = 0;
+
+static void fail(const char *check, unsigned int value, unsigned int result, unsigned int expected)
+{
+	// Only the first few are worth reading if a whole table is wrong
+	if (s_failures++ < 10)
+		std::printf("%s failed for 0x%x: got 0x%x expected 0x%x\n", check, value, result, expected);
+}
+
+static unsigned char referenceOddParity(unsigned char c)
+{
+	int bits = 0;
+
+	for (int b=0; b<7; b++)
+		bits += (c >> b) & 1;
+
+	return (bits & 1) ? (c & 0x7f) : (c | 0x80);
+}
+
+static void testHamming84()
+{
+	for (int v=0; v<16; v++)
+		if (hamming84Encode(v) != HammingReference::hamming_8_4_encode[v])
+			fail("hamming84Encode", v, hamming84Encode(v), HammingReference::hamming_8_4_encode[v]);
+
+	for (int c=0; c<256; c++)
+		if (hamming84Decode(c) != HammingReference::hamming_8_4_decode[c])
+			fail("hamming84Decode", c, hamming84Decode(c), HammingReference::hamming_8_4_decode[c]);
+
+	std::vector<unsigned char> data(256);
+	int expectedErrors = 0;
+
+	for (int c=0; c<256; c++) {
+		data[c] = c;
+		expectedErrors += HammingReference::hamming_8_4_decode[c] == 0xff;
+	}
+
+	const int errors = decodeHamming84(data.data(), 256);
+
+	if (errors != expectedErrors)
+		fail("decodeHamming84 error count", 256, errors, expectedErrors);
+	for (int c=0; c<256; c++)
+		if (data[c] != HammingReference::hamming_8_4_decode[c])
+			fail("decodeHamming84", c, data[c], HammingReference::hamming_8_4_decode[c]);
+
+	for (int c=0; c<256; c++)
+		data[c] = c;
+	encodeHamming84(data.data(), 256);
+	for (int c=0; c<256; c++)
+		if (data[c] != HammingReference::hamming_8_4_encode[c & 0x0f])
+			fail("encodeHamming84", c, data[c], HammingReference::hamming_8_4_encode[c & 0x0f]);
+}
+
+static void testOddParity()
+{
+	for (int c=0; c<128; c++)
+		if (oddParity(c) != referenceOddParity(c))
+			fail("oddParity", c, oddParity(c), referenceOddParity(c));
+
+	// Every byte value at every alignment and length around the eight byte words
+	std::vector<unsigned char> source(512 + 8);
+
+	for (int i=0; i<(int)source.size(); i++)
+		source[i] = i * 157 + (i >> 8);
+
+	for (int offset=0; offset<8; offset++)
+		for (int length=0; length<=512; length++) {
+			std::vector<unsigned char> data(source);
+			int expectedErrors = 0;
+
+			for (int i=offset; i<offset+length; i++)
+				expectedErrors += referenceOddParity(source[i]) != source[i];
+
+			const int errors = decodeOddParity(data.data() + offset, length);
+
+			if (errors != expectedErrors)
+				fail("decodeOddParity error count", length, errors, expectedErrors);
+			for (int i=0; i<(int)data.size(); i++) {
+				const unsigned char expected = (i >= offset && i < offset+length) ? (source[i] & 0x7f) : source[i];
+
+				if (data[i] != expected)
+					fail("decodeOddParity", i, data[i], expected);
+			}
+
+			data = source;
+			encodeOddParity(data.data() + offset, length);
+			for (int i=0; i<(int)data.size(); i++) {
+				const unsigned char expected = (i >= offset && i < offset+length) ? referenceOddParity(source[i]) : source[i];
+
+				if (data[i] != expected)
+					fail("encodeOddParity", i, data[i], expected);
+			}
+		}
+}
+
+static void testHamming2418()
+{
+	for (unsigned int v=0; v<(1u<<18); v++)
+		if (hamming2418Encode(v) != HammingReference::hamming2418Encode(v))
+			fail("hamming2418Encode", v, hamming2418Encode(v), HammingReference::hamming2418Encode(v));
+
+	for (unsigned int c=0; c<(1u<<24); c++)
+		if (hamming2418Decode(c) != HammingReference::hamming2418Decode(c))
+			fail("hamming2418Decode", c, hamming2418Decode(c), HammingReference::hamming2418Decode(c));
+
+	// Batch encoding of every value plus an invalid triplet, then decoding them back
+	const int triplets = (1 << 18) + 1;
+	std::vector<unsigned char> data(triplets * 3);
+
+	for (int v=0; v<triplets-1; v++) {
+		data[v*3] = v & 0x3f;
+		data[v*3+1] = (v >> 6) & 0x3f;
+		data[v*3+2] = v >> 12;
+	}
+	data[(triplets-1)*3] = data[(triplets-1)*3+1] = data[(triplets-1)*3+2] = 0xff;
+
+	encodeHamming2418(data.data(), triplets);
+	for (int v=0; v<triplets-1; v++) {
+		const unsigned int codeword = data[v*3] | (data[v*3+1] << 8) | (data[v*3+2] << 16);
+
+		if (codeword != HammingReference::hamming2418Encode(v))
+			fail("encodeHamming2418", v, codeword, HammingReference::hamming2418Encode(v));
+	}
+
+	const int errors = decodeHamming2418(data.data(), triplets);
+
+	if (errors != 1)
+		fail("decodeHamming2418 error count", triplets, errors, 1);
+	for (int v=0; v<triplets-1; v++) {
+		const unsigned int value = data[v*3] | (data[v*3+1] << 6) | (data[v*3+2] << 12);
+
+		if (value != (unsigned int)v)
+			fail("decodeHamming2418", v, value, v);
+	}
+	for (int i=(triplets-1)*3; i<triplets*3; i++)
+		if (data[i] != 0xff)
+			fail("decodeHamming2418 invalid triplet", i, data[i], 0xff);
+
+	// Batch decoding of every codeword, a block at a time
+	const int blockSize = 1 << 16;
+
+	data.resize(blockSize * 3);
+	for (unsigned int block=0; block<(1u<<24); block+=blockSize) {
+		int expectedErrors = 0;
+
+		for (int t=0; t<blockSize; t++) {
+			const unsigned int codeword = block + t;
+
+			data[t*3] = codeword & 0xff;
+			data[t*3+1] = (codeword >> 8) & 0xff;
+			data[t*3+2] = codeword >> 16;
+			expectedErrors += HammingReference::hamming2418Decode(codeword) == -1;
+		}
+
+		const int blockErrors = decodeHamming2418(data.data(), blockSize);
+
+		if (blockErrors != expectedErrors)
+			fail("decodeHamming2418 block error count", block, blockErrors, expectedErrors);
+		for (int t=0; t<blockSize; t++) {
+			const int expected = HammingReference::hamming2418Decode(block + t);
+
+			if (expected == -1) {
+				const unsigned int marked = data[t*3] | (data[t*3+1] << 8) | (data[t*3+2] << 16);
+
+				if (marked != 0xffffff)
+					fail("decodeHamming2418 invalid codeword", block + t, marked, 0xffffff);
+			} else {
+				const unsigned int value = data[t*3] | (data[t*3+1] << 6) | (data[t*3+2] << 12);
+
+				if (value != (unsigned int)expected)
+					fail("decodeHamming2418 codeword", block + t, value, expected);
+			}
+		}
+	}
+}
+
+int main()
+{
+	testHamming84();
+	testOddParity();
+	testHamming2418();
+
+	if (s_failures != 0) {
+		std::printf("%d checks failed\n", s_failures);
+		return 1;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
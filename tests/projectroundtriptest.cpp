@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2020-2025 Gavin MacGregor
+ *
+ * This file is part of QTeletextMaker.
+ *
+ * QTeletextMaker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QTeletextMaker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QTeletextMaker.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Loads each TTI file under the examples directory, saves it as a project, loads the project back
+// and checks the two documents hold the same pages
+
+#include <QByteArray>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QList>
+#include <QSaveFile>
+#include <QString>
+#include <QTemporaryDir>
+#include <QVariant>
+#include <QtEndian>
+
+#include <cstdio>
+
+#include "document.h"
+#include "levelonepage.h"
+#include "loadformats.h"
+#include "pagebase.h"
+#include "projectformat.h"
+#include "saveformats.h"
+
+static int s_failures = 0;
+
+static void fail(const QString &fileName, const QString &message)
+{
+	s_failures++;
+	std::printf("%s: %s\n", qPrintable(fileName), qPrintable(message));
+}
+
+static bool loadDocument(const QString &fileName, LoadFormat &loadingFormat, TeletextDocument &document, QVariantHash *metadata = nullptr)
+{
+	QFile file(fileName);
+	QList<PageBase> subPages;
+	QVariantHash loadedMetadata;
+
+	if (!file.open(QFile::ReadOnly)) {
+		fail(fileName, "cannot open: " + file.errorString());
+		return false;
+	}
+	if (!loadingFormat.load(&file, subPages, &loadedMetadata)) {
+		fail(fileName, "cannot load: " + loadingFormat.errorString());
+		return false;
+	}
+
+	document.loadFromList(subPages);
+	document.loadMetaData(loadedMetadata);
+	if (metadata != nullptr)
+		*metadata = loadedMetadata;
+
+	return true;
+}
+
+static bool saveProject(const QString &fileName, const TeletextDocument &document)
+{
+	QSaveFile file(fileName);
+	SaveProjectFormat savingFormat;
+
+	if (!file.open(QFile::WriteOnly)) {
+		fail(fileName, "cannot open for writing: " + file.errorString());
+		return false;
+	}
+
+	savingFormat.saveAllPages(file, document);
+
+	if (!savingFormat.errorString().isEmpty() || !file.commit()) {
+		fail(fileName, "cannot save: " + savingFormat.errorString() + file.errorString());
+		return false;
+	}
+
+	return true;
+}
+
+static void compareDocuments(const QString &fileName, const TeletextDocument &original, const TeletextDocument &loaded)
+{
+	if (loaded.pageNumber() != original.pageNumber())
+		fail(fileName, QString("page number %1 became %2").arg(original.pageNumber(), 0, 16).arg(loaded.pageNumber(), 0, 16));
+	if (loaded.description() != original.description())
+		fail(fileName, "description differs");
+	if (loaded.numberOfSubPages() != original.numberOfSubPages()) {
+		fail(fileName, QString("%1 subpages became %2").arg(original.numberOfSubPages()).arg(loaded.numberOfSubPages()));
+		return;
+	}
+
+	for (int p=0; p<original.numberOfSubPages(); p++) {
+		const LevelOnePage *originalPage = original.subPage(p);
+		const LevelOnePage *loadedPage = loaded.subPage(p);
+		const QString subPageStr = QString("subpage %1 ").arg(p);
+
+		for (int b=PageBase::C4ErasePage; b<=PageBase::C14NOS; b++)
+			if (loadedPage->controlBit(b) != originalPage->controlBit(b))
+				fail(fileName, subPageStr + QString("control bit %1 differs").arg(b));
+
+		if (loadedPage->cycleValue() != originalPage->cycleValue() || loadedPage->cycleType() != originalPage->cycleType())
+			fail(fileName, subPageStr + "cycle differs");
+		if (loadedPage->defaultCharSet() != originalPage->defaultCharSet())
+			fail(fileName, subPageStr + "region differs");
+
+		for (int y=0; y<26; y++)
+			if (loadedPage->packetExists(y) != originalPage->packetExists(y) || (originalPage->packetExists(y) && loadedPage->packet(y) != originalPage->packet(y)))
+				fail(fileName, subPageStr + QString("packet X/%1 differs").arg(y));
+
+		for (int y=26; y<29; y++)
+			for (int d=0; d<16; d++)
+				if (loadedPage->packetExists(y, d) != originalPage->packetExists(y, d) || (originalPage->packetExists(y, d) && loadedPage->packet(y, d) != originalPage->packet(y, d)))
+					fail(fileName, subPageStr + QString("packet X/%1/%2 differs").arg(y).arg(d));
+	}
+}
+
+static void testRoundTrip(const QString &fileName, const QDir &outputDir)
+{
+	TeletextDocument original;
+	LoadTTIFormat loadingTTI;
+
+	if (!loadDocument(fileName, loadingTTI, original))
+		return;
+
+	const QString projectFileName = outputDir.filePath("roundtrip.tmb");
+
+	if (!saveProject(projectFileName, original))
+		return;
+
+	TeletextDocument loaded;
+	LoadProjectFormat loadingProject;
+
+	if (!loadDocument(projectFileName, loadingProject, loaded))
+		return;
+
+	compareDocuments(fileName, original, loaded);
+
+	// Saving what was loaded must give back the same file
+	const QString resavedFileName = outputDir.filePath("resaved.tmb");
+
+	if (!saveProject(resavedFileName, loaded))
+		return;
+
+	QFile projectFile(projectFileName);
+	QFile resavedFile(resavedFileName);
+
+	if (!projectFile.open(QFile::ReadOnly) || !resavedFile.open(QFile::ReadOnly) || projectFile.readAll() != resavedFile.readAll())
+		fail(fileName, "project saved again after loading differs");
+}
+
+// Cycle values outside of 1 to 99 must be dropped, as LoadTTIFormat does
+static void testCycleValueRange(const QDir &outputDir)
+{
+	const QString fileName = outputDir.filePath("cyclevalue.tmb");
+	TeletextDocument document;
+
+	if (!saveProject(fileName, document))
+		return;
+
+	QFile file(fileName);
+
+	if (!file.open(QFile::ReadOnly)) {
+		fail(fileName, "cannot open: " + file.errorString());
+		return;
+	}
+
+	QByteArray data = file.readAll();
+	file.close();
+
+	const qint64 cycleValueOffset = ProjectFormat::HeaderSize + qFromLittleEndian<quint32>(data.constData() + 16) + 3;
+
+	for (const int cycleValue : { 0, 100, 255 }) {
+		data[cycleValueOffset] = cycleValue;
+
+		QSaveFile outFile(fileName);
+
+		if (!outFile.open(QFile::WriteOnly) || outFile.write(data) != data.size() || !outFile.commit()) {
+			fail(fileName, "cannot write: " + outFile.errorString());
+			return;
+		}
+
+		TeletextDocument loaded;
+		LoadProjectFormat loadingProject;
+		QVariantHash metadata;
+
+		if (!loadDocument(fileName, loadingProject, loaded, &metadata))
+			return;
+		if (metadata.contains("cycleValue000") || metadata.contains("cycleType000"))
+			fail(fileName, QString("cycle value %1 was not dropped").arg(cycleValue));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 2) {
+		std::printf("Usage: %s examples-directory\n", argv[0]);
+		return 2;
+	}
+
+	QTemporaryDir outputDir;
+
+	if (!outputDir.isValid()) {
+		std::printf("Cannot create temporary directory: %s\n", qPrintable(outputDir.errorString()));
+		return 1;
+	}
+
+	QDirIterator it(QString::fromLocal8Bit(argv[1]), { "*.tti" }, QDir::Files, QDirIterator::Subdirectories);
+	int filesTested = 0;
+
+	while (it.hasNext()) {
+		testRoundTrip(it.next(), QDir(outputDir.path()));
+		filesTested++;
+	}
+
+	if (filesTested == 0)
+		fail(QString::fromLocal8Bit(argv[1]), "no TTI files found");
+
+	testCycleValueRange(QDir(outputDir.path()));
+
+	if (s_failures != 0) {
+		std::printf("%d checks failed\n", s_failures);
+		return 1;
+	}
+
+	std::printf("All checks passed over %d files\n", filesTested);
+	return 0;
+}